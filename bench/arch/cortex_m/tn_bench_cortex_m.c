@@ -0,0 +1,237 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Kernel microbenchmark: Cortex-M part, including minimal startup code.
+ *
+ * SysTick is used as a free-running 24-bit cycle counter (its interrupt is
+ * not enabled: the benchmark doesn't need system ticks). Output is done via
+ * ARM semihosting, so the benchmark should be run under the debugger or QEMU
+ * with `-semihosting`; when run under QEMU with `-icount shift=0`, the
+ * SysTick counts executed instructions, which gives stable numbers suitable
+ * for regression tracking.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_bench.h"
+
+
+
+/*******************************************************************************
+ *    EXTERNAL DATA
+ ******************************************************************************/
+
+//-- symbols from the linker script
+extern TN_UWord _sidata[];
+extern TN_UWord _sdata[];
+extern TN_UWord _edata[];
+extern TN_UWord _sbss[];
+extern TN_UWord _ebss[];
+extern TN_UWord _estack[];
+
+
+
+/*******************************************************************************
+ *    EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int main(void);
+
+//-- implemented in tn_arch_cortex_m.S
+void PendSV_Handler(void);
+void SVC_Handler(void);
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- SysTick registers
+#define _SYST_CSR          (*(volatile TN_UWord *)0xE000E010)
+#define _SYST_RVR          (*(volatile TN_UWord *)0xE000E014)
+#define _SYST_CVR          (*(volatile TN_UWord *)0xE000E018)
+
+#define _SYST_CSR_ENABLE      (1 << 0)
+#define _SYST_CSR_CLKSOURCE   (1 << 2)
+
+//-- Coprocessor Access Control Register
+#define _SCB_CPACR         (*(volatile TN_UWord *)0xE000ED88)
+
+//-- Semihosting operations and exit reasons
+#define _SH_SYS_WRITE0                    0x04
+#define _SH_SYS_EXIT                      0x18
+#define _SH_ADP_STOPPED_APPLICATION_EXIT  0x20026
+#define _SH_ADP_STOPPED_RUNTIME_ERROR     0x20023
+
+//-- Vector table entry
+union _Vector {
+   void (*handler)(void);
+   TN_UWord *stack_top;
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static int _semihosting_call(int op, const void *arg)
+{
+   register int r0 __asm__("r0") = op;
+   register const void *r1 __asm__("r1") = arg;
+
+   __asm__ volatile("bkpt 0xab" : "+r"(r0) : "r"(r1) : "memory");
+
+   return r0;
+}
+
+static void _default_handler(void)
+{
+   for (;;){
+      //-- unexpected exception
+   }
+}
+
+void Reset_Handler(void)
+{
+   TN_UWord *src = _sidata;
+   TN_UWord *dst;
+
+   for (dst = _sdata; dst < _edata; ){
+      *dst++ = *src++;
+   }
+
+   for (dst = _sbss; dst < _ebss; ){
+      *dst++ = 0;
+   }
+
+#if defined(__TN_ARCHFEAT_CORTEX_M_FPU__)
+   //-- enable full access to CP10 and CP11 (FPU)
+   _SCB_CPACR |= (0xf << 20);
+   __asm__ volatile("dsb; isb");
+#endif
+
+   main();
+
+   tn_bench_arch_exit(1);
+}
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+__attribute__((section(".isr_vector"), used))
+static const union _Vector _vectors[16] = {
+   { .stack_top = _estack },
+   { Reset_Handler },
+   { _default_handler },      //-- NMI
+   { _default_handler },      //-- HardFault
+   { _default_handler },      //-- MemManage
+   { _default_handler },      //-- BusFault
+   { _default_handler },      //-- UsageFault
+   { TN_NULL },
+   { TN_NULL },
+   { TN_NULL },
+   { TN_NULL },
+   { SVC_Handler },
+   { _default_handler },      //-- DebugMon
+   { TN_NULL },
+   { PendSV_Handler },
+   { _default_handler },      //-- SysTick: not used
+};
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+void tn_bench_arch_init(void)
+{
+   _SYST_RVR = 0x00FFFFFF;
+   _SYST_CVR = 0;
+   _SYST_CSR = _SYST_CSR_CLKSOURCE | _SYST_CSR_ENABLE;
+}
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+TN_BenchCycles tn_bench_arch_cycles_get(void)
+{
+   //-- SysTick counts down
+   return (~_SYST_CVR) & TN_BENCH_ARCH_CYCLES_MASK;
+}
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+void tn_bench_arch_out(const char *str)
+{
+   _semihosting_call(_SH_SYS_WRITE0, str);
+}
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+void tn_bench_arch_exit(int status)
+{
+   _semihosting_call(
+         _SH_SYS_EXIT,
+         (const void *)(status == 0
+            ? _SH_ADP_STOPPED_APPLICATION_EXIT
+            : _SH_ADP_STOPPED_RUNTIME_ERROR)
+         );
+
+   for (;;){
+      //-- should never be here
+   }
+}
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Kernel microbenchmark: POSIX host part.
+ *
+ * The cycle counter is TSC on x86, virtual counter on AArch64 (its rate is
+ * lower than CPU clock, so it is coarse), and `CLOCK_MONOTONIC` nanoseconds
+ * elsewhere. The system timer is not started at all: the benchmark doesn't
+ * need ticks, and `SIGALRM` would just add noise to the measurements.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#if !defined(_POSIX_C_SOURCE)
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "tn_bench.h"
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+void tn_bench_arch_init(void)
+{
+   //-- make sure the report isn't lost if benchmark crashes
+   setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+TN_BenchCycles tn_bench_arch_cycles_get(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+   unsigned int lo, hi;
+   __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((TN_BenchCycles)hi << 16 << 16) | lo;
+#elif defined(__aarch64__)
+   TN_BenchCycles ret;
+   __asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(ret));
+   return ret;
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (TN_BenchCycles)ts.tv_sec * 1000000000UL + ts.tv_nsec;
+#endif
+}
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+void tn_bench_arch_out(const char *str)
+{
+   fputs(str, stdout);
+}
+
+/*
+ * See comments in the header file (tn_bench.h)
+ */
+void tn_bench_arch_exit(int status)
+{
+   fflush(stdout);
+   exit(status);
+}
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
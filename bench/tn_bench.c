@@ -0,0 +1,998 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Kernel microbenchmark: measures the cost of the kernel services in cycles,
+ * with 0, 1 and N tasks waiting on the object.
+ *
+ * Each measurement is performed as follows:
+ *
+ *    - `pre()`: prepare the object (not measured);
+ *    - waiter tasks, if any, are released and the benchmark waits until all
+ *      of them are blocked on the object;
+ *    - `op()`: the service itself is called, and the time is measured;
+ *    - the benchmark waits until all the waiters, woken up by `op()`, have
+ *      completed their job and "parked" on the private semaphore;
+ *    - `post()`: restore the object state (not measured).
+ *
+ * "The benchmark waits until all other tasks are blocked" is implemented
+ * with the help of the idle task callback: it is called only when all other
+ * tasks are blocked.
+ *
+ * In the timer tests (`timer_*`, `tick*`), waiters are not woken up at all:
+ * they just sleep with a long timeout, so that there are 0, 1 or N other
+ * active timers. There is no system timer interrupt in the benchmark, so
+ * `tn_tick_int_processing()` is called right from the benchmark task.
+ *
+ * Waiters have lower priority than the benchmark task, so the measured
+ * service doesn't switch context: this is the cost of the service itself.
+ * Tests with the `_sw` suffix (and `ctx_switch`) use waiters with higher
+ * priority instead: the time is measured from the service call to the
+ * moment when the woken up waiter is running, i.e. it includes the context
+ * switch (including `_tn_sys_on_context_switch()`, if it is enabled by the
+ * configuration).
+ *
+ * The overhead of the measurement itself (empty `op()`) is measured first,
+ * and subtracted from each sample.
+ *
+ * The report is printed in the CSV format:
+ *
+ *     # tneo-bench arch=<arch> compiler=<compiler> unit=<unit> iter=<n> overhead=<n>
+ *     name,waiters,min,avg,max
+ *     sem_signal,0,<min>,<avg>,<max>
+ *     ...
+ *     # end
+ *
+ * Lines starting with `#` are comments.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_bench.h"
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/// Which waiters counts to run the test with
+enum _BenchWaitersMask {
+   _W0 = (1 << 0),   ///< no waiters
+   _W1 = (1 << 1),   ///< 1 waiter
+   _WN = (1 << 2),   ///< `#TN_BENCH_WAITERS_CNT` waiters
+};
+
+/// Test description
+struct _BenchTest {
+   ///
+   /// Name of the test (the first column of the report)
+   const char *name;
+   ///
+   /// Which waiters counts to run the test with, see `enum _BenchWaitersMask`
+   int waiters_mask;
+   ///
+   /// If `TN_TRUE`, waiters have higher priority than the benchmark task,
+   /// and the time is measured until the first of them is running.
+   TN_BOOL waiters_high;
+   ///
+   /// Create object(s)
+   void (*init)(void);
+   ///
+   /// Delete object(s)
+   void (*deinit)(void);
+   ///
+   /// Called before each sample (not measured), may be `TN_NULL`
+   void (*pre)(void);
+   ///
+   /// Measured operation
+   void (*op)(void);
+   ///
+   /// Called after each sample (not measured), may be `TN_NULL`
+   void (*post)(void);
+   ///
+   /// Operation performed by the waiter: it should block on the object
+   /// until it is woken up by `op()`, then call `_waiter_stamp()` and
+   /// undo whatever it has done to the object (if needed).
+   /// May be `TN_NULL` if `waiters_mask` is `_W0`.
+   void (*waiter)(void);
+};
+
+/// Statistics of a single measurement
+struct _BenchStat {
+   TN_BenchCycles min;
+   TN_BenchCycles max;
+   unsigned long long sum;
+   unsigned long cnt;
+};
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- Task priorities: timer task (if `#TN_TIMER_TASK` is set), high-priority
+//   waiters, benchmark task, low-priority waiters
+#define _PRIORITY_TIMER       0
+#define _PRIORITY_HIGH        1
+#define _PRIORITY_BENCH       2
+#define _PRIORITY_LOW         3
+
+//-- Size of the buffer for the report line
+#define _LINE_BUF_SIZE        128
+
+//-- Timeout of the timer under test (it never expires in `timer_*` tests,
+//   since there are no ticks), and timeout of the timers of the waiters:
+//   long enough, so that they never expire during the test
+#define _TIMER_TIMEOUT        10
+#define _TIMER_TIMEOUT_LONG   0x7fff
+
+#define _RC_CHECK(rc)         _rc_check((rc), TN_FALSE, __LINE__)
+#define _RC_CHECK_TO(rc)      _rc_check((rc), TN_TRUE, __LINE__)
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+TN_STACK_ARR_DEF(_idle_task_stack, TN_BENCH_STACK_SIZE);
+TN_STACK_ARR_DEF(_interrupt_stack, TN_BENCH_STACK_SIZE);
+TN_STACK_ARR_DEF(_bench_task_stack, TN_BENCH_STACK_SIZE);
+#if TN_TIMER_TASK
+TN_STACK_ARR_DEF(_timer_task_stack, TN_BENCH_STACK_SIZE);
+#endif
+TN_ARCH_STK_ATTR_BEFORE
+static TN_UWord _waiter_stacks[TN_BENCH_WAITERS_CNT][TN_BENCH_STACK_SIZE]
+   TN_ARCH_STK_ATTR_AFTER;
+
+static struct TN_Task _bench_task;
+static struct TN_Task _waiter_tasks[TN_BENCH_WAITERS_CNT];
+
+//-- Waiters "park" on this semaphore when they're done
+static struct TN_Sem _park_sem;
+static volatile int _parked_cnt;
+
+//-- Benchmark task waits on this semaphore for the idle task callback
+static struct TN_Sem _settle_sem;
+static volatile TN_BOOL _settle_pending = TN_FALSE;
+
+//-- Timestamp taken by the first woken up waiter
+static volatile TN_BOOL _stamp_pending = TN_FALSE;
+static volatile TN_BenchCycles _stamp_cycles;
+
+#if TN_DYNAMIC_TICK
+//-- System tick counter for `#TN_DYNAMIC_TICK`: there is no timer hardware,
+//   so it's advanced by `_tick()` only
+static volatile TN_TickCnt _tick_cnt = 0;
+#endif
+
+//-- Currently running test and the number of its waiters
+static const struct _BenchTest *_cur_test;
+static int _cur_waiters_cnt;
+
+//-- Measurement overhead, subtracted from each sample
+static TN_BenchCycles _overhead = 0;
+
+//-- Objects under test
+static struct TN_Sem _sem;
+static struct TN_DQueue _queue;
+static void *_queue_fifo[1];
+static struct TN_FMem _fmem;
+TN_FMEM_BUF_DEF(_fmem_buf, TN_UWord, 2);
+static void *_fmem_block;
+static void *_fmem_block_reserved;
+static struct TN_EventGrp _eventgrp;
+static struct TN_Mutex _mutex;
+static struct TN_Timer _timer;
+static volatile TN_BOOL _timer_fired;
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS: UTILITIES
+ ******************************************************************************/
+
+/**
+ * Append string to the buffer, returns pointer to the terminating null
+ */
+static char *_str_append(char *buf, const char *str)
+{
+   while (*str){
+      *buf++ = *str++;
+   }
+   *buf = '\0';
+   return buf;
+}
+
+/**
+ * Append decimal representation of `value` to the buffer, returns pointer to
+ * the terminating null
+ */
+static char *_uint_append(char *buf, unsigned long value)
+{
+   char tmp[24];
+   int i = 0;
+
+   do {
+      tmp[i++] = (char)('0' + (value % 10));
+      value /= 10;
+   } while (value != 0);
+
+   while (i > 0){
+      *buf++ = tmp[--i];
+   }
+   *buf = '\0';
+   return buf;
+}
+
+static void _rc_check(enum TN_RCode rc, TN_BOOL timeout_allowed, int line)
+{
+   if (rc != TN_RC_OK && !(timeout_allowed && rc == TN_RC_TIMEOUT)){
+      char buf[_LINE_BUF_SIZE];
+      char *p = buf;
+
+      p = _str_append(p, "# error: rc=");
+      p = _uint_append(p, (unsigned long)(-(int)rc));
+      p = _str_append(p, " at line ");
+      p = _uint_append(p, (unsigned long)line);
+      p = _str_append(p, "\n");
+      tn_bench_arch_out(buf);
+
+      tn_bench_arch_exit(1);
+   }
+}
+
+_TN_STATIC_INLINE TN_BenchCycles _cycles_diff(
+      TN_BenchCycles t0,
+      TN_BenchCycles t1
+      )
+{
+   return (t1 - t0) & TN_BENCH_ARCH_CYCLES_MASK;
+}
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS: WAITERS HANDLING
+ ******************************************************************************/
+
+/**
+ * Should be called by waiters right after the blocking call returns
+ */
+static void _waiter_stamp(void)
+{
+   if (_stamp_pending){
+      _stamp_cycles = tn_bench_arch_cycles_get();
+      _stamp_pending = TN_FALSE;
+   }
+}
+
+static void _waiter_task_body(void *param)
+{
+   _TN_UNUSED(param);
+
+   for (;;){
+      //-- park until the benchmark task releases us
+      _parked_cnt++;
+      _RC_CHECK(tn_sem_wait(&_park_sem, TN_WAIT_INFINITE));
+
+      //-- block on the object under test
+      _cur_test->waiter();
+   }
+}
+
+/**
+ * Wait until all other tasks are blocked
+ */
+static void _settle(void)
+{
+   _settle_pending = TN_TRUE;
+   _RC_CHECK(tn_sem_wait(&_settle_sem, TN_WAIT_INFINITE));
+}
+
+/**
+ * Release all parked waiters, and wait until they're blocked on the object
+ * under test
+ */
+static void _waiters_release(void)
+{
+   while (_parked_cnt > 0){
+      _parked_cnt--;
+      _RC_CHECK(tn_sem_signal(&_park_sem));
+   }
+   _settle();
+}
+
+static void _waiters_create(int waiters_cnt, int priority)
+{
+   int i;
+
+   _parked_cnt = 0;
+
+   for (i = 0; i < waiters_cnt; i++){
+      _RC_CHECK(tn_task_create(
+               &_waiter_tasks[i], _waiter_task_body, priority,
+               _waiter_stacks[i], TN_BENCH_STACK_SIZE,
+               TN_NULL, TN_TASK_CREATE_OPT_START
+               ));
+   }
+
+   //-- let waiters park
+   _settle();
+}
+
+static void _waiters_delete(int waiters_cnt)
+{
+   int i;
+
+   for (i = 0; i < waiters_cnt; i++){
+      _RC_CHECK(tn_task_terminate(&_waiter_tasks[i]));
+      _RC_CHECK(tn_task_delete(&_waiter_tasks[i]));
+   }
+}
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS: MEASUREMENT
+ ******************************************************************************/
+
+static void _stat_print(
+      const char *name,
+      int waiters_cnt,
+      const struct _BenchStat *stat
+      )
+{
+   char buf[_LINE_BUF_SIZE];
+   char *p = buf;
+
+   p = _str_append(p, name);
+   p = _str_append(p, ",");
+   p = _uint_append(p, (unsigned long)waiters_cnt);
+   p = _str_append(p, ",");
+   p = _uint_append(p, stat->min);
+   p = _str_append(p, ",");
+   p = _uint_append(p, (unsigned long)(stat->sum / stat->cnt));
+   p = _str_append(p, ",");
+   p = _uint_append(p, stat->max);
+   p = _str_append(p, "\n");
+
+   tn_bench_arch_out(buf);
+}
+
+/**
+ * Run the test with given number of waiters
+ */
+static void _test_run(
+      const struct _BenchTest *test,
+      int waiters_cnt,
+      struct _BenchStat *stat
+      )
+{
+   int i;
+
+   _cur_test = test;
+   _cur_waiters_cnt = waiters_cnt;
+
+   stat->min = TN_BENCH_ARCH_CYCLES_MASK;
+   stat->max = 0;
+   stat->sum = 0;
+   stat->cnt = 0;
+
+   test->init();
+
+   _waiters_create(
+         waiters_cnt,
+         test->waiters_high ? _PRIORITY_HIGH : _PRIORITY_LOW
+         );
+
+   for (i = 0; i < TN_BENCH_ITER_CNT; i++){
+      TN_BenchCycles t0, t1, sample;
+
+      if (test->pre != TN_NULL){
+         test->pre();
+      }
+
+      if (waiters_cnt > 0){
+         _waiters_release();
+      }
+
+      _stamp_pending = test->waiters_high;
+
+      t0 = tn_bench_arch_cycles_get();
+      test->op();
+      t1 = tn_bench_arch_cycles_get();
+
+      if (test->waiters_high){
+         if (_stamp_pending){
+            //-- no waiter was woken up: should never happen
+            _RC_CHECK(TN_RC_INTERNAL);
+         }
+         t1 = _stamp_cycles;
+      }
+
+      if (waiters_cnt > 0){
+         //-- let woken up waiters complete and park
+         _settle();
+      }
+
+      if (test->post != TN_NULL){
+         test->post();
+      }
+
+      sample = _cycles_diff(t0, t1);
+      sample = (sample > _overhead) ? (sample - _overhead) : 0;
+
+      if (sample < stat->min){
+         stat->min = sample;
+      }
+      if (sample > stat->max){
+         stat->max = sample;
+      }
+      stat->sum += sample;
+      stat->cnt++;
+   }
+
+   _waiters_delete(waiters_cnt);
+
+   test->deinit();
+}
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS: TESTS
+ ******************************************************************************/
+
+static void _nothing(void)
+{
+   //-- nothing: used for measurement overhead
+}
+
+//-- semaphore {{{
+
+static void _sem_init(void)
+{
+   _RC_CHECK(tn_sem_create(&_sem, 0, 1));
+}
+
+static void _sem_deinit(void)
+{
+   _RC_CHECK(tn_sem_delete(&_sem));
+}
+
+static void _sem_signal(void)
+{
+   _RC_CHECK(tn_sem_signal(&_sem));
+}
+
+static void _sem_wait(void)
+{
+   _RC_CHECK(tn_sem_wait(&_sem, TN_WAIT_INFINITE));
+}
+
+static void _sem_wait_polling(void)
+{
+   _RC_CHECK_TO(tn_sem_wait_polling(&_sem));
+}
+
+static void _sem_waiter(void)
+{
+   _RC_CHECK(tn_sem_wait(&_sem, TN_WAIT_INFINITE));
+   _waiter_stamp();
+}
+
+// }}}
+
+//-- queue {{{
+
+static void _queue_init(void)
+{
+   _RC_CHECK(tn_queue_create(&_queue, _queue_fifo, 1));
+}
+
+static void _queue_deinit(void)
+{
+   _RC_CHECK(tn_queue_delete(&_queue));
+}
+
+static void _queue_send(void)
+{
+   _RC_CHECK(tn_queue_send(&_queue, TN_NULL, TN_WAIT_INFINITE));
+}
+
+static void _queue_send_polling(void)
+{
+   //-- if there are senders waiting, the queue is already full
+   _RC_CHECK_TO(tn_queue_send_polling(&_queue, TN_NULL));
+}
+
+static void _queue_receive(void)
+{
+   void *p_data;
+   _RC_CHECK(tn_queue_receive(&_queue, &p_data, TN_WAIT_INFINITE));
+}
+
+static void _queue_receive_polling(void)
+{
+   void *p_data;
+   _RC_CHECK_TO(tn_queue_receive_polling(&_queue, &p_data));
+}
+
+static void _queue_receiver(void)
+{
+   void *p_data;
+   _RC_CHECK(tn_queue_receive(&_queue, &p_data, TN_WAIT_INFINITE));
+   _waiter_stamp();
+}
+
+static void _queue_sender(void)
+{
+   _RC_CHECK(tn_queue_send(&_queue, TN_NULL, TN_WAIT_INFINITE));
+   _waiter_stamp();
+}
+
+// }}}
+
+//-- fixed memory pool {{{
+
+static void _fmem_init(void)
+{
+   //-- pool should have at least 2 blocks, but we need just one:
+   //   the other one is reserved until the test is done
+   _RC_CHECK(tn_fmem_create(&_fmem, _fmem_buf, sizeof(TN_UWord), 2));
+   _RC_CHECK(tn_fmem_get_polling(&_fmem, &_fmem_block_reserved));
+}
+
+static void _fmem_deinit(void)
+{
+   _RC_CHECK(tn_fmem_release(&_fmem, _fmem_block_reserved));
+   _RC_CHECK(tn_fmem_delete(&_fmem));
+}
+
+static void _fmem_get(void)
+{
+   _RC_CHECK(tn_fmem_get(&_fmem, &_fmem_block, TN_WAIT_INFINITE));
+}
+
+static void _fmem_get_polling(void)
+{
+   _RC_CHECK(tn_fmem_get_polling(&_fmem, &_fmem_block));
+}
+
+static void _fmem_release(void)
+{
+   _RC_CHECK(tn_fmem_release(&_fmem, _fmem_block));
+}
+
+static void _fmem_waiter(void)
+{
+   void *p_block;
+   _RC_CHECK(tn_fmem_get(&_fmem, &p_block, TN_WAIT_INFINITE));
+   _waiter_stamp();
+   _RC_CHECK(tn_fmem_release(&_fmem, p_block));
+}
+
+// }}}
+
+//-- event group {{{
+
+static void _eventgrp_init(void)
+{
+   _RC_CHECK(tn_eventgrp_create(&_eventgrp, 0));
+}
+
+static void _eventgrp_deinit(void)
+{
+   _RC_CHECK(tn_eventgrp_delete(&_eventgrp));
+}
+
+static void _eventgrp_set(void)
+{
+   _RC_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_SET, (1 << 0)));
+}
+
+static void _eventgrp_clear(void)
+{
+   _RC_CHECK(tn_eventgrp_modify(&_eventgrp, TN_EVENTGRP_OP_CLEAR, (1 << 0)));
+}
+
+static void _eventgrp_waiter(void)
+{
+   _RC_CHECK(tn_eventgrp_wait(
+            &_eventgrp, (1 << 0), TN_EVENTGRP_WMODE_OR,
+            TN_NULL, TN_WAIT_INFINITE
+            ));
+   _waiter_stamp();
+}
+
+// }}}
+
+//-- timer {{{
+
+static void _timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   _TN_UNUSED(timer);
+   _TN_UNUSED(p_user_data);
+
+   _timer_fired = TN_TRUE;
+}
+
+static void _timer_init(void)
+{
+   _RC_CHECK(tn_timer_create(&_timer, _timer_func, TN_NULL));
+}
+
+static void _timer_deinit(void)
+{
+   _RC_CHECK(tn_timer_delete(&_timer));
+}
+
+static void _timer_start(void)
+{
+   _RC_CHECK(tn_timer_start(&_timer, _TIMER_TIMEOUT));
+}
+
+static void _timer_start_next_tick(void)
+{
+   _timer_fired = TN_FALSE;
+   _RC_CHECK(tn_timer_start(&_timer, 1));
+}
+
+static void _timer_cancel(void)
+{
+   _RC_CHECK(tn_timer_cancel(&_timer));
+}
+
+static void _timer_fired_check(void)
+{
+   if (!_timer_fired){
+      //-- timer should have expired on the tick
+      _RC_CHECK(TN_RC_INTERNAL);
+   }
+}
+
+/**
+ * System tick. It's called from the benchmark task (there is no system timer
+ * interrupt in the benchmark): it just manages timers with interrupts
+ * disabled, so that's the same work as done in the ISR.
+ */
+static void _tick(void)
+{
+#if TN_DYNAMIC_TICK
+   _tick_cnt++;
+#endif
+   tn_tick_int_processing();
+}
+
+/**
+ * Waiter which just keeps its timeout timer active for the whole test
+ */
+static void _timer_waiter(void)
+{
+   _RC_CHECK_TO(tn_task_sleep(_TIMER_TIMEOUT_LONG));
+   _waiter_stamp();
+}
+
+// }}}
+
+//-- mutex {{{
+
+#if TN_USE_MUTEXES
+
+static void _mutex_inherit_init(void)
+{
+   _RC_CHECK(tn_mutex_create(&_mutex, TN_MUTEX_PROT_INHERIT, 0));
+}
+
+static void _mutex_ceiling_init(void)
+{
+   //-- low-priority waiters which get the mutex should not preempt us
+   _RC_CHECK(tn_mutex_create(&_mutex, TN_MUTEX_PROT_CEILING, _PRIORITY_BENCH));
+}
+
+static void _mutex_ceiling_high_init(void)
+{
+   _RC_CHECK(tn_mutex_create(&_mutex, TN_MUTEX_PROT_CEILING, _PRIORITY_HIGH));
+}
+
+static void _mutex_deinit(void)
+{
+   _RC_CHECK(tn_mutex_delete(&_mutex));
+}
+
+static void _mutex_lock(void)
+{
+   _RC_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE));
+}
+
+static void _mutex_unlock(void)
+{
+   _RC_CHECK(tn_mutex_unlock(&_mutex));
+}
+
+static void _mutex_waiter(void)
+{
+   _RC_CHECK(tn_mutex_lock(&_mutex, TN_WAIT_INFINITE));
+   _waiter_stamp();
+   _RC_CHECK(tn_mutex_unlock(&_mutex));
+}
+
+#endif
+
+// }}}
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA: TESTS
+ ******************************************************************************/
+
+static const struct _BenchTest _overhead_test = {
+   "overhead", _W0, TN_FALSE,
+   _nothing, _nothing, TN_NULL, _nothing, TN_NULL, TN_NULL
+};
+
+static const struct _BenchTest _tests[] = {
+   {
+      "sem_signal", _W0 | _W1 | _WN, TN_FALSE,
+      _sem_init, _sem_deinit, TN_NULL, _sem_signal, _sem_wait_polling,
+      _sem_waiter
+   },
+   {
+      "sem_wait", _W0, TN_FALSE,
+      _sem_init, _sem_deinit, _sem_signal, _sem_wait, TN_NULL,
+      TN_NULL
+   },
+   {
+      "ctx_switch", _W1 | _WN, TN_TRUE,
+      _sem_init, _sem_deinit, TN_NULL, _sem_signal, TN_NULL,
+      _sem_waiter
+   },
+   {
+      "queue_send", _W0 | _W1 | _WN, TN_FALSE,
+      _queue_init, _queue_deinit, TN_NULL, _queue_send,
+      _queue_receive_polling, _queue_receiver
+   },
+   {
+      "queue_receive", _W0 | _W1 | _WN, TN_FALSE,
+      _queue_init, _queue_deinit, _queue_send_polling, _queue_receive,
+      TN_NULL, _queue_sender
+   },
+   {
+      "queue_send_sw", _W1 | _WN, TN_TRUE,
+      _queue_init, _queue_deinit, TN_NULL, _queue_send,
+      TN_NULL, _queue_receiver
+   },
+   {
+      "fmem_get", _W0, TN_FALSE,
+      _fmem_init, _fmem_deinit, TN_NULL, _fmem_get, _fmem_release,
+      TN_NULL
+   },
+   {
+      "fmem_release", _W0 | _W1 | _WN, TN_FALSE,
+      _fmem_init, _fmem_deinit, _fmem_get_polling, _fmem_release, TN_NULL,
+      _fmem_waiter
+   },
+   {
+      "eventgrp_modify", _W0 | _W1 | _WN, TN_FALSE,
+      _eventgrp_init, _eventgrp_deinit, TN_NULL, _eventgrp_set,
+      _eventgrp_clear, _eventgrp_waiter
+   },
+   {
+      "timer_start", _W0 | _W1 | _WN, TN_FALSE,
+      _timer_init, _timer_deinit, TN_NULL, _timer_start, _timer_cancel,
+      _timer_waiter
+   },
+   {
+      "timer_cancel", _W0 | _W1 | _WN, TN_FALSE,
+      _timer_init, _timer_deinit, _timer_start, _timer_cancel, TN_NULL,
+      _timer_waiter
+   },
+   {
+      "tick", _W0 | _W1 | _WN, TN_FALSE,
+      _timer_init, _timer_deinit, TN_NULL, _tick, TN_NULL,
+      _timer_waiter
+   },
+   {
+      "tick_expire", _W0 | _W1 | _WN, TN_FALSE,
+      _timer_init, _timer_deinit, _timer_start_next_tick, _tick,
+      _timer_fired_check, _timer_waiter
+   },
+#if TN_USE_MUTEXES
+   {
+      "mutex_lock_inherit", _W0, TN_FALSE,
+      _mutex_inherit_init, _mutex_deinit, TN_NULL, _mutex_lock,
+      _mutex_unlock, TN_NULL
+   },
+   {
+      "mutex_unlock_inherit", _W0 | _W1 | _WN, TN_FALSE,
+      _mutex_inherit_init, _mutex_deinit, _mutex_lock, _mutex_unlock,
+      TN_NULL, _mutex_waiter
+   },
+   {
+      "mutex_unlock_inherit_sw", _W1 | _WN, TN_TRUE,
+      _mutex_inherit_init, _mutex_deinit, _mutex_lock, _mutex_unlock,
+      TN_NULL, _mutex_waiter
+   },
+   {
+      "mutex_lock_ceiling", _W0, TN_FALSE,
+      _mutex_ceiling_init, _mutex_deinit, TN_NULL, _mutex_lock,
+      _mutex_unlock, TN_NULL
+   },
+   {
+      "mutex_unlock_ceiling", _W0 | _W1 | _WN, TN_FALSE,
+      _mutex_ceiling_init, _mutex_deinit, _mutex_lock, _mutex_unlock,
+      TN_NULL, _mutex_waiter
+   },
+   {
+      "mutex_unlock_ceiling_sw", _W1 | _WN, TN_TRUE,
+      _mutex_ceiling_high_init, _mutex_deinit, _mutex_lock, _mutex_unlock,
+      TN_NULL, _mutex_waiter
+   },
+#endif
+};
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS: TASKS
+ ******************************************************************************/
+
+static void _bench_task_body(void *param)
+{
+   static const int waiters_cnts[] = { 0, 1, TN_BENCH_WAITERS_CNT };
+   static const int waiters_masks[] = { _W0, _W1, _WN };
+
+   struct _BenchStat stat;
+   char buf[_LINE_BUF_SIZE];
+   char *p;
+   unsigned int i, j;
+
+   _TN_UNUSED(param);
+
+   _RC_CHECK(tn_sem_create(&_park_sem, 0, TN_BENCH_WAITERS_CNT));
+   _RC_CHECK(tn_sem_create(&_settle_sem, 0, 1));
+
+   //-- measure overhead of the measurement itself: take the minimum
+   _test_run(&_overhead_test, 0, &stat);
+   _overhead = stat.min;
+
+   p = buf;
+   p = _str_append(p, "# tneo-bench arch=" TN_BENCH_ARCH_NAME);
+   p = _str_append(p, " compiler=" TN_BENCH_COMPILER_NAME);
+   p = _str_append(p, " unit=" TN_BENCH_ARCH_CYCLES_UNIT " iter=");
+   p = _uint_append(p, TN_BENCH_ITER_CNT);
+   p = _str_append(p, " overhead=");
+   p = _uint_append(p, _overhead);
+   p = _str_append(p, "\n");
+   tn_bench_arch_out(buf);
+
+   tn_bench_arch_out("name,waiters,min,avg,max\n");
+
+   for (i = 0; i < sizeof(_tests) / sizeof(_tests[0]); i++){
+      for (j = 0; j < sizeof(waiters_cnts) / sizeof(waiters_cnts[0]); j++){
+         if (_tests[i].waiters_mask & waiters_masks[j]){
+            _test_run(&_tests[i], waiters_cnts[j], &stat);
+            _stat_print(_tests[i].name, waiters_cnts[j], &stat);
+         }
+      }
+   }
+
+   tn_bench_arch_out("# end\n");
+   tn_bench_arch_exit(0);
+}
+
+static void _init_task_create(void)
+{
+   _RC_CHECK(tn_task_create(
+            &_bench_task, _bench_task_body, _PRIORITY_BENCH,
+            _bench_task_stack, TN_BENCH_STACK_SIZE,
+            TN_NULL, TN_TASK_CREATE_OPT_START
+            ));
+}
+
+#if TN_DYNAMIC_TICK
+/**
+ * Dynamic tick: the kernel asks to call `tn_tick_int_processing()` after the
+ * given timeout. There are no ticks other than the ones of `_tick()`, so
+ * there's nothing to schedule.
+ */
+static void _tick_schedule(TN_TickCnt timeout)
+{
+   _TN_UNUSED(timeout);
+}
+
+/**
+ * Dynamic tick: current system tick counter value
+ */
+static TN_TickCnt _tick_cnt_get(void)
+{
+   return _tick_cnt;
+}
+#endif
+
+static void _idle_task_callback(void)
+{
+   //-- all other tasks are blocked: wake up the benchmark task if it waits
+   //   for that
+   if (_settle_pending){
+      _settle_pending = TN_FALSE;
+      tn_sem_signal(&_settle_sem);
+   }
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void)
+{
+   tn_bench_arch_init();
+
+#if TN_DYNAMIC_TICK
+   tn_callback_dyn_tick_set(_tick_schedule, _tick_cnt_get);
+#endif
+
+#if TN_TIMER_TASK
+   tn_timer_task_set(
+         _timer_task_stack, TN_BENCH_STACK_SIZE, _PRIORITY_TIMER
+         );
+#endif
+
+   tn_sys_start(
+         _idle_task_stack, TN_BENCH_STACK_SIZE,
+         _interrupt_stack, TN_BENCH_STACK_SIZE,
+         _init_task_create,
+         _idle_task_callback
+         );
+
+   //-- should never be here
+   return 1;
+}
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
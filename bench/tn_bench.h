@@ -0,0 +1,147 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Kernel microbenchmark: interface between the portable part (`tn_bench.c`)
+ * and the architecture-dependent part (`arch/<arch>/tn_bench_*.c`).
+ *
+ * Each architecture should provide the header `tn_bench_arch.h` which
+ * defines:
+ *
+ *    - `TN_BENCH_STACK_SIZE`: stack size for each task used by benchmark,
+ *      in words;
+ *    - `TN_BENCH_ARCH_CYCLES_MASK`: mask of the valid bits of the value
+ *      returned by `tn_bench_arch_cycles_get()`; the difference of two
+ *      values is taken modulo (mask + 1);
+ *    - `TN_BENCH_ARCH_CYCLES_UNIT`: string name of the units returned by
+ *      `tn_bench_arch_cycles_get()` (typically, `"cycles"`),
+ *
+ * and implement the functions declared below.
+ */
+
+#ifndef _TN_BENCH_H
+#define _TN_BENCH_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn.h"
+#include "tn_bench_arch.h"
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Value of free-running cycle counter
+ */
+typedef unsigned long TN_BenchCycles;
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Number of samples taken for each measurement
+ */
+#ifndef TN_BENCH_ITER_CNT
+#  define TN_BENCH_ITER_CNT      1000
+#endif
+
+/**
+ * Number of waiting tasks for the "N waiters" measurements
+ */
+#ifndef TN_BENCH_WAITERS_CNT
+#  define TN_BENCH_WAITERS_CNT   8
+#endif
+
+/**
+ * Name of the architecture, printed in the report header; Makefile
+ * sets it to the value of `TN_ARCH`.
+ */
+#ifndef TN_BENCH_ARCH_NAME
+#  define TN_BENCH_ARCH_NAME     "unknown"
+#endif
+
+/**
+ * Name of the compiler, printed in the report header; Makefile
+ * sets it to the value of `TN_COMPILER`.
+ */
+#ifndef TN_BENCH_COMPILER_NAME
+#  define TN_BENCH_COMPILER_NAME "unknown"
+#endif
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Initialize hardware (or host) needed by the benchmark: cycle counter and
+ * output. Called from `main()` before the kernel is started.
+ */
+void tn_bench_arch_init(void);
+
+/**
+ * Returns current value of free-running cycle counter, it should be
+ * incremented at least with CPU clock rate.
+ */
+TN_BenchCycles tn_bench_arch_cycles_get(void);
+
+/**
+ * Output null-terminated string as is.
+ */
+void tn_bench_arch_out(const char *str);
+
+/**
+ * Terminate the benchmark: `status` is 0 on success, non-zero on failure.
+ * Never returns.
+ */
+void tn_bench_arch_exit(int status);
+
+#endif // _TN_BENCH_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
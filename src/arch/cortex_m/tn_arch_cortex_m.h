@@ -95,6 +95,15 @@ extern "C"  {     /*}*/
  */
 #define  _TN_FFS(x)     ffs_asm(x)
 int ffs_asm(int x);
+
+/**
+ * FLS - find last set bit (1-based). Used by the \ref tn_tlsf.h "TLSF heap".
+ * Say, for `0xa8` it should return `8`.
+ *
+ * May be not defined: in this case, naive algorithm will be used.
+ */
+#define  _TN_FLS(x)     fls_asm(x)
+int fls_asm(int x);
 #endif
 
 /**
@@ -190,12 +199,13 @@ typedef  unsigned int               TN_UWord;
 typedef  unsigned int               TN_UIntPtr;
 
 /**
- * Maximum number of priorities available, this value usually matches
- * `#TN_INT_WIDTH`.
+ * Maximum number of priorities available: the kernel uses two-level bitmap
+ * of priorities with runnable tasks, so this value usually equals to
+ * `(#TN_INT_WIDTH * #TN_INT_WIDTH)`.
  *
  * @see TN_PRIORITIES_CNT
  */
-#define  TN_PRIORITIES_MAX_CNT      TN_INT_WIDTH
+#define  TN_PRIORITIES_MAX_CNT      (TN_INT_WIDTH * TN_INT_WIDTH)
 
 /**
  * Value for infinite waiting, usually matches `ULONG_MAX`,
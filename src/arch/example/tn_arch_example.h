@@ -52,6 +52,14 @@
  */
 #define  _TN_FFS(x) (32 - __builtin_clz((x) & (0 - (x))))
 
+/**
+ * FLS - find last set bit (1-based). Used by the \ref tn_tlsf.h "TLSF heap".
+ * Say, for `0xa8` it should return `8`.
+ *
+ * May be not defined: in this case, naive algorithm will be used.
+ */
+#define  _TN_FLS(x) (32 - __builtin_clz(x))
+
 /**
  * Used by the kernel as a signal that something really bad happened.
  * Indicates TNeo bugs as well as illegal kernel usage, e.g. sleeping in
@@ -112,12 +120,13 @@ typedef  unsigned int               TN_UWord;
 typedef  unsigned int               TN_UIntPtr;
 
 /**
- * Maximum number of priorities available, this value usually matches
- * `#TN_INT_WIDTH`.
+ * Maximum number of priorities available: the kernel uses two-level bitmap
+ * of priorities with runnable tasks, so this value usually equals to
+ * `(#TN_INT_WIDTH * #TN_INT_WIDTH)`.
  *
  * @see TN_PRIORITIES_CNT
  */
-#define  TN_PRIORITIES_MAX_CNT      TN_INT_WIDTH
+#define  TN_PRIORITIES_MAX_CNT      (TN_INT_WIDTH * TN_INT_WIDTH)
 
 /**
  * Value for infinite waiting, usually matches `ULONG_MAX`,
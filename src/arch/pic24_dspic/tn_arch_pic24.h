@@ -175,12 +175,13 @@ typedef  unsigned int               TN_UIntPtr;
 
 
 /**
- * Maximum number of priorities available, this value usually matches
- * `#TN_INT_WIDTH`.
+ * Maximum number of priorities available: the kernel uses two-level bitmap
+ * of priorities with runnable tasks, so this value usually equals to
+ * `(#TN_INT_WIDTH * #TN_INT_WIDTH)`.
  *
  * @see TN_PRIORITIES_CNT
  */
-#define  TN_PRIORITIES_MAX_CNT      TN_INT_WIDTH
+#define  TN_PRIORITIES_MAX_CNT      (TN_INT_WIDTH * TN_INT_WIDTH)
 
 /**
  * Value for infinite waiting, usually matches `ULONG_MAX`,
@@ -0,0 +1,456 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*
+ * POSIX (hosted) port.
+ *
+ * Each task has its own `ucontext_t` which is stored at the top of the task's
+ * stack; `task->stack_cur_pt` points to it. Context switch is just
+ * `swapcontext()`. All tasks run in the same OS thread.
+ *
+ * Interrupts are emulated:
+ *
+ *    - "interrupts disabled" is a software flag `_int_disabled`, so
+ *      disabling/enabling interrupts is cheap (no syscalls);
+ *    - system timer interrupt comes as `SIGALRM`. If the signal comes when
+ *      interrupts are disabled or when some ISR is already running, it is
+ *      just pended; pended interrupt is delivered by the code that enables
+ *      interrupts or exits from ISR;
+ *    - context switch requested while interrupts are disabled, or from ISR,
+ *      is pended as well, and performed when interrupts are enabled and
+ *      no ISR is running (like PendSV on Cortex-M).
+ *
+ * Since every task has its own stack, it's fine to switch context right from
+ * the signal handler: the preempted task will return from it when it is
+ * switched back. Signal mask is a part of the context, so the newly created
+ * tasks have `SIGALRM` unblocked explicitly.
+ */
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#if !defined(_XOPEN_SOURCE)
+//-- needed for ucontext on some systems (e.g. macOS)
+#  define _XOPEN_SOURCE 700
+#endif
+
+#if !defined(_DEFAULT_SOURCE)
+#  define _DEFAULT_SOURCE
+#endif
+
+#include <ucontext.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_tn_tasks.h"
+#include "_tn_sys.h"
+
+
+
+/*******************************************************************************
+ *    PUBLIC DATA
+ ******************************************************************************/
+
+volatile int tn_posix_int_nest_count = 0;
+
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+//-- Interrupts are disabled until the first task is started
+static volatile sig_atomic_t _int_disabled = 1;
+
+//-- Non-zero if scheduler is disabled by `tn_arch_sched_dis_save()`
+static volatile sig_atomic_t _sched_disabled = 0;
+
+//-- Non-zero if context switch is pended
+static volatile sig_atomic_t _ctx_sw_pending = 0;
+
+//-- Non-zero if system timer interrupt is pended
+static volatile sig_atomic_t _sys_timer_pending = 0;
+
+//-- User-provided system timer ISR, see `tn_posix_sys_timer_start()`
+static TN_PosixIsr *volatile _sys_timer_isr = NULL;
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- Alignment of `ucontext_t` stored in the task's stack
+#define _CONTEXT_ALIGN     16
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * Prevent the compiler from moving memory accesses across it: the signal
+ * handler may come at any point.
+ */
+_TN_STATIC_INLINE void _compiler_barrier(void)
+{
+   __asm__ volatile("" ::: "memory");
+}
+
+/**
+ * Returns pointer to the context stored in the task's stack
+ */
+_TN_STATIC_INLINE ucontext_t *_task_ctx_get(struct TN_Task *task)
+{
+   return (ucontext_t *)task->stack_cur_pt;
+}
+
+/**
+ * Switch context from `_tn_curr_run_task` to `_tn_next_task_to_run`.
+ * Should be called with interrupts enabled, outside of ISR; interrupts are
+ * disabled while switching context.
+ */
+static void _context_switch(void)
+{
+   _int_disabled = 1;
+   _compiler_barrier();
+
+   _ctx_sw_pending = 0;
+
+   if (_tn_curr_run_task != _tn_next_task_to_run){
+      struct TN_Task *task_prev = _tn_curr_run_task;
+
+#if _TN_ON_CONTEXT_SWITCH_HANDLER
+      _tn_sys_on_context_switch(_tn_curr_run_task, _tn_next_task_to_run);
+#endif
+
+      _tn_curr_run_task = _tn_next_task_to_run;
+
+      swapcontext(_task_ctx_get(task_prev), _task_ctx_get(_tn_curr_run_task));
+
+      //-- at this point, the task is switched back to
+   }
+
+   _compiler_barrier();
+   _int_disabled = 0;
+}
+
+/**
+ * Deliver pended interrupts and perform pended context switch, if
+ * interrupts are enabled and we're not inside ISR.
+ */
+static void _pending_process(void)
+{
+   while (!_int_disabled && tn_posix_int_nest_count == 0){
+      if (_sys_timer_pending){
+         _sys_timer_pending = 0;
+
+         tn_posix_int_nest_count++;
+         _sys_timer_isr();
+         tn_posix_int_nest_count--;
+      } else if (_ctx_sw_pending && !_sched_disabled){
+         _context_switch();
+      } else {
+         break;
+      }
+   }
+}
+
+/**
+ * `SIGALRM` handler: system timer interrupt.
+ */
+static void _sys_timer_sig_handler(int sig)
+{
+   _TN_UNUSED(sig);
+
+   if (_sys_timer_isr != NULL){
+      _sys_timer_pending = 1;
+      _pending_process();
+   }
+}
+
+/**
+ * Entry point of each task: enable interrupts and call task body function;
+ * if it returns, exit the task.
+ */
+static void _task_entry(void)
+{
+   //-- task body and parameter are taken from the current task, since
+   //   makecontext() is only able to pass int arguments.
+   struct TN_Task *task = _tn_curr_run_task;
+
+   _int_disabled = 0;
+   _pending_process();
+
+   task->task_func_addr(task->task_func_param);
+
+   _tn_task_exit_nodelete();
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_int_dis(void)
+{
+   _int_disabled = 1;
+   _compiler_barrier();
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_int_en(void)
+{
+   _compiler_barrier();
+   _int_disabled = 0;
+   _pending_process();
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+TN_UWord tn_arch_sr_save_int_dis(void)
+{
+   TN_UWord ret = _int_disabled;
+   _int_disabled = 1;
+   _compiler_barrier();
+   return ret;
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_sr_restore(TN_UWord sr)
+{
+   if (sr){
+      _int_disabled = 1;
+   } else {
+      tn_arch_int_en();
+   }
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+TN_UWord tn_arch_sched_dis_save(void)
+{
+   TN_UWord ret = _sched_disabled;
+   _sched_disabled = 1;
+   _compiler_barrier();
+   return ret;
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void tn_arch_sched_restore(TN_UWord sched_state)
+{
+   _compiler_barrier();
+   _sched_disabled = sched_state ? 1 : 0;
+   if (!sched_state){
+      _pending_process();
+   }
+}
+
+/*
+ * See comments in the file `tn_arch_posix.h`
+ */
+void tn_posix_sys_timer_start(unsigned long period_us, TN_PosixIsr *isr)
+{
+   struct itimerval itv;
+
+   memset(&itv, 0, sizeof(itv));
+
+   if (period_us != 0){
+      struct sigaction sa;
+
+      memset(&sa, 0, sizeof(sa));
+      sa.sa_handler = _sys_timer_sig_handler;
+      sa.sa_flags = SA_RESTART;
+      sigemptyset(&sa.sa_mask);
+      sigaction(SIGALRM, &sa, NULL);
+
+      _sys_timer_isr = isr;
+
+      itv.it_interval.tv_sec  = period_us / 1000000;
+      itv.it_interval.tv_usec = period_us % 1000000;
+      itv.it_value = itv.it_interval;
+   }
+
+   setitimer(ITIMER_REAL, &itv, NULL);
+}
+
+/*
+ * See comments in the file `tn_arch_posix.h`
+ */
+void tn_posix_isr_call(TN_PosixIsr *isr)
+{
+   tn_posix_int_nest_count++;
+   isr();
+   tn_posix_int_nest_count--;
+
+   _pending_process();
+}
+
+/*
+ * See comments in the file `tn_arch_posix.h`
+ */
+void _tn_posix_fatal_error(const char *file, int line, const char *msg)
+{
+   fprintf(stderr, "TNeo fatal error at %s:%d: %s\n", file, line, msg);
+   abort();
+}
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+TN_UWord *_tn_arch_stack_init(
+      TN_TaskBody   *task_func,
+      TN_UWord      *stack_low_addr,
+      TN_UWord      *stack_high_addr,
+      void          *param
+      )
+{
+   //-- context is stored at the top of the stack ('full desc stack' model)
+   TN_UIntPtr ctx_addr =
+      ((TN_UIntPtr)(stack_high_addr + 1) - sizeof(ucontext_t))
+      & ~(TN_UIntPtr)(_CONTEXT_ALIGN - 1);
+   ucontext_t *ctx = (ucontext_t *)ctx_addr;
+
+   if (ctx_addr <= (TN_UIntPtr)stack_low_addr){
+      _TN_FATAL_ERROR("stack is too small to hold ucontext_t");
+   }
+
+   getcontext(ctx);
+
+   ctx->uc_link = NULL;
+   ctx->uc_stack.ss_sp = stack_low_addr;
+   ctx->uc_stack.ss_size = ctx_addr - (TN_UIntPtr)stack_low_addr;
+   ctx->uc_stack.ss_flags = 0;
+
+   //-- system timer signal should never be blocked in the new task
+   sigdelset(&ctx->uc_sigmask, SIGALRM);
+
+   makecontext(ctx, _task_entry, 0);
+
+   //-- task body and parameter are taken by `_task_entry()` from the task
+   //   structure
+   _TN_UNUSED(task_func);
+   _TN_UNUSED(param);
+
+   return (TN_UWord *)ctx;
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+int _tn_arch_inside_isr(void)
+{
+   return (tn_posix_int_nest_count > 0);
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+int _tn_arch_is_int_disabled(void)
+{
+   return _int_disabled;
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void _tn_arch_context_switch_pend(void)
+{
+   _ctx_sw_pending = 1;
+   _pending_process();
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ */
+void _tn_arch_context_switch_now_nosave(void)
+{
+   _int_disabled = 1;
+   _ctx_sw_pending = 0;
+
+#if _TN_ON_CONTEXT_SWITCH_HANDLER
+   _tn_sys_on_context_switch(_tn_curr_run_task, _tn_next_task_to_run);
+#endif
+
+   _tn_curr_run_task = _tn_next_task_to_run;
+
+   setcontext(_task_ctx_get(_tn_curr_run_task));
+
+   _TN_FATAL_ERROR("setcontext() failed");
+}
+
+/*
+ * See comments in the file `tn_arch.h`
+ *
+ * NOTE: on the host, ISRs run on the stack of the interrupted task (well, on
+ * the signal stack of the process), so that given interrupt stack is not
+ * used.
+ */
+void _tn_arch_sys_start(
+      TN_UWord      *int_stack,
+      TN_UWord       int_stack_size
+      )
+{
+   _TN_UNUSED(int_stack);
+   _TN_UNUSED(int_stack_size);
+
+   _tn_arch_context_switch_now_nosave();
+}
+
@@ -0,0 +1,390 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ *
+ * \file
+ *
+ * POSIX (hosted) architecture-dependent routines.
+ *
+ * This port runs the kernel as an ordinary process on a POSIX host (Linux,
+ * *BSD, macOS): all tasks live in a single OS thread, each task has its own
+ * `ucontext_t` saved at the top of its stack, and interrupts are emulated:
+ *
+ *    - "interrupts disabled" state is just a software flag;
+ *    - the system timer interrupt is delivered by `SIGALRM` (see
+ *      `tn_posix_sys_timer_start()`);
+ *    - any other "interrupt" can be emulated synchronously by
+ *      `tn_posix_isr_call()`.
+ *
+ * Interrupts which come while interrupts are disabled (or while another ISR
+ * is running) are pended and delivered as soon as they are enabled again,
+ * and context switch is performed on exit from outermost ISR, just like
+ * PendSV does on Cortex-M.
+ *
+ * The port is intended for running and benchmarking the kernel on a
+ * development host, it is not a real-time environment.
+ */
+
+#ifndef  _TN_ARCH_POSIX_H
+#define  _TN_ARCH_POSIX_H
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "../tn_arch_detect.h"
+#include "../../core/tn_cfg_dispatch.h"
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Prototype of the emulated interrupt service routine, see
+ * `tn_posix_isr_call()` and `tn_posix_sys_timer_start()`.
+ */
+typedef void (TN_PosixIsr)(void);
+
+
+
+/*******************************************************************************
+ *    GLOBAL DATA
+ ******************************************************************************/
+
+/// Emulated interrupt nesting count: non-zero while some ISR is running
+/// (see `tn_posix_isr_call()`).
+extern volatile int tn_posix_int_nest_count;
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Start (or stop) the system timer: `SIGALRM` is generated every
+ * `period_us` microseconds, and given `isr` is called in the emulated
+ * interrupt context for each of them. Typically `isr` just calls
+ * `tn_tick_int_processing()`.
+ *
+ * May be called before `tn_sys_start()`: ticks that come before the first
+ * task is started are pended until then.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_MAIN)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param period_us
+ *    Timer period in microseconds; if 0, the timer is stopped.
+ * @param isr
+ *    Function to call on each timer interrupt.
+ */
+void tn_posix_sys_timer_start(unsigned long period_us, TN_PosixIsr *isr);
+
+/**
+ * Emulate an interrupt: call given `isr` in the interrupt context right
+ * now, and perform pended context switch (if any) on exit from it, as the
+ * hardware would do. Within `isr`, `tn_is_isr_context()` returns `TN_TRUE`
+ * and all the `tn_i...()` services are available.
+ *
+ * If interrupts are disabled, `isr` is nevertheless called (there is no
+ * real interrupt controller to pend it), but the context switch is
+ * postponed until interrupts are enabled again.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param isr
+ *    Function to call in the interrupt context.
+ */
+void tn_posix_isr_call(TN_PosixIsr *isr);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+ * Used by `_TN_FATAL_ERRORF()`: print message to `stderr` and abort.
+ */
+void _tn_posix_fatal_error(const char *file, int line, const char *msg);
+#endif
+
+
+
+/*******************************************************************************
+ *    ARCH-DEPENDENT DEFINITIONS
+ ******************************************************************************/
+
+
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#define  _TN_POSIX_INTSAVE_DATA_INVALID   ((TN_UWord)-1)
+
+#if TN_DEBUG
+#  define   _TN_POSIX_INTSAVE_CHECK()                          \
+{                                                              \
+   if (TN_INTSAVE_VAR == _TN_POSIX_INTSAVE_DATA_INVALID){      \
+      _TN_FATAL_ERROR("");                                     \
+   }                                                           \
+}
+#else
+#  define   _TN_POSIX_INTSAVE_CHECK()  /* nothing */
+#endif
+
+/**
+ * FFS - find first set bit. Used in `_find_next_task_to_run()` function.
+ * Say, for `0xa8` it should return `3`.
+ */
+#define  _TN_FFS(x)     __builtin_ffs(x)
+
+/**
+ * FLS - find last set bit (1-based). Used by the \ref tn_tlsf.h "TLSF heap".
+ * Say, for `0xa8` it should return `8`.
+ */
+#define  _TN_FLS(x)     (TN_INT_WIDTH - __builtin_clz(x))
+
+/**
+ * Used by the kernel as a signal that something really bad happened.
+ * Indicates TNeo bugs as well as illegal kernel usage
+ * (e.g. sleeping in the idle task callback)
+ *
+ * On the host, we print the message and abort, so that debugger stops
+ * here, or the core is dumped.
+ */
+#define  _TN_FATAL_ERRORF(error_msg, ...)                      \
+   {_tn_posix_fatal_error(__FILE__, __LINE__, "" error_msg);}
+
+/**
+ * \def TN_ARCH_STK_ATTR_BEFORE
+ *
+ * Compiler-specific attribute that should be placed **before** declaration of
+ * array used for stack. It is needed because there are often additional 
+ * restrictions applied to alignment of stack, so, to meet them, stack arrays
+ * need to be declared with these macros.
+ *
+ * @see TN_ARCH_STK_ATTR_AFTER
+ */
+
+/**
+ * \def TN_ARCH_STK_ATTR_AFTER
+ *
+ * Compiler-specific attribute that should be placed **after** declaration of
+ * array used for stack. It is needed because there are often additional 
+ * restrictions applied to alignment of stack, so, to meet them, stack arrays
+ * need to be declared with these macros.
+ *
+ * @see TN_ARCH_STK_ATTR_BEFORE
+ */
+
+#if defined(__TN_COMPILER_GCC__) || defined(__TN_COMPILER_CLANG__)
+#  define TN_ARCH_STK_ATTR_BEFORE
+#  define TN_ARCH_STK_ATTR_AFTER       __attribute__((aligned(0x10)))
+#else
+#  error unknown POSIX compiler
+#endif
+
+/**
+ * Minimum task's stack size, in words, not in bytes; includes a space for
+ * context plus for parameters passed to task's body function.
+ *
+ * On the host, the stack should also hold `ucontext_t` (which is about 1 KB
+ * on x86_64 Linux), and the frames of signal handler and libc functions,
+ * so it is much larger than on MCUs.
+ */
+#define  TN_MIN_STACK_SIZE          (2048                         \
+      + _TN_STACK_OVERFLOW_SIZE_ADD                               \
+      )
+
+/**
+ * Width of `int` type.
+ */
+#define  TN_INT_WIDTH               32
+
+/**
+ * Unsigned integer type whose size is equal to the size of CPU register.
+ * On the host, it is `unsigned long`, so that it is 64-bit on LP64 systems.
+ */
+typedef  unsigned long              TN_UWord;
+
+/**
+ * Unsigned integer type that is able to store pointers.
+ * We need it because some platforms don't define `uintptr_t`.
+ */
+typedef  unsigned long              TN_UIntPtr;
+
+/**
+ * Maximum number of priorities available: the kernel uses two-level bitmap
+ * of priorities with runnable tasks, so this value usually equals to
+ * `(#TN_INT_WIDTH * #TN_INT_WIDTH)`.
+ *
+ * @see TN_PRIORITIES_CNT
+ */
+#define  TN_PRIORITIES_MAX_CNT      (TN_INT_WIDTH * TN_INT_WIDTH)
+
+/**
+ * Value for infinite waiting, usually matches `ULONG_MAX`,
+ * because `#TN_TickCnt` is declared as `unsigned long`.
+ */
+#define  TN_WAIT_INFINITE           (TN_TickCnt)(~0UL)
+
+/**
+ * Value for initializing the task's stack
+ */
+#define  TN_FILL_STACK_VAL          0xFEEDFACE
+
+
+
+
+/**
+ * Variable name that is used for storing interrupts state
+ * by macros TN_INTSAVE_DATA and friends
+ */
+#define TN_INTSAVE_VAR              tn_save_status_reg
+
+/**
+ * Declares variable that is used by macros `TN_INT_DIS_SAVE()` and
+ * `TN_INT_RESTORE()` for storing status register value.
+ *
+ * @see `TN_INT_DIS_SAVE()`
+ * @see `TN_INT_RESTORE()`
+ */
+#define  TN_INTSAVE_DATA            \
+   TN_UWord TN_INTSAVE_VAR = _TN_POSIX_INTSAVE_DATA_INVALID;
+
+/**
+ * The same as `#TN_INTSAVE_DATA` but for using in ISR together with
+ * `TN_INT_IDIS_SAVE()`, `TN_INT_IRESTORE()`.
+ *
+ * @see `TN_INT_IDIS_SAVE()`
+ * @see `TN_INT_IRESTORE()`
+ */
+#define  TN_INTSAVE_DATA_INT        TN_INTSAVE_DATA
+
+/**
+ * \def TN_INT_DIS_SAVE()
+ *
+ * Disable interrupts and return previous value of status register,
+ * atomically. Similar `tn_arch_sr_save_int_dis()`.
+ *
+ * Uses `#TN_INTSAVE_DATA` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA`
+ * @see `tn_arch_sr_save_int_dis()`
+ */
+
+/**
+ * \def TN_INT_RESTORE()
+ *
+ * Restore previously saved status register.
+ * Similar to `tn_arch_sr_restore()`.
+ *
+ * Uses `#TN_INTSAVE_DATA` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA`
+ * @see `tn_arch_sr_save_int_dis()`
+ */
+
+#define TN_INT_DIS_SAVE()   TN_INTSAVE_VAR = tn_arch_sr_save_int_dis()
+#define TN_INT_RESTORE()    _TN_POSIX_INTSAVE_CHECK();                      \
+                            tn_arch_sr_restore(TN_INTSAVE_VAR)
+
+/**
+ * The same as `TN_INT_DIS_SAVE()` but for using in ISR.
+ *
+ * Uses `#TN_INTSAVE_DATA_INT` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA_INT`
+ */
+#define TN_INT_IDIS_SAVE()       TN_INT_DIS_SAVE()
+
+/**
+ * The same as `TN_INT_RESTORE()` but for using in ISR.
+ *
+ * Uses `#TN_INTSAVE_DATA_INT` as a temporary storage.
+ *
+ * @see `#TN_INTSAVE_DATA_INT`
+ */
+#define TN_INT_IRESTORE()        TN_INT_RESTORE()
+
+/**
+ * Returns nonzero if interrupts are disabled, zero otherwise.
+ */
+#define TN_IS_INT_DISABLED()     (_tn_arch_is_int_disabled())
+
+/**
+ * Pend context switch from interrupt: it is performed on exit from the
+ * outermost emulated ISR.
+ */
+#define _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED()          \
+   _tn_context_switch_pend_if_needed()
+
+/**
+ * Converts size in bytes to size in `#TN_UWord`.
+ */
+#define _TN_SIZE_BYTES_TO_UWORDS(size_in_bytes)    \
+   ((size_in_bytes) / sizeof(TN_UWord))
+
+#if TN_FORCED_INLINE
+#  define _TN_INLINE             inline __attribute__ ((always_inline))
+#else
+#  define _TN_INLINE             inline
+#endif
+#define _TN_STATIC_INLINE        static _TN_INLINE
+#define _TN_VOLATILE_WORKAROUND  /* nothing */
+
+#define _TN_ARCH_STACK_PT_TYPE   _TN_ARCH_STACK_PT_TYPE__FULL
+#define _TN_ARCH_STACK_DIR       _TN_ARCH_STACK_DIR__DESC
+
+#endif   //-- DOXYGEN_SHOULD_SKIP_THIS
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif   // _TN_ARCH_POSIX_H
+
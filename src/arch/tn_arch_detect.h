@@ -52,6 +52,7 @@
 
 #undef __TN_ARCH_PIC24_DSPIC__
 #undef __TN_ARCH_PIC32MX__
+#undef __TN_ARCH_POSIX__
 #undef __TN_ARCH_CORTEX_M__
 #undef __TN_ARCH_CORTEX_M0__
 #undef __TN_ARCH_CORTEX_M3__
@@ -185,7 +186,17 @@
 #     define __TN_COMPILER_GCC__
 #  endif
 
-#  if defined(__ARM_ARCH)
+#  if defined(__unix__) || defined(__unix) || defined(__linux__) \
+      || (defined(__APPLE__) && defined(__MACH__))
+
+/*
+ * Hosted compiler (as opposed to bare-metal one): build for POSIX host.
+ * NOTE: this check should go before the check of __ARM_ARCH, since
+ * the host may be ARM as well.
+ */
+#     define __TN_ARCH_POSIX__
+
+#  elif defined(__ARM_ARCH)
 
 #     define __TN_ARCH_CORTEX_M__
 
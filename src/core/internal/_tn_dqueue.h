@@ -71,6 +71,48 @@ extern "C"  {     /*}*/
  ******************************************************************************/
 
 
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Send an item to the queue if it's possible right now: the same as
+ * `tn_queue_send_polling()`, but without any checks and housekeeping. Used
+ * by other kernel objects that deliver data to the queues (see \ref
+ * tn_exch.h "exchange").
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    * `#TN_RC_OK` if item is sent (either given to the waiting task or put
+ *      to the FIFO);
+ *    * `#TN_RC_TIMEOUT` if the queue is full.
+ */
+enum TN_RCode _tn_queue_send_polling(
+      struct TN_DQueue *dque,
+      void *p_data
+      );
+
+#if TN_USE_WAIT_ANY
+/**
+ * Receive an item from the queue if it's possible right now, on behalf of
+ * the task calling `tn_wait_any()`: the same as `tn_queue_receive_polling()`,
+ * but without any checks and housekeeping.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    * `#TN_RC_OK` if item is received to `pp_data`;
+ *    * `#TN_RC_TIMEOUT` otherwise.
+ */
+enum TN_RCode _tn_queue_receive_polling(
+      struct TN_DQueue *dque,
+      void **pp_data
+      );
+#endif
+
+
+
 /*******************************************************************************
  *    PROTECTED INLINE FUNCTIONS
  ******************************************************************************/
@@ -124,6 +124,29 @@ enum TN_RCode _tn_eventgrp_link_manage(
       TN_BOOL              set
       );
 
+#if TN_USE_WAIT_ANY
+/**
+ * Check the event group condition, on behalf of the task calling
+ * `tn_wait_any()`: the same as `tn_eventgrp_wait_polling()`, but without
+ * checking the event group and the context.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    * `#TN_RC_OK` if condition is met (flags are cleared if needed, and
+ *      actual pattern is stored to `p_flags_pattern`);
+ *    * `#TN_RC_TIMEOUT` if condition isn't met;
+ *    * If `#TN_CHECK_PARAM` is non-zero, `#TN_RC_WPARAM` if pattern or mode
+ *      are wrong.
+ */
+enum TN_RCode _tn_eventgrp_wait_polling(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      );
+#endif
+
 
 
 /*******************************************************************************
@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright © 2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright © 2013, 2014 Anders Montonen.
- *    TNeo:                      copyright © 2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -77,16 +77,44 @@ struct TN_ExchLink;
  *    PROTECTED FUNCTION PROTOTYPES
  ******************************************************************************/
 
+/**
+ * Returns virtual methods table of the base link: subclasses use it in order
+ * to call methods of the superclass (say, destructor).
+ */
 const struct TN_ExchLink_VTable *_tn_exch_link_vtable(void);
 
+/**
+ * Constructor of the base link: subclasses call it first, and then set their
+ * own virtual methods table.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully constructed;
+ *    * If `#TN_CHECK_PARAM` is non-zero, `#TN_RC_WPARAM` if link is
+ *      `TN_NULL` or is already constructed.
+ */
 enum TN_RCode _tn_exch_link_create(
       struct TN_ExchLink     *exch_link
       );
 
+/**
+ * Notify the link that new value is written to the exchange it is added to:
+ * calls `notify()` virtual method.
+ *
+ * \attention Caller must disable interrupts.
+ */
 enum TN_RCode _tn_exch_link_notify(
       struct TN_ExchLink     *exch_link
       );
 
+/**
+ * Destruct the link: it is removed from the exchange (if it is added to
+ * any), and then `dtor()` virtual method is called.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully deleted;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
 enum TN_RCode _tn_exch_link_delete(
       struct TN_ExchLink     *exch_link
       );
@@ -102,8 +130,8 @@ enum TN_RCode _tn_exch_link_delete(
  * Checks whether given exchange link object is valid 
  * (actually, just checks against `id_exch_link` field, see `enum #TN_ObjId`)
  */
-static inline TN_BOOL _tn_exch_link_is_valid(
-      struct TN_ExchLink   *exch_link
+_TN_STATIC_INLINE TN_BOOL _tn_exch_link_is_valid(
+      const struct TN_ExchLink   *exch_link
       )
 {
    return (exch_link->id_exch_link == TN_ID_EXCHANGE_LINK);
@@ -43,6 +43,7 @@
 
 #include "_tn_sys.h"
 #include "tn_dqueue.h"
+#include "tn_fmem.h"
 
 
 
@@ -86,6 +87,52 @@ _TN_STATIC_INLINE TN_BOOL _tn_fmem_is_valid(
    return (fmem->id_fmp == TN_ID_FSMEMORYPOOL);
 }
 
+/**
+ * Returns priority index of the memory pool's wait queue if tasks wait for
+ * the memory pool in priority order (see `#TN_FMEM_ATTR_PRIO`), or `TN_NULL`
+ * otherwise. Other kernel objects that put tasks into the wait queue of the
+ * pool (see \ref tn_heap.h "heap") should give it to
+ * `_tn_task_curr_to_wait_action_wprio()`.
+ */
+_TN_STATIC_INLINE struct TN_ListPrioIdx *_tn_fmem_wait_queue_prio(
+      struct TN_FMem *fmem
+      )
+{
+#if TN_USE_PRIO_WAIT_QUEUES
+   return (fmem->attr & TN_FMEM_ATTR_PRIO)
+      ? &(fmem->wait_queue_prio) : TN_NULL;
+#else
+   _TN_UNUSED(fmem);
+   return TN_NULL;
+#endif
+}
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Try to allocate memory block from the pool; if there are no free blocks,
+ * `#TN_RC_TIMEOUT` is returned, and `p_data` isn't altered.
+ *
+ * Used by other kernel objects that are built on memory pools
+ * (see \ref tn_heap.h "heap").
+ *
+ * \attention Caller must disable interrupts.
+ */
+enum TN_RCode _tn_fmem_get(struct TN_FMem *fmem, void **p_data);
+
+/**
+ * Return memory block to the pool: if some task waits for free block, the
+ * block is given to it; otherwise, it is put into the pool. If the pool
+ * already has all its blocks free, `#TN_RC_OVERFLOW` is returned.
+ *
+ * \attention Caller must disable interrupts.
+ */
+enum TN_RCode _tn_fmem_release(struct TN_FMem *fmem, void *p_data);
+
 
 
 #ifdef __cplusplus
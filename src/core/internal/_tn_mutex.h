@@ -88,12 +88,44 @@ void _tn_mutex_unlock_all_by_task(struct TN_Task *task);
  */
 void _tn_mutex_i_on_task_wait_complete(struct TN_Task *task);
 
+/**
+ * Should be called when priority of the task that waits for mutex with
+ * priority inheritance is about to change (but `task->priority` still
+ * contains old priority).
+ */
+void _tn_mutex_i_on_waiter_priority_change(
+      struct TN_Task *task,
+      int new_priority
+      );
+
 /**
  * Should be called when task winishes waiting
  * for any mutex (no matter which algorithm it uses)
  */
 void _tn_mutex_on_task_wait_complete(struct TN_Task *task);
 
+/**
+ * Elevate task's priority to given value (if task's priority is now lower),
+ * and go on to the holders of the objects which task waits for (mutex with
+ * priority inheritance, or reader-writer lock), recursively.
+ */
+void _tn_mutex_task_priority_elevate(struct TN_Task *task, int priority);
+
+/**
+ * Recalculate task's priority: the highest one among its base priority,
+ * mutexes and reader-writer locks held by the task.
+ *
+ * @returns TN_TRUE if task's priority has changed
+ */
+TN_BOOL _tn_mutex_task_priority_update(struct TN_Task *task);
+
+/**
+ * Update priority of the holder of mutex with priority inheritance which
+ * `task` is/was waiting for, and so on, recursively (see
+ * `_tn_mutex_i_on_task_wait_complete()` for preconditions).
+ */
+void _tn_mutex_holders_priority_update(struct TN_Task *task);
+
 #else
 
 /*
@@ -107,9 +139,30 @@ _TN_STATIC_INLINE void _tn_mutex_unlock_all_by_task(struct TN_Task *task) {
 _TN_STATIC_INLINE void _tn_mutex_i_on_task_wait_complete(struct TN_Task *task) {
    (void) task;
 }
+_TN_STATIC_INLINE void _tn_mutex_i_on_waiter_priority_change(
+      struct TN_Task *task, int new_priority
+      )
+{
+   (void) task;
+   (void) new_priority;
+}
 _TN_STATIC_INLINE void _tn_mutex_on_task_wait_complete(struct TN_Task *task) {
    (void) task;
 }
+_TN_STATIC_INLINE void _tn_mutex_task_priority_elevate(
+      struct TN_Task *task, int priority
+      )
+{
+   (void) task;
+   (void) priority;
+}
+_TN_STATIC_INLINE TN_BOOL _tn_mutex_task_priority_update(struct TN_Task *task) {
+   (void) task;
+   return TN_FALSE;
+}
+_TN_STATIC_INLINE void _tn_mutex_holders_priority_update(struct TN_Task *task) {
+   (void) task;
+}
 #endif
 
 
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#ifndef __TN_RING_H
+#define __TN_RING_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "_tn_sys.h"
+#include "tn_ring.h"
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    EXTERNAL TYPES
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    PROTECTED INLINE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * Checks whether given ring object is valid 
+ * (actually, just checks against `id_ring` field, see `enum #TN_ObjId`)
+ */
+_TN_STATIC_INLINE TN_BOOL _tn_ring_is_valid(
+      const struct TN_Ring      *ring
+      )
+{
+   return (ring->id_ring == TN_ID_RING);
+}
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+
+#endif // __TN_RING_H
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
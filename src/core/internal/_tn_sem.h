@@ -55,6 +55,7 @@ extern "C"  {     /*}*/
  *    EXTERNAL TYPES
  ******************************************************************************/
 
+struct TN_Task;
 
 
 /*******************************************************************************
@@ -71,6 +72,40 @@ extern "C"  {     /*}*/
  ******************************************************************************/
 
 
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_USE_WAIT_ANY
+/**
+ * Acquire the semaphore if it's possible right now, on behalf of the task
+ * calling `tn_wait_any()`: the same as `tn_sem_wait_polling()`, but without
+ * any checks and housekeeping.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @return
+ *    * `#TN_RC_OK` if semaphore is acquired;
+ *    * `#TN_RC_TIMEOUT` otherwise.
+ */
+enum TN_RCode _tn_sem_wait_polling(struct TN_Sem *sem);
+#endif
+
+/**
+ * Should be called when task finishes waiting for semaphore with any
+ * result: if the task was the first in the wait queue and it didn't get
+ * units, then tasks behind it may be able to get them now.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @param task    Task that just finished waiting for the semaphore.
+ *                It should already be removed from the wait queue,
+ *                but its `pwait_queue` should still be valid.
+ */
+void _tn_sem_on_task_wait_complete(struct TN_Task *task);
+
+
+
 /*******************************************************************************
  *    PROTECTED INLINE FUNCTIONS
  ******************************************************************************/
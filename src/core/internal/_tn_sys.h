@@ -57,6 +57,15 @@ extern "C"  {     /*}*/
  *    PUBLIC TYPES
  ******************************************************************************/
 
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/// Number of words in the bitmap of priorities with runnable tasks
+/// (`#_tn_ready_to_run_bmp`): each word holds `#TN_INT_WIDTH` priorities.
+#define _TN_READY_BMP_WORDS_CNT                                   \
+   ((TN_PRIORITIES_CNT + TN_INT_WIDTH - 1) / TN_INT_WIDTH)
+
 /*******************************************************************************
  *    PROTECTED GLOBAL DATA
  ******************************************************************************/
@@ -80,11 +89,19 @@ extern struct TN_Task *_tn_curr_run_task;
 /// _tn_curr_run_task, context switch is needed)
 extern struct TN_Task *_tn_next_task_to_run;
 
-/// bitmask of priorities with runnable tasks.
-/// lowest priority bit (1 << (TN_PRIORITIES_CNT - 1)) should always be set,
+/// bitmask of priorities with runnable tasks: priority `N` is represented
+/// by the bit `(N % TN_INT_WIDTH)` of the word `(N / TN_INT_WIDTH)`.
+/// lowest priority bit (for `TN_PRIORITIES_CNT - 1`) should always be set,
 /// since this priority is used by idle task which should be always runnable,
 /// by design.
-extern volatile unsigned int _tn_ready_to_run_bmp;
+extern volatile unsigned int _tn_ready_to_run_bmp[ _TN_READY_BMP_WORDS_CNT ];
+
+#if _TN_READY_BMP_WORDS_CNT > 1
+/// summary of `#_tn_ready_to_run_bmp`: bit `N` is set if word `N` of
+/// `#_tn_ready_to_run_bmp` is non-zero. Used if only there is more than one
+/// word in the bitmap.
+extern volatile unsigned int _tn_ready_to_run_bmp_summary;
+#endif
 
 /// idle task structure
 extern struct TN_Task _tn_idle_task;
@@ -151,6 +168,17 @@ enum TN_StateFlag _tn_sys_state_flags_set(enum TN_StateFlag flags);
  */
 enum TN_StateFlag _tn_sys_state_flags_clear(enum TN_StateFlag flags);
 
+/**
+ * Arms or cancels the time slice timer (see \ref round_robin), depending on
+ * the next task to run: the timer is active if only round-robin is enabled
+ * for the priority of `#_tn_next_task_to_run`, and there is more than one
+ * runnable task with this priority.
+ *
+ * Should be called whenever ready queues or `#_tn_next_task_to_run` are
+ * changed. Interrupts should be disabled when calling it.
+ */
+void _tn_sys_tslice_update(void);
+
 #if TN_MUTEX_DEADLOCK_DETECT
 /**
  * This function is called when deadlock becomes active or inactive 
@@ -129,6 +129,13 @@ _TN_STATIC_INLINE TN_BOOL _tn_task_is_runnable(struct TN_Task *task)
  *    Wait queue to put task in, may be `#TN_NULL`. If not `#TN_NULL`, task is
  *    included in that list by `task_queue` member of `struct #TN_Task`.
  *
+ * @param wait_que_prio
+ *    If `#TN_NULL`, task is added to the end of `wait_que`; otherwise, tasks
+ *    in `wait_que` are ordered by priority (see `#TN_USE_PRIO_WAIT_QUEUES`),
+ *    this is the priority index of `wait_que`, and task is put after all the
+ *    tasks with the same or higher priority. Must be `#TN_NULL` if
+ *    `wait_que` is `#TN_NULL`, or if `#TN_USE_PRIO_WAIT_QUEUES` is zero.
+ *
  * @param wait_reason
  *    Reason of waiting, see `enum #TN_WaitReason`.
  *
@@ -139,6 +146,7 @@ _TN_STATIC_INLINE TN_BOOL _tn_task_is_runnable(struct TN_Task *task)
 void _tn_task_set_waiting(
       struct TN_Task      *task,
       struct TN_ListItem  *wait_que,
+      struct TN_ListPrioIdx *wait_que_prio,
       enum TN_WaitReason   wait_reason,
       TN_TickCnt           timeout
       );
@@ -294,7 +302,27 @@ _TN_STATIC_INLINE void _tn_task_curr_to_wait_action(
       )
 {
    _tn_task_clear_runnable(_tn_curr_run_task);
-   _tn_task_set_waiting(_tn_curr_run_task, wait_que, wait_reason, timeout);
+   _tn_task_set_waiting(
+         _tn_curr_run_task, wait_que, TN_NULL, wait_reason, timeout
+         );
+}
+
+/**
+ * The same as `#_tn_task_curr_to_wait_action()`, but the wait queue may be
+ * ordered by priority: see `wait_que_prio` argument of
+ * `#_tn_task_set_waiting()`.
+ */
+_TN_STATIC_INLINE void _tn_task_curr_to_wait_action_wprio(
+      struct TN_ListItem *wait_que,
+      struct TN_ListPrioIdx *wait_que_prio,
+      enum TN_WaitReason wait_reason,
+      TN_TickCnt timeout
+      )
+{
+   _tn_task_clear_runnable(_tn_curr_run_task);
+   _tn_task_set_waiting(
+         _tn_curr_run_task, wait_que, wait_que_prio, wait_reason, timeout
+         );
 }
 
 
@@ -368,6 +396,29 @@ TN_BOOL _tn_task_first_wait_complete(
       );
 
 
+/**
+ * Clear all the bits of the bitmap of priorities
+ */
+void _tn_prio_bmp_reset(struct TN_PrioBmp *bmp);
+
+/**
+ * Set the bit of given priority in the bitmap of priorities
+ */
+void _tn_prio_bmp_set(struct TN_PrioBmp *bmp, int priority);
+
+/**
+ * Clear the bit of given priority in the bitmap of priorities
+ */
+void _tn_prio_bmp_clear(struct TN_PrioBmp *bmp, int priority);
+
+/**
+ * Returns the highest priority (i.e. the lowest value) which is set in the
+ * bitmap of priorities and which is not higher than given one (i.e. the
+ * value is not less than `priority`); if there's no such priority, returns
+ * `-1`. Takes O(1) time.
+ */
+int _tn_prio_bmp_find(const struct TN_PrioBmp *bmp, int priority);
+
 /**
  * The same as `tn_task_exit(0)`, we need this function that takes no arguments
  * for exiting from task body function: we just set up initial task's stack so
@@ -409,6 +460,15 @@ _TN_STATIC_INLINE TN_BOOL _tn_task_is_valid(
    return (task->id_task == TN_ID_TASK);
 }
 
+/**
+ * Reset priority index of the list of tasks (the list is expected to be
+ * empty), see `struct #TN_ListPrioIdx`.
+ */
+_TN_STATIC_INLINE void _tn_list_prio_idx_reset(struct TN_ListPrioIdx *idx)
+{
+   _tn_prio_bmp_reset(&(idx->bmp));
+}
+
 
 
 #ifdef __cplusplus
@@ -137,6 +137,23 @@ TN_BOOL _tn_timer_is_active(struct TN_Timer *timer);
  */
 TN_TickCnt _tn_timer_time_left(struct TN_Timer *timer);
 
+#if TN_TIMER_TASK
+/**
+ * Should be called once at system startup (from `#tn_sys_start()`), after
+ * the idle task is created: creates and starts the timer task (see \ref
+ * timers_task).
+ */
+void _tn_timer_task_create(void);
+
+/**
+ * Called by `_tn_timer_callback_call()` for the expired timer which should
+ * be handled by the timer task: the timer is added to the list of pending
+ * timers, and the timer task is woken up. The timer should be already
+ * cancelled. Interrupts should be disabled when calling it.
+ */
+void _tn_timer_task_defer(struct TN_Timer *timer);
+#endif
+
 
 
 
@@ -161,6 +178,8 @@ _TN_STATIC_INLINE TN_BOOL _tn_timer_is_valid(
  * depending on `TN_DYNAMIC_TICK` option.
  * 
  * Enables interrupts, calls callback function, disables interrupts back.
+ * If the callback should be called from the timer task (see \ref
+ * timers_task), the timer is just handed over to it instead.
  * 
  * @param timer
  *    Timer to operate on
@@ -172,21 +191,29 @@ _TN_STATIC_INLINE void _tn_timer_callback_call(
       TN_UWord          TN_INTSAVE_VAR
       )
 {
-   //-- we're going to enable interrupt before calling callback, so,
-   //   remember user data before enabling them, since the structure
-   //   might be changed by interrupt
-   void *p_user_data = timer->p_user_data;
-
-   //-- before calling callback function, enable interrupts, so that
-   //   they aren't disabled for too long
-   TN_INT_IRESTORE();
-
-   //-- call user callback function
-   timer->func(timer, p_user_data);
-
-   //-- after callback is done, disable interrupts back
-   //   (saved value won't be used by anyone though)
-   TN_INT_IDIS_SAVE();
+#if TN_TIMER_TASK
+   if (timer->deferred){
+      //-- callback will be called by the timer task
+      _tn_timer_task_defer(timer);
+   } else
+#endif
+   {
+      //-- we're going to enable interrupt before calling callback, so,
+      //   remember user data before enabling them, since the structure
+      //   might be changed by interrupt
+      void *p_user_data = timer->p_user_data;
+
+      //-- before calling callback function, enable interrupts, so that
+      //   they aren't disabled for too long
+      TN_INT_IRESTORE();
+
+      //-- call user callback function
+      timer->func(timer, p_user_data);
+
+      //-- after callback is done, disable interrupts back
+      //   (saved value won't be used by anyone though)
+      TN_INT_IDIS_SAVE();
+   }
 }
 
 
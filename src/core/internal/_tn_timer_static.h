@@ -63,13 +63,10 @@ extern "C"  {     /*}*/
  ******************************************************************************/
 
 ///
-/// "generic" list of timers, for details, refer to \ref 
-/// timers_static_implementation
-extern struct TN_ListItem _tn_timer_list__gen;
-///
-/// "tick" lists of timers, for details, refer to \ref 
-/// timers_static_implementation
-extern struct TN_ListItem _tn_timer_list__tick[ TN_TICK_LISTS_CNT ];
+/// "tick" lists of timers of each level of the timing wheel, for details,
+/// refer to \ref timers_static_implementation
+extern struct TN_ListItem _tn_timer_list__tick[ TN_TICK_LISTS_LEVELS ]
+                                              [ TN_TICK_LISTS_CNT ];
 ///
 /// system time that can be returned by `tn_sys_time_get()`; it is also used
 /// by tn_timer.h subsystem.
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#ifndef __TN_WAIT_ANY_H
+#define __TN_WAIT_ANY_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "_tn_sys.h"
+#include "_tn_list.h"
+#include "tn_wait_any.h"
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+#if TN_USE_WAIT_ANY
+
+/**
+ * The object of the given item got ready (and it is already acquired on
+ * behalf of the waiting task, if `rc` is `#TN_RC_OK`), or it is deleted:
+ * wake up the task waiting in `tn_wait_any()`, returning given `rc`. Item is
+ * removed from the object's list, as well as all other items of the task.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @param item
+ *    Item which got ready; it must be contained in the object's list of
+ *    items (see `_tn_wait_any_first_get()`)
+ * @param rc
+ *    Code that should be returned from `tn_wait_any()`
+ */
+void _tn_wait_any_item_complete(
+      struct TN_WaitAnyItem  *item,
+      enum TN_RCode           rc
+      );
+
+/**
+ * Wake up all the tasks waiting for the object in `tn_wait_any()`, returning
+ * `#TN_RC_DELETED`. Should be called when object is being deleted.
+ *
+ * \attention Caller must disable interrupts.
+ *
+ * @param wait_any_list
+ *    Object's list of items
+ */
+void _tn_wait_any_notify_deleted(struct TN_ListItem *wait_any_list);
+
+/**
+ * Should be called when task finishes waiting in `tn_wait_any()`, no matter
+ * why: removes all the task's items from the objects' lists.
+ */
+void _tn_wait_any_on_task_wait_complete(struct TN_Task *task);
+
+#else
+
+/*
+ * tn_wait_any() is excluded from project: define stub function that is
+ * just compiled out.
+ */
+
+_TN_STATIC_INLINE void _tn_wait_any_on_task_wait_complete(
+      struct TN_Task *task
+      )
+{
+   (void) task;
+}
+
+#endif
+
+
+
+
+/*******************************************************************************
+ *    PROTECTED INLINE FUNCTIONS
+ ******************************************************************************/
+
+#if TN_USE_WAIT_ANY
+
+/**
+ * Returns the first item of the object's list of items (that is, the item
+ * of the task which started waiting in `tn_wait_any()` first), or `TN_NULL`
+ * if nobody waits for the object in `tn_wait_any()`.
+ *
+ * @param wait_any_list
+ *    Object's list of items
+ */
+_TN_STATIC_INLINE struct TN_WaitAnyItem *_tn_wait_any_first_get(
+      struct TN_ListItem *wait_any_list
+      )
+{
+   struct TN_WaitAnyItem *item = TN_NULL;
+
+   if (!_tn_list_is_empty(wait_any_list)){
+      item = _tn_list_first_entry(
+            wait_any_list, struct TN_WaitAnyItem, obj_queue
+            );
+   }
+
+   return item;
+}
+
+#endif
+
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+
+#endif // __TN_WAIT_ANY_H
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
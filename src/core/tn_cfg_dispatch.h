@@ -117,10 +117,30 @@
 #  endif
 #endif
 
+#if !defined(TN_USE_RWLOCKS)
+#  error TN_USE_RWLOCKS is not defined
+#endif
+
+#if TN_USE_RWLOCKS
+#  if !TN_USE_MUTEXES
+#     error TN_USE_RWLOCKS requires TN_USE_MUTEXES to be set
+#  endif
+#  if !defined(TN_RWLOCK_HOLDS_MAX)
+#     error TN_RWLOCK_HOLDS_MAX is not defined
+#  endif
+#  if TN_RWLOCK_HOLDS_MAX < 1 || TN_RWLOCK_HOLDS_MAX > 255
+#     error TN_RWLOCK_HOLDS_MAX should be from 1 to 255
+#  endif
+#endif
+
 #if !defined(TN_TICK_LISTS_CNT)
 #  error TN_TICK_LISTS_CNT is not defined
 #endif
 
+#if !defined(TN_TICK_LISTS_LEVELS)
+#  error TN_TICK_LISTS_LEVELS is not defined
+#endif
+
 #if !defined(TN_API_MAKE_ALIG_ARG)
 #  error TN_API_MAKE_ALIG_ARG is not defined
 #endif
@@ -151,6 +171,34 @@
 #  error TN_DYNAMIC_TICK is not defined
 #endif
 
+#if !defined(TN_DYNAMIC_TICK_HEAP)
+#  error TN_DYNAMIC_TICK_HEAP is not defined
+#endif
+
+#if !defined(TN_TIMER_TASK)
+#  error TN_TIMER_TASK is not defined
+#endif
+
+#if !defined(TN_TLSF_FL_INDEX_MAX)
+#  error TN_TLSF_FL_INDEX_MAX is not defined
+#endif
+
+#if !defined(TN_EVENTGRP_WAIT_LISTS_CNT)
+#  error TN_EVENTGRP_WAIT_LISTS_CNT is not defined
+#endif
+
+#if !defined(TN_USE_WAIT_ANY)
+#  error TN_USE_WAIT_ANY is not defined
+#endif
+
+#if !defined(TN_USE_TASK_NOTIFY)
+#  error TN_USE_TASK_NOTIFY is not defined
+#endif
+
+#if !defined(TN_USE_PRIO_WAIT_QUEUES)
+#  error TN_USE_PRIO_WAIT_QUEUES is not defined
+#endif
+
 #if !defined(TN_OLD_EVENT_API)
 #  error TN_OLD_EVENT_API is not defined
 #endif
@@ -181,6 +229,8 @@
 //-- NOTE: TN_TICK_LISTS_CNT is checked in tn_timer_static.c
 //-- NOTE: TN_PRIORITIES_CNT is checked in tn_sys.c
 //-- NOTE: TN_API_MAKE_ALIG_ARG is checked in tn_common.h
+//-- NOTE: TN_TLSF_FL_INDEX_MAX is checked in tn_tlsf.c
+//-- NOTE: TN_EVENTGRP_WAIT_LISTS_CNT is checked in tn_eventgrp.c
 
 
 /**
@@ -73,6 +73,14 @@ enum TN_ObjId {
    TN_ID_TIMER          = (int)0x1A937FBC,  //!< id for timers
    TN_ID_EXCHANGE       = (int)0x32b7c072,  //!< id for exchange objects
    TN_ID_EXCHANGE_LINK  = (int)0x24d36f35,  //!< id for exchange link
+   TN_ID_MSGQUEUE       = (int)0x5B3E91D7,  //!< id for message queues
+   TN_ID_RING           = (int)0x3C6D2A4B,  //!< id for SPSC rings
+   TN_ID_STREAMBUF      = (int)0x71E8B25D,  //!< id for stream buffers
+   TN_ID_HEAP           = (int)0x4D1A63E5,  //!< id for heaps
+   TN_ID_TLSF           = (int)0x2E9B5F13,  //!< id for TLSF heaps
+   TN_ID_WEVENTGRP      = (int)0x6A4C1D97,  //!< id for wide event groups
+   TN_ID_SEQLOCK        = (int)0x5C2E7A19,  //!< id for seqlocks
+   TN_ID_RWLOCK         = (int)0x3B7D0E65,  //!< id for reader-writer locks
 };
 
 /**
@@ -89,9 +97,12 @@ enum TN_RCode {
    ///
    /// This code is returned in the following cases:
    ///   * Trying to increment semaphore count more than its max count;
-   ///   * Trying to return extra memory block to fixed memory pool.
+   ///   * Trying to return extra memory block to fixed memory pool;
+   ///   * Task tries to lock reader-writer lock, but it already holds
+   ///     `#TN_RWLOCK_HOLDS_MAX` of them.
    /// @see tn_sem.h
    /// @see tn_fmem.h
+   /// @see tn_rwlock.h
    TN_RC_OVERFLOW             =  -2,
    ///
    /// Wrong context error: returned if function is called from 
@@ -119,8 +130,12 @@ enum TN_RCode {
    /// * task tries to unlock or delete the mutex that is locked by different
    ///   task,
    /// * task tries to lock mutex with priority ceiling whose priority is
-   ///   lower than task's priority
+   ///   lower than task's priority,
+   /// * task tries to unlock reader-writer lock which it doesn't hold, or
+   ///   tries to lock it for writing while already holding it (or vice
+   ///   versa)
    /// @see tn_mutex.h
+   /// @see tn_rwlock.h
    TN_RC_ILLEGAL_USE          =  -6,
    ///
    /// Returned when user tries to perform some operation on invalid object
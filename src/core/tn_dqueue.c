@@ -42,10 +42,14 @@
 #include "tn_common.h"
 #include "tn_sys.h"
 
+//-- std header for memcpy()
+#include <string.h>
+
 //-- internal tnkernel headers
 #include "_tn_eventgrp.h"
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_wait_any.h"
 
 
 #include "tn_dqueue.h"
@@ -118,13 +122,65 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_read(
    return (pp_data == TN_NULL) ? TN_RC_WPARAM : TN_RC_OK;
 }
 
+_TN_STATIC_INLINE enum TN_RCode _check_param_multi(
+      const struct TN_DQueue *dque,
+      void **p_data_arr,
+      int cnt
+      )
+{
+   enum TN_RCode rc = _check_param_generic(dque);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (p_data_arr == TN_NULL || cnt < 0){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
 #else
 #  define _check_param_generic(dque)                        (TN_RC_OK)
 #  define _check_param_create(dque, data_fifo, items_cnt)   (TN_RC_OK)
 #  define _check_param_read(pp_data)                        (TN_RC_OK)
+#  define _check_param_multi(dque, p_data_arr, cnt)         (TN_RC_OK)
 #endif
 // }}}
 
+/**
+ * Returns priority index of the list of tasks waiting to send data if tasks
+ * wait for the data queue in priority order, or `TN_NULL` otherwise
+ */
+_TN_STATIC_INLINE struct TN_ListPrioIdx *_wait_send_prio(
+      struct TN_DQueue *dque
+      )
+{
+#if TN_USE_PRIO_WAIT_QUEUES
+   return (dque->attr & TN_DQUEUE_ATTR_PRIO)
+      ? &(dque->wait_send_prio) : TN_NULL;
+#else
+   _TN_UNUSED(dque);
+   return TN_NULL;
+#endif
+}
+
+/**
+ * Returns priority index of the list of tasks waiting to receive data if
+ * tasks wait for the data queue in priority order, or `TN_NULL` otherwise
+ */
+_TN_STATIC_INLINE struct TN_ListPrioIdx *_wait_receive_prio(
+      struct TN_DQueue *dque
+      )
+{
+#if TN_USE_PRIO_WAIT_QUEUES
+   return (dque->attr & TN_DQUEUE_ATTR_PRIO)
+      ? &(dque->wait_receive_prio) : TN_NULL;
+#else
+   _TN_UNUSED(dque);
+   return TN_NULL;
+#endif
+}
+
 //-- Data queue storage FIFO processing {{{
 
 /**
@@ -206,6 +262,116 @@ static enum TN_RCode _fifo_read(struct TN_DQueue *dque, void **pp_data)
 
    return rc;
 }
+
+/**
+ * Put as many items to the FIFO as there is room for, moving them in
+ * contiguous runs (two at most, since the room might wrap around the end of
+ * the buffer).
+ *
+ * Unlike `_fifo_write()`, it doesn't manage the connected event group: it's
+ * up to the caller, so that it's done just once for the whole batch.
+ *
+ * @param dque
+ *    Data queue in which data should be written
+ * @param p_data_arr
+ *    Array of items to write
+ * @param cnt
+ *    Number of items in `p_data_arr`
+ *
+ * @return number of items actually written
+ */
+static int _fifo_write_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int cnt
+      )
+{
+   int done_cnt = 0;
+
+   if (cnt > dque->items_cnt - dque->filled_items_cnt){
+      cnt = dque->items_cnt - dque->filled_items_cnt;
+   }
+
+   while (done_cnt < cnt){
+      //-- write items up to the end of the buffer (or less)
+      int run_cnt = dque->items_cnt - dque->head_idx;
+
+      if (run_cnt > cnt - done_cnt){
+         run_cnt = cnt - done_cnt;
+      }
+
+      memcpy(
+            &dque->data_fifo[dque->head_idx],
+            &p_data_arr[done_cnt],
+            run_cnt * sizeof(void *)
+            );
+
+      done_cnt += run_cnt;
+      dque->head_idx += run_cnt;
+      if (dque->head_idx >= dque->items_cnt){
+         dque->head_idx = 0;
+      }
+   }
+
+   dque->filled_items_cnt += cnt;
+
+   return cnt;
+}
+
+/**
+ * Read as many items from the FIFO as available (but not more than `cnt`),
+ * moving them in contiguous runs (two at most, since the data might wrap
+ * around the end of the buffer).
+ *
+ * Unlike `_fifo_read()`, it doesn't manage the connected event group: it's
+ * up to the caller, so that it's done just once for the whole batch.
+ *
+ * @param dque
+ *    Data queue from which data should be read
+ * @param p_data_arr
+ *    Array at which items should be read
+ * @param cnt
+ *    Number of items in `p_data_arr`
+ *
+ * @return number of items actually read
+ */
+static int _fifo_read_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int cnt
+      )
+{
+   int done_cnt = 0;
+
+   if (cnt > dque->filled_items_cnt){
+      cnt = dque->filled_items_cnt;
+   }
+
+   while (done_cnt < cnt){
+      //-- read items up to the end of the buffer (or less)
+      int run_cnt = dque->items_cnt - dque->tail_idx;
+
+      if (run_cnt > cnt - done_cnt){
+         run_cnt = cnt - done_cnt;
+      }
+
+      memcpy(
+            &p_data_arr[done_cnt],
+            &dque->data_fifo[dque->tail_idx],
+            run_cnt * sizeof(void *)
+            );
+
+      done_cnt += run_cnt;
+      dque->tail_idx += run_cnt;
+      if (dque->tail_idx >= dque->items_cnt){
+         dque->tail_idx = 0;
+      }
+   }
+
+   dque->filled_items_cnt -= cnt;
+
+   return cnt;
+}
 // }}}
 
 /**
@@ -247,6 +413,28 @@ static void _cb_before_task_wait_complete__receive_ok(
    _TN_UNUSED(user_data_2);
 }
 
+/**
+ * The same as `_cb_before_task_wait_complete__receive_ok()`, but for
+ * multi-item transfer: the connected event group is not managed here, see
+ * `_fifo_write_multi()`.
+ *
+ * See `#_TN_CBBeforeTaskWaitComplete` for details on function signature.
+ */
+static void _cb_before_task_wait_complete__receive_multi_ok(
+      struct TN_Task   *task,
+      void             *user_data_1,
+      void             *user_data_2
+      )
+{
+   struct TN_DQueue *dque = (struct TN_DQueue *)user_data_1;
+
+   //-- put to data FIFO
+   if (_fifo_write_multi(dque, &task->subsys_wait.dqueue.data_elem, 1) != 1){
+      _TN_FATAL_ERROR("there should always be room for the item here");
+   }
+   _TN_UNUSED(user_data_2);
+}
+
 /**
  * Callback function that is given to `_tn_task_first_wait_complete()`
  * when `items_cnt` is 0.
@@ -268,6 +456,39 @@ static void _cb_before_task_wait_complete__receive_timeout(
 }
 
 
+/**
+ * If some task waits for new data (either in `tn_queue_receive()` or in
+ * `tn_wait_any()`), give the data to the first such task and wake it up.
+ *
+ * @return `TN_TRUE` if the data was given to some task, `TN_FALSE` if nobody
+ * waits for it.
+ */
+static TN_BOOL _receiver_give(struct TN_DQueue *dque, void *p_data)
+{
+   TN_BOOL given = _tn_task_first_wait_complete(
+         &dque->wait_receive_list, TN_RC_OK,
+         _cb_before_task_wait_complete__send, p_data, TN_NULL
+         );
+
+#if TN_USE_WAIT_ANY
+   if (!given){
+      struct TN_WaitAnyItem *item = _tn_wait_any_first_get(
+            &dque->wait_any_list
+            );
+
+      if (item != TN_NULL){
+         //-- some task waits for the data in tn_wait_any(): give the data
+         //   to it
+         item->result.data = p_data;
+         _tn_wait_any_item_complete(item, TN_RC_OK);
+         given = TN_TRUE;
+      }
+   }
+#endif
+
+   return given;
+}
+
 /**
  * Actual worker function that sends new data through the queue. Eventually
  * called when user calls one of these functions:
@@ -277,9 +498,9 @@ static void _cb_before_task_wait_complete__receive_timeout(
  * - `tn_queue_isend_polling()`
  *
  *
- * First of all, it checks whether there are tasks that wait for new data. If
- * so, the data is given to that task, and task is woken up. FIFO stays
- * untouched.
+ * First of all, it checks whether there are tasks that wait for new data
+ * (either in `tn_queue_receive()` or in `tn_wait_any()`). If so, the data is
+ * given to that task, and task is woken up. FIFO stays untouched.
  *
  * Otherwise, it calls `_fifo_write()` which tries to put data to the FIFO.
  * If there is a room in the FIFO, data is written, and `#TN_RC_OK` is
@@ -309,12 +530,7 @@ static enum TN_RCode _queue_send(
    //
    //   Otherwise (no waiting tasks), we add new message to the fifo.
 
-   if (  !_tn_task_first_wait_complete(
-            &dque->wait_receive_list, TN_RC_OK,
-            _cb_before_task_wait_complete__send, p_data, TN_NULL
-            )
-      )
-   {
+   if (!_receiver_give(dque, p_data)){
       //-- the data queue's wait_receive list is empty
       rc = _fifo_write(dque, p_data);
    }
@@ -399,6 +615,137 @@ static enum TN_RCode _queue_receive(
 }
 
 
+/**
+ * Actual worker function that transfers several items through the queue at
+ * once. Eventually called when user calls one of these functions:
+ *
+ * - `tn_queue_send_multi()`
+ * - `tn_queue_isend_multi()`
+ * - `tn_queue_receive_multi()`
+ * - `tn_queue_ireceive_multi()`
+ *
+ * When sending, items are given to the tasks that wait for data first (one
+ * item per task; if some task waits, the FIFO is empty), and the rest of
+ * items is moved to the FIFO by contiguous runs.
+ *
+ * When receiving, items are moved from the FIFO by contiguous runs; then,
+ * tasks that wait for room in the queue (if any) are woken up, one per
+ * freed item, and their items are put to the FIFO. If there are more items
+ * to receive, the FIFO is read again; if it's empty, the item is taken
+ * right from the waiting sender (that might happen if only `items_cnt` is
+ * 0).
+ *
+ * The connected event group (if any) is updated just once for the whole
+ * batch. Interrupts should be disabled by the caller, so the whole batch is
+ * transferred in a single critical section.
+ *
+ * @param dque
+ *    Data queue on which job should be performed.
+ * @param job_type
+ *    `_JOB_TYPE__SEND` or `_JOB_TYPE__RECEIVE`.
+ * @param p_data_arr
+ *    Array of `cnt` items: data to send, or place to store received data.
+ * @param cnt
+ *    Number of items in `p_data_arr`.
+ * @param p_done_cnt
+ *    Number of actually transferred items is stored here.
+ *
+ * @return
+ *    * `#TN_RC_OK` if at least one item was transferred, or `cnt` is 0;
+ *    * `#TN_RC_TIMEOUT` if no items were transferred.
+ */
+static enum TN_RCode _queue_multi(
+      struct TN_DQueue *dque,
+      enum _JobType job_type,
+      void **p_data_arr,
+      int cnt,
+      int *p_done_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   int done_cnt = 0;
+   int fifo_cnt = 0;    //-- number of items moved to/from the FIFO
+
+   switch (job_type){
+      case _JOB_TYPE__SEND:
+         //-- give items to the waiting receivers (if any)
+         while (
+               done_cnt < cnt
+               && _receiver_give(dque, p_data_arr[done_cnt])
+               )
+         {
+            done_cnt++;
+         }
+
+         //-- put the rest of items to the FIFO
+         fifo_cnt = _fifo_write_multi(
+               dque, p_data_arr + done_cnt, cnt - done_cnt
+               );
+         done_cnt += fifo_cnt;
+         break;
+
+      case _JOB_TYPE__RECEIVE:
+         while (done_cnt < cnt){
+            int read_cnt = _fifo_read_multi(
+                  dque, p_data_arr + done_cnt, cnt - done_cnt
+                  );
+
+            if (read_cnt > 0){
+               int i;
+
+               //-- there is room now: wake up to `read_cnt` senders (if
+               //   any), their items are put to the FIFO
+               for (
+                     i = 0;
+                     i < read_cnt && _tn_task_first_wait_complete(
+                        &dque->wait_send_list, TN_RC_OK,
+                        _cb_before_task_wait_complete__receive_multi_ok,
+                        dque, TN_NULL
+                        );
+                     i++
+                   )
+               {
+                  //-- just go on
+               }
+
+               fifo_cnt += read_cnt;
+            } else if (_tn_task_first_wait_complete(
+                     &dque->wait_send_list, TN_RC_OK,
+                     _cb_before_task_wait_complete__receive_timeout,
+                     &p_data_arr[done_cnt], TN_NULL
+                     )
+                  )
+            {
+               //-- FIFO is empty, but some task wants to send data
+               //   (that might happen if only dque->items_cnt is 0)
+               read_cnt = 1;
+            } else {
+               //-- nothing more to receive
+               break;
+            }
+
+            done_cnt += read_cnt;
+         }
+         break;
+   }
+
+   if (fifo_cnt > 0){
+      //-- set or clear flag in the connected event group (if any),
+      //   indicating whether there are messages in the queue
+      _tn_eventgrp_link_manage(
+            &dque->eventgrp_link, (dque->filled_items_cnt > 0)
+            );
+   }
+
+   if (done_cnt == 0 && cnt > 0){
+      rc = TN_RC_TIMEOUT;
+   }
+
+   *p_done_cnt = done_cnt;
+   return rc;
+}
+
+
 /**
  * Intermediary function that is called by queue-related services
  * (`tn_queue_send()`, `tn_queue_receive()`, etc), which performs all necessary
@@ -457,8 +804,9 @@ static enum TN_RCode _dqueue_job_perform(
                //   field, and put current task to wait until there's room in
                //   the queue.
                _tn_curr_run_task->subsys_wait.dqueue.data_elem = p_data;
-               _tn_task_curr_to_wait_action(
+               _tn_task_curr_to_wait_action_wprio(
                      &(dque->wait_send_list),
+                     _wait_send_prio(dque),
                      TN_WAIT_REASON_DQUE_WSEND,
                      timeout
                      );
@@ -476,8 +824,9 @@ static enum TN_RCode _dqueue_job_perform(
                //   happens.
                //
                //   Put current task to wait until new data comes.
-               _tn_task_curr_to_wait_action(
+               _tn_task_curr_to_wait_action_wprio(
                      &(dque->wait_receive_list),
+                     _wait_receive_prio(dque),
                      TN_WAIT_REASON_DQUE_WRECEIVE,
                      timeout
                      );
@@ -573,6 +922,152 @@ static enum TN_RCode _dqueue_job_iperform(
 }
 
 
+/**
+ * Intermediary function that is called by multi-item queue services
+ * (`tn_queue_send_multi()`, `tn_queue_receive_multi()`), which performs all
+ * necessary housekeeping and eventually calls `_queue_multi()`.
+ *
+ * If no items can be transferred right away and `timeout` is non-zero, the
+ * current task waits for the first item exactly like `_dqueue_job_perform()`
+ * does; once it is transferred, the rest of items is transferred without
+ * waiting.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+static enum TN_RCode _dqueue_multi_job_perform(
+      struct TN_DQueue *dque,
+      enum _JobType job_type,
+      void **p_data_arr,
+      int cnt,
+      int *p_done_cnt,
+      TN_TickCnt timeout
+      )
+{
+   TN_BOOL waited = TN_FALSE;
+   int done_cnt = 0;
+   enum TN_RCode rc = _check_param_multi(dque, p_data_arr, cnt);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _queue_multi(dque, job_type, p_data_arr, cnt, &done_cnt);
+
+      if (rc == TN_RC_TIMEOUT && timeout != 0){
+         //-- Nothing was transferred, and user asked to wait: wait for
+         //   the first item, just like single-item services do.
+         switch (job_type){
+            case _JOB_TYPE__SEND:
+               _tn_curr_run_task->subsys_wait.dqueue.data_elem = p_data_arr[0];
+               _tn_task_curr_to_wait_action_wprio(
+                     &(dque->wait_send_list),
+                     _wait_send_prio(dque),
+                     TN_WAIT_REASON_DQUE_WSEND,
+                     timeout
+                     );
+               break;
+
+            case _JOB_TYPE__RECEIVE:
+               _tn_task_curr_to_wait_action_wprio(
+                     &(dque->wait_receive_list),
+                     _wait_receive_prio(dque),
+                     TN_WAIT_REASON_DQUE_WRECEIVE,
+                     timeout
+                     );
+               break;
+         }
+
+         waited = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+
+         if (rc == TN_RC_OK){
+            if (job_type == _JOB_TYPE__RECEIVE){
+               p_data_arr[0] = _tn_curr_run_task->subsys_wait.dqueue.data_elem;
+            }
+            done_cnt = 1;
+
+            //-- the first item is transferred; transfer as many of the
+            //   remaining ones as possible, without waiting.
+            //   (the queue might be deleted in the meantime, so check it)
+            TN_INT_DIS_SAVE();
+            if (cnt > 1 && _tn_dqueue_is_valid(dque)){
+               int more_cnt = 0;
+               _queue_multi(
+                     dque, job_type, p_data_arr + 1, cnt - 1, &more_cnt
+                     );
+               done_cnt += more_cnt;
+            }
+            TN_INT_RESTORE();
+            _tn_context_switch_pend_if_needed();
+         }
+      }
+   }
+
+   if (p_done_cnt != TN_NULL){
+      *p_done_cnt = done_cnt;
+   }
+
+   return rc;
+}
+
+/**
+ * The same as `_dqueue_multi_job_perform()` with zero timeout, but for using
+ * in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+static enum TN_RCode _dqueue_multi_job_iperform(
+      struct TN_DQueue *dque,
+      enum _JobType job_type,
+      void **p_data_arr,
+      int cnt,
+      int *p_done_cnt
+      )
+{
+   int done_cnt = 0;
+   enum TN_RCode rc = _check_param_multi(dque, p_data_arr, cnt);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      //-- wrong context
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      rc = _queue_multi(dque, job_type, p_data_arr, cnt, &done_cnt);
+      TN_INT_IRESTORE();
+
+      //-- woken tasks (if any) are switched to just once, for the whole batch
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   if (p_done_cnt != TN_NULL){
+      *p_done_cnt = done_cnt;
+   }
+
+   return rc;
+}
+
+
 
 
 
@@ -583,8 +1078,9 @@ static enum TN_RCode _dqueue_job_iperform(
 /*
  * See comments in the header file (tn_dqueue.h)
  */
-enum TN_RCode tn_queue_create(
+enum TN_RCode tn_queue_create_wattr(
       struct TN_DQueue *dque,
+      enum TN_DQueueAttr attr,
       void **data_fifo,
       int items_cnt
       )
@@ -597,9 +1093,19 @@ enum TN_RCode tn_queue_create(
    } else {
       _tn_list_reset(&(dque->wait_send_list));
       _tn_list_reset(&(dque->wait_receive_list));
+#if TN_USE_WAIT_ANY
+      _tn_list_reset(&(dque->wait_any_list));
+#endif
 
       dque->data_fifo         = data_fifo;
       dque->items_cnt         = items_cnt;
+#if TN_USE_PRIO_WAIT_QUEUES
+      dque->attr              = attr;
+      _tn_list_prio_idx_reset(&(dque->wait_send_prio));
+      _tn_list_prio_idx_reset(&(dque->wait_receive_prio));
+#else
+      _TN_UNUSED(attr);
+#endif
 
       _tn_eventgrp_link_reset(&dque->eventgrp_link);
 
@@ -639,6 +1145,9 @@ enum TN_RCode tn_queue_delete(struct TN_DQueue * dque)
       //   (TN_RC_DELETED is returned)
       _tn_wait_queue_notify_deleted(&(dque->wait_send_list));
       _tn_wait_queue_notify_deleted(&(dque->wait_receive_list));
+#if TN_USE_WAIT_ANY
+      _tn_wait_any_notify_deleted(&(dque->wait_any_list));
+#endif
 
       dque->id_dque = TN_ID_NONE; //-- data queue does not exist now
 
@@ -716,6 +1225,71 @@ enum TN_RCode tn_queue_ireceive_polling(struct TN_DQueue *dque, void **pp_data)
    return _dqueue_job_iperform(dque, _JOB_TYPE__RECEIVE, pp_data);
 }
 
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_send_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int cnt,
+      int *p_sent_cnt,
+      TN_TickCnt timeout
+      )
+{
+   return _dqueue_multi_job_perform(
+         dque, _JOB_TYPE__SEND, p_data_arr, cnt, p_sent_cnt, timeout
+         );
+}
+
+
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_isend_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int cnt,
+      int *p_sent_cnt
+      )
+{
+   return _dqueue_multi_job_iperform(
+         dque, _JOB_TYPE__SEND, p_data_arr, cnt, p_sent_cnt
+         );
+}
+
+
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_receive_multi(
+      struct TN_DQueue *dque,
+      void **pp_data_arr,
+      int cnt,
+      int *p_received_cnt,
+      TN_TickCnt timeout
+      )
+{
+   return _dqueue_multi_job_perform(
+         dque, _JOB_TYPE__RECEIVE, pp_data_arr, cnt, p_received_cnt, timeout
+         );
+}
+
+
+/*
+ * See comments in the header file (tn_dqueue.h)
+ */
+enum TN_RCode tn_queue_ireceive_multi(
+      struct TN_DQueue *dque,
+      void **pp_data_arr,
+      int cnt,
+      int *p_received_cnt
+      )
+{
+   return _dqueue_multi_job_iperform(
+         dque, _JOB_TYPE__RECEIVE, pp_data_arr, cnt, p_received_cnt
+         );
+}
+
 /*
  * See comments in the header file (tn_dqueue.h)
  */
@@ -796,3 +1370,39 @@ enum TN_RCode tn_queue_eventgrp_disconnect(
 }
 
 
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (_tn_dqueue.h)
+ */
+enum TN_RCode _tn_queue_send_polling(
+      struct TN_DQueue *dque,
+      void *p_data
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   return _queue_send(dque, p_data);
+}
+
+#if TN_USE_WAIT_ANY
+/*
+ * See comments in the header file (_tn_dqueue.h)
+ */
+enum TN_RCode _tn_queue_receive_polling(
+      struct TN_DQueue *dque,
+      void **pp_data
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   return _queue_receive(dque, pp_data);
+}
+#endif
+
+
@@ -99,6 +99,23 @@ extern "C"  {  /*}*/
  *    PUBLIC TYPES
  ******************************************************************************/
 
+/**
+ * Attributes that could be given to the data queue, see
+ * `tn_queue_create_wattr()`.
+ */
+enum TN_DQueueAttr {
+   ///
+   /// No special attributes: waiting tasks are served in FIFO order.
+   TN_DQUEUE_ATTR_NONE        = (0),
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Tasks waiting to send or receive data are served in the order of their
+   /// priority; tasks with the same priority are served in FIFO order.
+   /// Available if only `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   TN_DQUEUE_ATTR_PRIO        = (1 << 0),
+#endif
+};
+
 /**
  * Structure representing data queue object
  */
@@ -133,6 +150,31 @@ struct TN_DQueue {
    ///
    /// connected event group
    struct TN_EGrpLink eventgrp_link;
+
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Attributes given to the data queue, available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   enum TN_DQueueAttr attr;
+   ///
+   /// Priority index of `wait_send_list`, used if only the data queue is
+   /// created with `#TN_DQUEUE_ATTR_PRIO`. Available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   struct TN_ListPrioIdx wait_send_prio;
+   ///
+   /// Priority index of `wait_receive_list`, used if only the data queue is
+   /// created with `#TN_DQUEUE_ATTR_PRIO`. Available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   struct TN_ListPrioIdx wait_receive_prio;
+#endif
+
+#if TN_USE_WAIT_ANY || defined(DOXYGEN_ACTIVE)
+   ///
+   /// list of items of the tasks that wait to receive data in
+   /// `tn_wait_any()`, available if only `#TN_USE_WAIT_ANY` option is
+   /// non-zero.
+   struct TN_ListItem  wait_any_list;
+#endif
 };
 
 /**
@@ -159,6 +201,25 @@ struct TN_DQueueTaskWait {
  *    PUBLIC FUNCTION PROTOTYPES
  ******************************************************************************/
 
+/**
+ * The same as `tn_queue_create()`, but takes additional argument: `attr`.
+ *
+ * @param dque       pointer to already allocated struct TN_DQueue.
+ * @param attr       attributes for that particular data queue, see
+ *                   `enum #TN_DQueueAttr`
+ * @param data_fifo  pointer to already allocated array of `void *` to store
+ *                   data queue items. Can be `#TN_NULL`.
+ * @param items_cnt  capacity of queue
+ *                   (count of elements in the `data_fifo` array)
+ *                   Can be 0.
+ */
+enum TN_RCode tn_queue_create_wattr(
+      struct TN_DQueue *dque,
+      enum TN_DQueueAttr attr,
+      void **data_fifo,
+      int items_cnt
+      );
+
 /**
  * Construct data queue. `id_dque` member should not contain `#TN_ID_DATAQUEUE`,
  * otherwise, `#TN_RC_WPARAM` is returned.
@@ -179,11 +240,16 @@ struct TN_DQueueTaskWait {
  *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
  *      is available: `#TN_RC_WPARAM`.
  */
-enum TN_RCode tn_queue_create(
+_TN_STATIC_INLINE enum TN_RCode tn_queue_create(
       struct TN_DQueue *dque,
       void **data_fifo,
       int items_cnt
-      );
+      )
+{
+   return tn_queue_create_wattr(
+         dque, TN_DQUEUE_ATTR_NONE, data_fifo, items_cnt
+         );
+}
 
 
 /**
@@ -330,6 +396,131 @@ enum TN_RCode tn_queue_ireceive_polling(
       void **pp_data
       );
 
+/**
+ * Send up to `cnt` data elements from the array `p_data_arr` to the data
+ * queue specified by the `dque`, in a single critical section.
+ *
+ * Elements are sent in order, each of them exactly as `tn_queue_send()`
+ * does: it is either given to the task waiting in the queue's `wait_receive`
+ * list, or placed to the data FIFO. Sending stops when all `cnt` elements
+ * are sent, or when the FIFO becomes full. Context switch (if any task was
+ * woken up) happens once, after the whole batch is sent, so sending a burst
+ * of elements is much cheaper than calling `tn_queue_send()` for each one.
+ *
+ * If no elements can be sent right away, behavior depends on the `timeout`
+ * value (refer to `#TN_TickCnt`): the task waits until the first element is
+ * sent, and then sends as many of the remaining ones as possible, without
+ * waiting. So, the function never waits once at least one element is sent,
+ * and it may send less than `cnt` elements: check `*p_sent_cnt`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param dque       pointer to data queue to send data to
+ * @param p_data_arr array of `cnt` values to send
+ * @param cnt        number of values in `p_data_arr`
+ * @param p_sent_cnt number of actually sent values is stored here;
+ *                   can be `#TN_NULL`.
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if at least one element was sent (or `cnt` is 0);
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_queue_send_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int cnt,
+      int *p_sent_cnt,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_queue_send_multi()` with zero timeout, but for using in the
+ * ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_queue_isend_multi(
+      struct TN_DQueue *dque,
+      void **p_data_arr,
+      int cnt,
+      int *p_sent_cnt
+      );
+
+/**
+ * Receive up to `cnt` data elements from the data queue specified by the
+ * `dque` and place them into the array `pp_data_arr`, in a single critical
+ * section.
+ *
+ * Elements are received in order, each of them exactly as
+ * `tn_queue_receive()` does, so tasks waiting in the queue's `wait_send`
+ * list put their data to the FIFO as the room appears. Receiving stops when
+ * `cnt` elements are received, or when there is no more data. Context switch
+ * (if any task was woken up) happens once, after the whole batch is
+ * received.
+ *
+ * If there is no data right away, behavior depends on the `timeout` value
+ * (refer to `#TN_TickCnt`): the task waits until the first element is
+ * received, and then receives as many of the remaining ones as available,
+ * without waiting. Check `*p_received_cnt` for the number of received
+ * elements.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param dque             pointer to data queue to receive data from
+ * @param pp_data_arr      array of `cnt` locations to store values
+ * @param cnt              number of locations in `pp_data_arr`
+ * @param p_received_cnt   number of actually received values is stored
+ *                         here; can be `#TN_NULL`.
+ * @param timeout          refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if at least one element was received (or `cnt` is 0);
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_queue_receive_multi(
+      struct TN_DQueue *dque,
+      void **pp_data_arr,
+      int cnt,
+      int *p_received_cnt,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_queue_receive_multi()` with zero timeout, but for using in
+ * the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_queue_ireceive_multi(
+      struct TN_DQueue *dque,
+      void **pp_data_arr,
+      int cnt,
+      int *p_received_cnt
+      );
+
 
 /**
  * Returns number of free items in the queue
@@ -45,6 +45,7 @@
 #include "_tn_eventgrp.h"
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_wait_any.h"
 
 
 //-- header of current module
@@ -58,6 +59,15 @@
 //TODO: remove in the future
 #define  _X96_HACKS  0
 
+//-- check TN_EVENTGRP_WAIT_LISTS_CNT value
+#if TN_EVENTGRP_WAIT_LISTS_CNT < 1
+#  error TN_EVENTGRP_WAIT_LISTS_CNT should be at least 1
+#elif TN_EVENTGRP_WAIT_LISTS_CNT > TN_INT_WIDTH
+#  error TN_EVENTGRP_WAIT_LISTS_CNT should not be more than TN_INT_WIDTH
+#endif
+
+
+
 /*******************************************************************************
  *    PRIVATE TYPES
  ******************************************************************************/
@@ -142,6 +152,26 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
 #endif
 // }}}
 
+/**
+ * Returns priority index of the event group's wait queue with given index
+ * if tasks wait for the event group in priority order, or `TN_NULL`
+ * otherwise
+ */
+_TN_STATIC_INLINE struct TN_ListPrioIdx *_wait_queue_prio(
+      struct TN_EventGrp *eventgrp,
+      int idx
+      )
+{
+#if TN_USE_PRIO_WAIT_QUEUES
+   return (eventgrp->attr & TN_EVENTGRP_ATTR_PRIO)
+      ? &(eventgrp->wait_queue_prio[idx]) : TN_NULL;
+#else
+   _TN_UNUSED(eventgrp);
+   _TN_UNUSED(idx);
+   return TN_NULL;
+#endif
+}
+
 
 /**
  * Check if condition is satisfied: check events mask against given pattern.
@@ -225,24 +255,54 @@ static void _clear_pattern_if_needed(
 
 
 /**
- * Walk through all tasks waiting for some event, wake up tasks whose waiting
- * condition is already satisfied.
+ * Returns index of the wait queue for the task waiting for the given pattern
+ * (which must be non-zero): see `#TN_EVENTGRP_WAIT_LISTS_CNT`.
+ */
+_TN_STATIC_INLINE int _wait_queue_idx_get(TN_UWord wait_pattern)
+{
+#if TN_EVENTGRP_WAIT_LISTS_CNT > 1
+   int idx = 0;
+
+   //-- find the least significant bit set. It's done on wait only, so,
+   //   simple loop is fine here.
+   while (!(wait_pattern & 1)){
+      wait_pattern >>= 1;
+      idx++;
+   }
+
+   return idx % TN_EVENTGRP_WAIT_LISTS_CNT;
+#else
+   _TN_UNUSED(wait_pattern);
+   return 0;
+#endif
+}
+
+/**
+ * Walk through the tasks waiting in the given wait queue, wake up tasks
+ * whose waiting condition is already satisfied.
+ *
+ * Wait pattern of the queue is recalculated as the union of the wait
+ * patterns of the tasks that remain in the queue.
  *
  * @param eventgrp
  *    Event group to handle.
+ * @param idx
+ *    Index of the wait queue.
  */
-static void _scan_event_waitqueue(struct TN_EventGrp *eventgrp)
+static void _scan_event_waitqueue(struct TN_EventGrp *eventgrp, int idx)
 {
    //-- interrupts should be disabled here
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
    struct TN_Task *task;
    struct TN_Task *tmp_task;
+   TN_UWord wait_queue_pattern = 0;
 
    //-- Walk through all tasks waiting for some event, checking
    //   if each particular condition is satisfied
    _tn_list_for_each_entry_safe(
-         task, struct TN_Task, tmp_task, &(eventgrp->wait_queue), task_queue
+         task, struct TN_Task, tmp_task,
+         &(eventgrp->wait_queue[idx]), task_queue
          )
    {
 
@@ -266,10 +326,123 @@ static void _scan_event_waitqueue(struct TN_EventGrp *eventgrp)
                task->subsys_wait.eventgrp.wait_mode,
                task->subsys_wait.eventgrp.wait_pattern
                );
+      } else {
+         //-- task keeps waiting
+         wait_queue_pattern |= task->subsys_wait.eventgrp.wait_pattern;
       }
    }
+
+   eventgrp->wait_queue_pattern[idx] = wait_queue_pattern;
 }
 
+#if TN_USE_WAIT_ANY
+/**
+ * Walk through the items of the tasks waiting for events in `tn_wait_any()`,
+ * wake up tasks whose waiting condition is already satisfied.
+ *
+ * When the task is woken up, all its items are removed from the lists of
+ * the objects (and it may have several items in this very list), so, after
+ * each woken task, the walk is started from the beginning of the list.
+ *
+ * @param eventgrp
+ *    Event group to handle.
+ */
+static void _wait_any_items_check(struct TN_EventGrp *eventgrp)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   struct TN_WaitAnyItem *item;
+   struct TN_WaitAnyItem *ready_item;
+
+   do {
+      ready_item = TN_NULL;
+
+      _tn_list_for_each_entry(
+            item, struct TN_WaitAnyItem, &(eventgrp->wait_any_list), obj_queue
+            )
+      {
+         if (     ready_item == TN_NULL
+               && _cond_check(eventgrp, item->wait_mode, item->pattern)
+            )
+         {
+            ready_item = item;
+         }
+      }
+
+      if (ready_item != TN_NULL){
+         //-- Condition is satisfied: remember actual pattern, clear flag(s)
+         //   if we need to, and wake the task up.
+         ready_item->result.flags_pattern = eventgrp->pattern;
+
+         _clear_pattern_if_needed(
+               eventgrp, ready_item->wait_mode, ready_item->pattern
+               );
+
+         _tn_wait_any_item_complete(ready_item, TN_RC_OK);
+      }
+   } while (ready_item != TN_NULL);
+}
+#endif
+
+/**
+ * Wake up the waiting tasks whose condition is satisfied after some flags
+ * were set. Only the wait queues whose tasks wait for these flags are
+ * examined; if no one waits for them, it takes O(1) time.
+ *
+ * @param eventgrp
+ *    Event group to handle.
+ * @param set_pattern
+ *    Flags that were set (that is, they were 0, and now they are 1).
+ *    Flags that were cleared can't satisfy any condition, so they don't
+ *    matter.
+ */
+static void _waiting_tasks_check(
+      struct TN_EventGrp *eventgrp,
+      TN_UWord set_pattern
+      )
+{
+   if (eventgrp->waited_pattern & set_pattern){
+      TN_UWord waited_pattern = 0;
+      int idx;
+
+      for (idx = 0; idx < TN_EVENTGRP_WAIT_LISTS_CNT; idx++){
+         if (eventgrp->wait_queue_pattern[idx] & set_pattern){
+            _scan_event_waitqueue(eventgrp, idx);
+         }
+
+         waited_pattern |= eventgrp->wait_queue_pattern[idx];
+      }
+
+      eventgrp->waited_pattern = waited_pattern;
+   }
+
+#if TN_USE_WAIT_ANY
+   if (set_pattern != 0){
+      _wait_any_items_check(eventgrp);
+   }
+#endif
+}
+
+#if TN_OLD_EVENT_API
+/**
+ * Returns whether there are tasks waiting for the event group
+ */
+static TN_BOOL _waiting_tasks_exist(struct TN_EventGrp *eventgrp)
+{
+   TN_BOOL ret = TN_FALSE;
+   int idx;
+
+   for (idx = 0; idx < TN_EVENTGRP_WAIT_LISTS_CNT; idx++){
+      if (!_tn_list_is_empty(&(eventgrp->wait_queue[idx]))){
+         ret = TN_TRUE;
+      }
+   }
+
+   return ret;
+}
+#endif
+
 
 /**
  * Actual worker function that is eventually called when user calls
@@ -305,7 +478,7 @@ static enum TN_RCode _eventgrp_wait(
       if (
             (eventgrp->attr & TN_EVENTGRP_ATTR_SINGLE) 
             &&
-            !_tn_list_is_empty(&(eventgrp->wait_queue))
+            _waiting_tasks_exist(eventgrp)
          )
       {
          rc = TN_RC_ILLEGAL_USE;
@@ -346,9 +519,9 @@ static enum TN_RCode _eventgrp_wait(
  * Modify current events pattern: set, clear or toggle flags. 
  *
  * If flags are cleared, there aren't any side effects: flags are just got
- * cleared. If, however, flags are set or toggled, then all the tasks waiting
- * for some particular event are checked whether the condition is met now. It
- * is done by `_scan_event_waitqueue()`.
+ * cleared. If, however, some flags get set, then the tasks waiting for these
+ * flags are checked whether the condition is met now. It is done by
+ * `_waiting_tasks_check()`.
  *
  * For params documentation, refer to `tn_eventgrp_modify()`.
  */
@@ -368,21 +541,22 @@ static enum TN_RCode _eventgrp_modify(
          break;
 
       case TN_EVENTGRP_OP_SET:
-         //-- set flags: do that if only given flags aren't already set.
-         //   (otherwise, there's no need to spend time walking through
-         //   all the waiting tasks)
-         if ((eventgrp->pattern & pattern) != pattern){
-            //-- flags aren't already set: so, set flags and check all tasks.
+         //-- set flags, and check tasks waiting for the flags that weren't
+         //   already set (if all the given flags are already set, there's
+         //   nothing to check)
+         {
+            TN_UWord set_pattern = pattern & ~eventgrp->pattern;
 
             eventgrp->pattern |= pattern;
-            _scan_event_waitqueue(eventgrp);
+            _waiting_tasks_check(eventgrp, set_pattern);
          }
          break;
 
       case TN_EVENTGRP_OP_TOGGLE:
-         //-- toggle flags: after flags are toggled, check all waiting tasks.
+         //-- toggle flags, and check tasks waiting for the flags that
+         //   got set.
          eventgrp->pattern ^= pattern;
-         _scan_event_waitqueue(eventgrp);
+         _waiting_tasks_check(eventgrp, pattern & eventgrp->pattern);
          break;
    }
 
@@ -413,11 +587,23 @@ enum TN_RCode tn_eventgrp_create_wattr(
       //-- just return rc as it is
    } else {
 
-      _tn_list_reset(&(eventgrp->wait_queue));
+      int idx;
 
+      for (idx = 0; idx < TN_EVENTGRP_WAIT_LISTS_CNT; idx++){
+         _tn_list_reset(&(eventgrp->wait_queue[idx]));
+#if TN_USE_PRIO_WAIT_QUEUES
+         _tn_list_prio_idx_reset(&(eventgrp->wait_queue_prio[idx]));
+#endif
+         eventgrp->wait_queue_pattern[idx] = 0;
+      }
+
+      eventgrp->waited_pattern   = 0;
+#if TN_USE_WAIT_ANY
+      _tn_list_reset(&(eventgrp->wait_any_list));
+#endif
       eventgrp->pattern    = initial_pattern;
       eventgrp->id_event   = TN_ID_EVENTGRP;
-#if TN_OLD_EVENT_API
+#if TN_OLD_EVENT_API || TN_USE_PRIO_WAIT_QUEUES
       eventgrp->attr       = attr;
 #endif
 
@@ -438,13 +624,20 @@ enum TN_RCode tn_eventgrp_delete(struct TN_EventGrp *eventgrp)
    } else if (!tn_is_task_context()){
       rc = TN_RC_WCONTEXT;
    } else {
+      int idx;
+
       TN_INTSAVE_DATA;
 
       TN_INT_DIS_SAVE();
 
-      // remove all waiting tasks from wait list (if any), returning the
+      // remove all waiting tasks from wait lists (if any), returning the
       // TN_RC_DELETED code.
-      _tn_wait_queue_notify_deleted(&(eventgrp->wait_queue));
+      for (idx = 0; idx < TN_EVENTGRP_WAIT_LISTS_CNT; idx++){
+         _tn_wait_queue_notify_deleted(&(eventgrp->wait_queue[idx]));
+      }
+#if TN_USE_WAIT_ANY
+      _tn_wait_any_notify_deleted(&(eventgrp->wait_any_list));
+#endif
 
       eventgrp->id_event = TN_ID_NONE; //-- event does not exist now
 
@@ -491,13 +684,20 @@ enum TN_RCode tn_eventgrp_wait(
          //   So, remember waiting parameters (mode, pattern), and put
          //   current task to wait.
 
+         int idx = _wait_queue_idx_get(wait_pattern);
+
          _tn_curr_run_task->subsys_wait.eventgrp.wait_mode = wait_mode;
          _tn_curr_run_task->subsys_wait.eventgrp.wait_pattern = wait_pattern;
-         _tn_task_curr_to_wait_action(
-               &(eventgrp->wait_queue),
+         _tn_task_curr_to_wait_action_wprio(
+               &(eventgrp->wait_queue[idx]),
+               _wait_queue_prio(eventgrp, idx),
                TN_WAIT_REASON_EVENT,
                timeout
                );
+
+         //-- remember that the flags are waited for
+         eventgrp->wait_queue_pattern[idx] |= wait_pattern;
+         eventgrp->waited_pattern |= wait_pattern;
          waited_for_event = TN_TRUE;
       }
 
@@ -730,3 +930,19 @@ enum TN_RCode _tn_eventgrp_link_manage(
 }
 
 
+#if TN_USE_WAIT_ANY
+/**
+ * See comments in the file _tn_eventgrp.h
+ */
+enum TN_RCode _tn_eventgrp_wait_polling(
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      )
+{
+   return _eventgrp_wait(eventgrp, wait_pattern, wait_mode, p_flags_pattern);
+}
+#endif
+
+
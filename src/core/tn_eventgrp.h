@@ -50,6 +50,31 @@
  * where (for some reasons) one task has to wait for many tasks, or vice versa,
  * many tasks have to wait for one task.
  *
+ * \section eventgrp_wait_lists Wait queues
+ *
+ * When flags are set (or toggled), the kernel has to find the waiting tasks
+ * whose condition is met now; this is done with interrupts disabled, so,
+ * the event group tries hard to examine as few tasks as possible:
+ *
+ * - It maintains the union of the flags that all the waiting tasks wait for.
+ *   If none of the newly set flags is waited for, modification of the pattern
+ *   takes O(1) time, no tasks are examined at all. (Clearing of the flags
+ *   never examines tasks as well, since it can't satisfy anyone)
+ * - The waiting tasks can be distributed among several wait queues, see
+ *   `#TN_EVENTGRP_WAIT_LISTS_CNT`. The task gets to the queue by the least
+ *   significant bit of its wait pattern, and each queue has its own union of
+ *   the flags its tasks wait for; only queues whose tasks wait for the newly
+ *   set flags are examined. So, if tasks wait for different flags of the same
+ *   event group, setting a flag examines just the tasks that wait for it.
+ *
+ * Within each queue, tasks are examined in the order they started waiting
+ * (or in the order of their priority, if event group is created with
+ * `#TN_EVENTGRP_ATTR_PRIO`); queues are examined in the order of their
+ * indexes. Keep it in mind if tasks
+ * wait for the same flags with `#TN_EVENTGRP_WMODE_AUTOCLR`: such tasks
+ * should better have the same least significant bit in the wait pattern, so
+ * that they get to the same queue.
+ *
  * \section eventgrp_connect Connecting an event group to other system objects
  *
  * Sometimes task needs to wait for different system events, the most common
@@ -88,7 +113,8 @@
  * non-empty, the flag is set. If the queue becomes empty, the flag is cleared.
  * 
  * For the information on system services related to queue, refer to the \ref 
- * tn_dqueue.h "queue reference".
+ * tn_dqueue.h "queue reference". \ref tn_msgq.h "Message queues" can be
+ * connected to the event group in the same way.
  *
  * There is an example project available that demonstrates event group
  * connection technique: `examples/queue_eventgrp_conn`. Be sure to examine the
@@ -165,8 +191,9 @@ enum TN_EGrpOp {
 /**
  * Attributes that could be given to the event group object.
  *
- * Makes sense if only `#TN_OLD_EVENT_API` option is non-zero; otherwise,
- * there's just one dummy attribute available: `#TN_EVENTGRP_ATTR_NONE`.
+ * Makes sense if only `#TN_OLD_EVENT_API` or `#TN_USE_PRIO_WAIT_QUEUES`
+ * option is non-zero; otherwise, there's just one dummy attribute available:
+ * `#TN_EVENTGRP_ATTR_NONE`.
  */
 enum TN_EGrpAttr {
 #if TN_OLD_EVENT_API || defined(DOXYGEN_ACTIVE)
@@ -203,6 +230,15 @@ enum TN_EGrpAttr {
    /// `#TN_OLD_EVENT_API`)
    TN_EVENTGRP_ATTR_NONE      = (0),
 #endif
+
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Waiting tasks are examined in the order of their priority (tasks with
+   /// the same priority are examined in FIFO order) within each wait queue,
+   /// see \ref eventgrp_wait_lists. Available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   TN_EVENTGRP_ATTR_PRIO      = (1 << 3),
+#endif
 };
 
 
@@ -216,19 +252,45 @@ struct TN_EventGrp {
    /// to detect memory corruption.
    enum TN_ObjId        id_event;
    ///
-   /// task wait queue
-   struct TN_ListItem   wait_queue;
+   /// task wait queues: waiting task is put to the queue with index
+   /// `(index of least significant bit of its wait pattern) %
+   /// #TN_EVENTGRP_WAIT_LISTS_CNT`.
+   struct TN_ListItem   wait_queue[ TN_EVENTGRP_WAIT_LISTS_CNT ];
+   ///
+   /// for each wait queue: union of the wait patterns of its tasks. It may
+   /// contain extra flags of the tasks that don't wait anymore (because of
+   /// timeout, say); they are cleaned up when the queue is examined next time.
+   TN_UWord             wait_queue_pattern[ TN_EVENTGRP_WAIT_LISTS_CNT ];
+   ///
+   /// union of all the `wait_queue_pattern[]`: flags waited for by any task
+   TN_UWord             waited_pattern;
    ///
    /// current flags pattern
    TN_UWord             pattern;
 
-#if TN_OLD_EVENT_API || defined(DOXYGEN_ACTIVE)
+#if TN_OLD_EVENT_API || TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
    ///
    /// Attributes that are given to that events group,
-   /// available if only `#TN_OLD_EVENT_API` option is non-zero.
+   /// available if only `#TN_OLD_EVENT_API` or `#TN_USE_PRIO_WAIT_QUEUES`
+   /// option is non-zero.
    enum TN_EGrpAttr     attr;
 #endif
 
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Priority indexes of `wait_queue[]`, used if only the event group is
+   /// created with `#TN_EVENTGRP_ATTR_PRIO`. Available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   struct TN_ListPrioIdx wait_queue_prio[ TN_EVENTGRP_WAIT_LISTS_CNT ];
+#endif
+
+#if TN_USE_WAIT_ANY || defined(DOXYGEN_ACTIVE)
+   ///
+   /// list of items of the tasks that wait for events in `tn_wait_any()`,
+   /// available if only `#TN_USE_WAIT_ANY` option is non-zero.
+   struct TN_ListItem   wait_any_list;
+#endif
+
 };
 
 /**
@@ -277,7 +339,8 @@ struct TN_EGrpLink {
 
 /**
  * The same as `#tn_eventgrp_create()`, but takes additional argument: `attr`.
- * It makes sense if only `#TN_OLD_EVENT_API` option is non-zero.
+ * It makes sense if only `#TN_OLD_EVENT_API` or `#TN_USE_PRIO_WAIT_QUEUES`
+ * option is non-zero.
  *
  * @param eventgrp
  *    Pointer to already allocated struct TN_EventGrp
@@ -0,0 +1,395 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+//-- common tnkernel headers
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_sys.h"
+#include "_tn_exch.h"
+#include "_tn_exch_link.h"
+#include "_tn_list.h"
+
+
+//-- header of current module
+#include "tn_exch.h"
+
+//-- header of other needed modules
+#include "tn_exch_link.h"
+
+//-- std header for memcpy()
+#include <string.h>
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_Exch *exch
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (exch == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_exch_is_valid(exch)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_Exch *exch,
+      void                 *data,
+      unsigned int          size
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (exch == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (_tn_exch_is_valid(exch)){
+      rc = TN_RC_WPARAM;
+   } else if (data == TN_NULL || size == 0){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_link(
+      const struct TN_Exch       *exch,
+      const struct TN_ExchLink   *exch_link
+      )
+{
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (exch_link == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_exch_link_is_valid(exch_link)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_data(
+      const struct TN_Exch *exch,
+      const void           *data
+      )
+{
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (data == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(exch)                  (TN_RC_OK)
+#  define _check_param_create(exch, data, size)       (TN_RC_OK)
+#  define _check_param_link(exch, exch_link)          (TN_RC_OK)
+#  define _check_param_data(exch, data)               (TN_RC_OK)
+#endif
+// }}}
+
+/**
+ * Write new value to the exchange, and notify all its links. All links are
+ * notified even if some of them fail; return code of the first failed link
+ * is returned.
+ *
+ * \attention Caller must disable interrupts.
+ */
+static enum TN_RCode _exch_write(
+      struct TN_Exch   *exch,
+      const void       *data
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   struct TN_ExchLink *exch_link;
+
+   memcpy(exch->data, data, exch->size);
+
+   _tn_list_for_each_entry(
+         exch_link, struct TN_ExchLink, &(exch->links_list), links_list_item
+         )
+   {
+      enum TN_RCode link_rc = _tn_exch_link_notify(exch_link);
+
+      if (rc == TN_RC_OK){
+         rc = link_rc;
+      }
+   }
+
+   return rc;
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_create(
+      struct TN_Exch   *exch,
+      void             *data,
+      unsigned int      size
+      )
+{
+   enum TN_RCode rc = _check_param_create(exch, data, size);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (TN_MAKE_ALIG_SIZE((TN_UIntPtr)data) != (TN_UIntPtr)data){
+      //-- `data` isn't aligned properly
+      rc = TN_RC_WPARAM;
+   } else if (TN_MAKE_ALIG_SIZE(size) != size){
+      //-- `size` isn't aligned properly
+      rc = TN_RC_WPARAM;
+   } else {
+      //-- checks are done; proceed to actual creation
+      exch->data = data;
+      exch->size = size;
+
+      //-- reset links_list
+      _tn_list_reset(&(exch->links_list));
+
+      //-- set id
+      exch->id_exch = TN_ID_EXCHANGE;
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_delete(struct TN_Exch *exch)
+{
+   enum TN_RCode rc = _check_param_generic(exch);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- remove all the links from the exchange
+      while (!_tn_list_is_empty(&(exch->links_list))){
+         struct TN_ExchLink *exch_link = _tn_list_first_entry_remove(
+               &(exch->links_list), struct TN_ExchLink, links_list_item
+               );
+
+         exch_link->exch = TN_NULL;
+      }
+
+      exch->id_exch = TN_ID_NONE;   //-- exchange object does not exist now
+
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_link_add(
+      struct TN_Exch       *exch,
+      struct TN_ExchLink   *exch_link
+      )
+{
+   enum TN_RCode rc = _check_param_link(exch, exch_link);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      if (exch_link->exch != TN_NULL){
+         //-- link is already added to some exchange
+         rc = TN_RC_WSTATE;
+      } else {
+         _tn_list_add_tail(
+               &(exch->links_list), &(exch_link->links_list_item)
+               );
+         exch_link->exch = exch;
+      }
+
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_link_remove(
+      struct TN_Exch       *exch,
+      struct TN_ExchLink   *exch_link
+      )
+{
+   enum TN_RCode rc = _check_param_link(exch, exch_link);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      if (exch_link->exch != exch){
+         //-- link isn't added to the given exchange
+         rc = TN_RC_WSTATE;
+      } else {
+         _tn_list_remove_entry(&(exch_link->links_list_item));
+         exch_link->exch = TN_NULL;
+      }
+
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_write(
+      struct TN_Exch   *exch,
+      const void       *data
+      )
+{
+   enum TN_RCode rc = _check_param_data(exch, data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _exch_write(exch, data);
+
+      TN_INT_RESTORE();
+
+      //-- links might have woken up some high-priority task(s)
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_iwrite(
+      struct TN_Exch   *exch,
+      const void       *data
+      )
+{
+   enum TN_RCode rc = _check_param_data(exch, data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _exch_write(exch, data);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_exch.h)
+ */
+enum TN_RCode tn_exch_read(
+      struct TN_Exch   *exch,
+      void             *data_tgt
+      )
+{
+   enum TN_RCode rc = _check_param_data(exch, data_tgt);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      memcpy(data_tgt, exch->data, exch->size);
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
+
@@ -0,0 +1,457 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Exchange.
+ *
+ * Exchange is a kernel object which holds a value of fixed size, and
+ * delivers it to any number of consumers each time the value is written.
+ * It is useful for broadcast state updates: instead of sending the same data
+ * to N queues one by one (and having a window in which some consumers
+ * already got new value and others didn't), the writer just calls
+ * `tn_exch_write()` once.
+ *
+ * Consumers are represented by exchange links, which are added to the
+ * exchange by `tn_exch_link_add()`. There are three types of links:
+ *
+ * - \ref tn_exch_link_queue.h "queue link": a copy of the value is put into
+ *   a block allocated from the \ref tn_fmem.h "fixed memory pool", and
+ *   pointer to the block is sent to the \ref tn_dqueue.h "queue". The
+ *   receiver should release the block to the pool after it's done with it.
+ *   If the value fits in the `void *`, memory pool may be omitted: then, the
+ *   value itself is sent to the queue.
+ * - \ref tn_exch_link_event.h "event link": flag(s) are set in the \ref
+ *   tn_eventgrp.h "event group".
+ * - \ref tn_exch_link_callback.h "callback link": user-provided function is
+ *   called.
+ *
+ * The value is written and all the links are notified with interrupts
+ * disabled, in a single critical section, so, all the consumers observe the
+ * same sequence of values. The tasks which are woken up by the links (say,
+ * the task that waits for the message from the linked queue) start running
+ * after that, if their priority is higher than that of the writer.
+ *
+ * Links never block: if some queue link can't deliver the value (the memory
+ * pool is exhausted or the queue is full), the value is dropped for this
+ * link only, others are notified anyway, and `tn_exch_write()` returns
+ * `#TN_RC_TIMEOUT`.
+ *
+ * The most recently written value can be read at any time by
+ * `tn_exch_read()`.
+ *
+ * Example:
+ *
+ * \code{.c}
+ * #include "tn.h"
+ *
+ * //-- type of data that exchange object stores
+ * struct MyState {
+ *    int speed;
+ *    int temperature;
+ * };
+ *
+ * //-- exchange object and its data buffer
+ * TN_EXCH_DATA_BUF_DEF(my_exch_buf, struct MyState);
+ * struct TN_Exch my_exch;
+ *
+ * //-- consumer that receives state updates by the queue
+ * TN_FMEM_BUF_DEF(my_fmem_buf, struct MyState, 4);
+ * struct TN_FMem my_fmem;
+ * void *my_queue_buf[4];
+ * struct TN_DQueue my_queue;
+ * struct TN_ExchLinkQueue my_link_queue;
+ *
+ * //-- consumer that is notified by the event flag
+ * struct TN_EventGrp my_eventgrp;
+ * struct TN_ExchLinkEvent my_link_event;
+ *
+ * #define MY_EVENT_STATE_UPDATED   (1 << 0)
+ *
+ * void init(void)
+ * {
+ *    struct MyState initial = {0};
+ *
+ *    tn_exch_create(
+ *          &my_exch, my_exch_buf, TN_MAKE_ALIG_SIZE(sizeof(struct MyState))
+ *          );
+ *    tn_exch_write(&my_exch, &initial);
+ *
+ *    tn_fmem_create(
+ *          &my_fmem, my_fmem_buf,
+ *          TN_MAKE_ALIG_SIZE(sizeof(struct MyState)), 4
+ *          );
+ *    tn_queue_create(&my_queue, my_queue_buf, 4);
+ *    tn_exch_link_queue_create(&my_link_queue, &my_queue, &my_fmem);
+ *    tn_exch_link_add(
+ *          &my_exch, tn_exch_link_queue_base_get(&my_link_queue)
+ *          );
+ *
+ *    tn_eventgrp_create(&my_eventgrp, 0);
+ *    tn_exch_link_event_create(
+ *          &my_link_event, &my_eventgrp, MY_EVENT_STATE_UPDATED
+ *          );
+ *    tn_exch_link_add(
+ *          &my_exch, tn_exch_link_event_base_get(&my_link_event)
+ *          );
+ * }
+ *
+ * void producer(struct MyState *new_state)
+ * {
+ *    //-- both consumers are notified at once
+ *    tn_exch_write(&my_exch, new_state);
+ * }
+ *
+ * void consumer_by_queue(void)
+ * {
+ *    struct MyState *p_state;
+ *    tn_queue_receive(&my_queue, (void **)&p_state, TN_WAIT_INFINITE);
+ *
+ *    // ... handle *p_state ...
+ *
+ *    tn_fmem_release(&my_fmem, p_state);
+ * }
+ *
+ * void consumer_by_event(void)
+ * {
+ *    struct MyState state;
+ *    tn_eventgrp_wait(
+ *          &my_eventgrp, MY_EVENT_STATE_UPDATED,
+ *          TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AUTOCLR,
+ *          TN_NULL, TN_WAIT_INFINITE
+ *          );
+ *
+ *    //-- several updates might have happened; get the latest one
+ *    tn_exch_read(&my_exch, &state);
+ *
+ *    // ... handle state ...
+ * }
+ * \endcode
+ *
+ */
+
+
+#ifndef _TN_EXCH_H
+#define _TN_EXCH_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_sys.h"
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_ExchLink;
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Exchange
+ */
+struct TN_Exch {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_exch;
+   ///
+   /// List of all added links (`struct #TN_ExchLink`)
+   struct TN_ListItem links_list;
+   ///
+   /// Pointer to actual exchange data
+   void *data;
+   ///
+   /// Size of the exchange data in bytes, should be a multiple of
+   /// `sizeof(#TN_UWord)`
+   unsigned int size;
+};
+
+
+
+/*******************************************************************************
+ *    GLOBAL VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for data. See
+ * `tn_exch_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_exch_create()` function as the `data` argument)
+ * @param item_type
+ *    Type of the exchange data, like `struct MyExchangeData`.
+ */
+#define TN_EXCH_DATA_BUF_DEF(name, item_type)                     \
+   TN_UWord name[                                                 \
+      (TN_MAKE_ALIG_SIZE(sizeof(item_type)) / sizeof(TN_UWord))   \
+   ]
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the exchange object. `id_exch` field should not contain
+ * `#TN_ID_EXCHANGE`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * Note that `data` and `size` should be a multiple of `sizeof(#TN_UWord)`.
+ *
+ * For the definition of buffer, convenience macro `TN_EXCH_DATA_BUF_DEF()`
+ * was invented.
+ *
+ * Typical definition looks as follows:
+ *
+ * \code{.c}
+ *     //-- type of data that exchange object stores
+ *     struct MyExchangeData {
+ *        // ... arbitrary fields ...
+ *     };
+ *     
+ *     //-- define buffer for the exchange data
+ *     TN_EXCH_DATA_BUF_DEF(my_exch_buf, struct MyExchangeData);
+ *
+ *     //-- define exchange structure
+ *     struct TN_Exch my_exch;
+ * \endcode
+ *
+ * And then, construct your `my_exch` as follows:
+ *
+ * \code{.c}
+ *     enum TN_RCode rc;
+ *     rc = tn_exch_create( &my_exch,
+ *                          my_exch_buf,
+ *                          TN_MAKE_ALIG_SIZE(sizeof(struct MyExchangeData))
+ *                        );
+ *     if (rc != TN_RC_OK){
+ *        //-- handle error
+ *     }
+ * \endcode
+ *
+ * Initial contents of the buffer become initial value of the exchange.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch
+ *    Pointer to already allocated `struct TN_Exch`
+ * @param data
+ *    Pointer to already allocated exchange data buffer, it must be aligned
+ *    properly (see `TN_MAKE_ALIG_SIZE()`)
+ * @param size
+ *    Size of the exchange data buffer in bytes, must be a multiple of
+ *    `sizeof(#TN_UWord)`
+ *
+ * @return 
+ *    * `#TN_RC_OK` if exchange object was successfully created;
+ *    * `#TN_RC_WPARAM` if wrong params were given.
+ */
+enum TN_RCode tn_exch_create(
+      struct TN_Exch   *exch,
+      void             *data,
+      unsigned int      size
+      );
+
+/**
+ * Destruct the exchange object. All the links are removed from it (but not
+ * deleted: they can be added to another exchange).
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch     exchange object to destruct
+ *
+ * @return 
+ *    * `#TN_RC_OK` if object was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_delete(struct TN_Exch *exch);
+
+/**
+ * Add link to the exchange: after that, link is notified each time the
+ * exchange is written. Links are notified in the order they were added.
+ *
+ * Link should be already constructed by the function like
+ * `tn_exch_link_queue_create()`, and it should not be added to any exchange.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch
+ *    Exchange to add link to
+ * @param exch_link
+ *    Link to add; use functions like `tn_exch_link_queue_base_get()` to get
+ *    it from the particular link type.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was added;
+ *    * `#TN_RC_WSTATE` if link is already added to some exchange;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_add(
+      struct TN_Exch       *exch,
+      struct TN_ExchLink   *exch_link
+      );
+
+/**
+ * Remove link from the exchange.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch
+ *    Exchange to remove link from
+ * @param exch_link
+ *    Link to remove
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was removed;
+ *    * `#TN_RC_WSTATE` if link isn't added to the given exchange;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_remove(
+      struct TN_Exch       *exch,
+      struct TN_ExchLink   *exch_link
+      );
+
+/**
+ * Write new value to the exchange, and notify all its links. Everything is
+ * done in a single critical section.
+ *
+ * Note that \ref tn_exch_link_callback.h "callback links" are called from
+ * this function, with interrupts disabled.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch
+ *    Exchange to write to
+ * @param data
+ *    Pointer to new value, its size should be equal to the `size` given to
+ *    `tn_exch_create()`.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if value was written and all links were notified;
+ *    * `#TN_RC_TIMEOUT` if value was written, but some of the \ref
+ *      tn_exch_link_queue.h "queue links" failed to deliver it (there was no
+ *      free memory block or the queue was full);
+ *    * Other return code from the link which failed to deliver value.
+ *      Anyway, value is written, and other links are notified;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_write(
+      struct TN_Exch   *exch,
+      const void       *data
+      );
+
+/**
+ * The same as `tn_exch_write()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_exch_iwrite(
+      struct TN_Exch   *exch,
+      const void       *data
+      );
+
+/**
+ * Read current value of the exchange.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch
+ *    Exchange to read from
+ * @param data_tgt
+ *    Pointer to the buffer to store value to, its size should be equal to
+ *    the `size` given to `tn_exch_create()`.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if value was read;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_read(
+      struct TN_Exch   *exch,
+      void             *data_tgt
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_EXCH_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright  2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright  2013, 2014 Anders Montonen.
- *    TNeo:                      copyright  2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -52,11 +52,6 @@
 
 
 
-/*******************************************************************************
- *    PUBLIC DATA
- ******************************************************************************/
-
-
 /*******************************************************************************
  *    PRIVATE FUNCTION PROTOTYPES
  ******************************************************************************/
@@ -77,15 +72,6 @@ static const struct TN_ExchLink_VTable _vtable = {
    .notify     = _notify_error,
    .dtor       = _dtor,
 };
-//static TN_BOOL _vtable_initialized = TN_FALSE;
-
-
-
-
-/*******************************************************************************
- *    DEFINITIONS
- ******************************************************************************/
-
 
 
 
@@ -96,8 +82,8 @@ static const struct TN_ExchLink_VTable _vtable = {
 
 //-- Additional param checking {{{
 #if TN_CHECK_PARAM
-static inline enum TN_RCode _check_param_generic(
-      struct TN_ExchLink *exch_link
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_ExchLink *exch_link
       )
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -111,8 +97,8 @@ static inline enum TN_RCode _check_param_generic(
    return rc;
 }
 
-static inline enum TN_RCode _check_param_create(
-      struct TN_ExchLink  *exch_link
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_ExchLink *exch_link
       )
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -134,32 +120,19 @@ static inline enum TN_RCode _check_param_create(
 
 static enum TN_RCode _notify_error(struct TN_ExchLink *exch_link)
 {
-   //-- should never be here
+   //-- should never be here: each particular link overrides notify()
    _TN_FATAL_ERROR("called notify() of base TN_ExchLink");
+
+   _TN_UNUSED(exch_link);
    return TN_RC_INTERNAL;
 }
 
 static enum TN_RCode _dtor(struct TN_ExchLink *exch_link)
 {
-   exch_link->id_exch_link = 0;  //-- exchange link does not exist now
+   exch_link->id_exch_link = TN_ID_NONE;  //-- exchange link does not exist now
    return TN_RC_OK;
 }
 
-#if 0
-static void _vtable_init()
-{
-   if (!_vtable_initialized){
-      _vtable.notify    = _notify_error;
-      _vtable.dtor      = _dtor;
-
-      _vtable_initialized = TN_TRUE;
-   }
-}
-#endif
-
-
-
-
 
 
 
@@ -167,18 +140,17 @@ static void _vtable_init()
  *    PROTECTED FUNCTIONS
  ******************************************************************************/
 
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the header file (_tn_exch_link.h)
  */
 const struct TN_ExchLink_VTable *_tn_exch_link_vtable(void)
 {
-   //_vtable_init();
    return &_vtable;
 }
 
 
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the header file (_tn_exch_link.h)
  */
 enum TN_RCode _tn_exch_link_create(
       struct TN_ExchLink     *exch_link
@@ -189,8 +161,8 @@ enum TN_RCode _tn_exch_link_create(
    if (rc != TN_RC_OK){
       //-- just return rc as it is
    } else {
-      //_vtable_init();
       exch_link->vtable = &_vtable;
+      exch_link->exch   = TN_NULL;
 
       _tn_list_reset(&(exch_link->links_list_item));
 
@@ -201,28 +173,22 @@ enum TN_RCode _tn_exch_link_create(
 }
 
 
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the header file (_tn_exch_link.h)
  */
 enum TN_RCode _tn_exch_link_notify(
       struct TN_ExchLink     *exch_link
       )
 {
-   enum TN_RCode rc = _check_param_generic(exch_link);
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
-   if (rc != TN_RC_OK){
-      //-- just return rc as it is
-   } else {
-      rc = exch_link->vtable->notify(exch_link);
-   }
-
-   return rc;
+   return exch_link->vtable->notify(exch_link);
 }
 
 
-
-/**
- * See comments in the _tn_exch_link.h file
+/*
+ * See comments in the header file (_tn_exch_link.h)
  */
 enum TN_RCode _tn_exch_link_delete(
       struct TN_ExchLink     *exch_link
@@ -233,11 +199,22 @@ enum TN_RCode _tn_exch_link_delete(
    if (rc != TN_RC_OK){
       //-- just return rc as it is
    } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- if link is added to some exchange, remove it from there
+      if (exch_link->exch != TN_NULL){
+         _tn_list_remove_entry(&(exch_link->links_list_item));
+         exch_link->exch = TN_NULL;
+      }
+
       rc = exch_link->vtable->dtor(exch_link);
+
+      TN_INT_RESTORE();
    }
 
    return rc;
 }
 
 
-
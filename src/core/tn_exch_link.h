@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright © 2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright © 2013, 2014 Anders Montonen.
- *    TNeo:                      copyright © 2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -37,10 +37,13 @@
 /**
  * \file
  *
- * Exchange link (in terms of OOP, it's an "abstract class" of any exchange
- * link).
+ * Exchange link: base structure of any link of the \ref tn_exch.h
+ * "exchange" (in terms of OOP, it's an "abstract class").
  *
- * For internal kernel usage only.
+ * Application never creates `struct #TN_ExchLink` directly: it creates some
+ * particular link instead (see \ref tn_exch_link_queue.h "queue link", \ref
+ * tn_exch_link_event.h "event link", \ref tn_exch_link_callback.h "callback
+ * link"), and gives its base structure to `tn_exch_link_add()`.
  *
  */
 
@@ -62,6 +65,14 @@
 extern "C"  {     /*}*/
 #endif
 
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_Exch;
+
+
+
 /*******************************************************************************
  *    PUBLIC TYPES
  ******************************************************************************/
@@ -70,18 +81,19 @@ struct TN_ExchLink;
 
 
 /**
- * Virtual method prototype: notify.
+ * Virtual method prototype: notify. Called by the exchange with interrupts
+ * disabled, after new value is written.
  *
  * For internal kernel usage only.
  */
-typedef enum TN_RCode (TN_ExchLink_Notify)(struct TN_ExchLink *exch);
+typedef enum TN_RCode (TN_ExchLink_Notify)(struct TN_ExchLink *exch_link);
 
 /**
  * Virtual method prototype: destructor.
  *
  * For internal kernel usage only.
  */
-typedef enum TN_RCode (TN_ExchLink_Dtor)  (struct TN_ExchLink *exch);
+typedef enum TN_RCode (TN_ExchLink_Dtor)  (struct TN_ExchLink *exch_link);
 
 /**
  * Virtual methods table for each type of \ref tn_exch.h "exchange" link. 
@@ -99,6 +111,11 @@ struct TN_ExchLink_VTable {
  * For internal kernel usage only.
  */
 struct TN_ExchLink {
+   ///
+   /// Id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_exch_link;
    ///
    /// A list item to be included in the exchange links list
    struct TN_ListItem links_list_item;
@@ -109,9 +126,6 @@ struct TN_ExchLink {
    ///
    /// Pointer to the virtual methods table
    const struct TN_ExchLink_VTable *vtable;
-   ///
-   /// Id for object validity verification
-   enum TN_ObjId              id_exch_link;
 };
 
 
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Exchange link: callback (in terms of OOP, it's a "class, inherited from
+ * `#TN_ExchLink`").
+ *
+ * When new value is written to the \ref tn_exch.h "exchange", the callback
+ * link calls user-provided function and gives the value to it.
+ *
+ * \attention The callback is called from `tn_exch_write()` or
+ * `tn_exch_iwrite()` with interrupts disabled, so it should be as short as
+ * possible, and it must not call any kernel services except the
+ * ones which are callable from ISR, and it must not access the exchange
+ * itself.
+ *
+ */
+
+
+#ifndef _TN_EXCH_LINK_CALLBACK_H
+#define _TN_EXCH_LINK_CALLBACK_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_exch_link.h"
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+struct TN_Exch;
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Prototype of the function which is called by the callback link.
+ *
+ * @param exch
+ *    Exchange which is written
+ * @param data
+ *    New value of the exchange
+ * @param size
+ *    Size of the value in bytes
+ * @param p_user_data
+ *    User data given to `tn_exch_link_callback_create()`
+ */
+typedef void (TN_ExchCallbackFunc)(
+      struct TN_Exch   *exch,
+      const void       *data,
+      unsigned int      size,
+      void             *p_user_data
+      );
+
+/**
+ * Exchange link which calls user-provided function.
+ */
+struct TN_ExchLinkCallback {
+   ///
+   /// Exchange link: in terms of OOP, it's a superclass (or base class)
+   struct TN_ExchLink super;
+   ///
+   /// Function to call
+   TN_ExchCallbackFunc *func;
+   ///
+   /// User data to be given to callback function
+   void *p_user_data;
+};
+
+
+
+/*******************************************************************************
+ *    GLOBAL VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the callback link. `id_exch_link` field of the base structure
+ * should not contain `#TN_ID_EXCHANGE_LINK`, otherwise, `#TN_RC_WPARAM` is
+ * returned.
+ *
+ * After that, the link should be added to the exchange by
+ * `tn_exch_link_add()`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_callback
+ *    Pointer to already allocated `struct TN_ExchLinkCallback`
+ * @param func
+ *    Function to call when new value is written, see `#TN_ExchCallbackFunc`
+ * @param p_user_data
+ *    Arbitrary user data to be given to `func`
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, `#TN_RC_WPARAM` if wrong params
+ *      were given.
+ */
+enum TN_RCode tn_exch_link_callback_create(
+      struct TN_ExchLinkCallback   *exch_link_callback,
+      TN_ExchCallbackFunc          *func,
+      void                         *p_user_data
+      );
+
+/**
+ * Destruct the callback link. If it is added to some exchange, it is removed
+ * from there.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_callback
+ *    Link to destruct
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully deleted;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_callback_delete(
+      struct TN_ExchLinkCallback   *exch_link_callback
+      );
+
+/**
+ * Returns base link structure, which should be given to `tn_exch_link_add()`
+ * and `tn_exch_link_remove()`.
+ */
+_TN_STATIC_INLINE struct TN_ExchLink *tn_exch_link_callback_base_get(
+      struct TN_ExchLinkCallback   *exch_link_callback
+      )
+{
+   return &exch_link_callback->super;
+}
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_EXCH_LINK_CALLBACK_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Exchange link: event (in terms of OOP, it's a "class, inherited from
+ * `#TN_ExchLink`").
+ *
+ * When new value is written to the \ref tn_exch.h "exchange", the event link
+ * sets flag(s) in the \ref tn_eventgrp.h "event group". The value itself is
+ * not delivered: the task which waits for the flag(s) typically clears them
+ * (say, by `#TN_EVENTGRP_WMODE_AUTOCLR`) and then gets the latest value by
+ * `tn_exch_read()`. So, if the exchange is written several times before the
+ * task gets to it, intermediate values are skipped.
+ *
+ * The event group should not be deleted while the link is added to the
+ * exchange.
+ *
+ */
+
+
+#ifndef _TN_EXCH_LINK_EVENT_H
+#define _TN_EXCH_LINK_EVENT_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_exch_link.h"
+#include "tn_eventgrp.h"
+
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Exchange link which sets flag(s) in the event group.
+ */
+struct TN_ExchLinkEvent {
+   ///
+   /// Exchange link: in terms of OOP, it's a superclass (or base class)
+   struct TN_ExchLink super;
+   ///
+   /// Event group and flags pattern to set in it
+   struct TN_EGrpLink eventgrp_link;
+};
+
+
+
+/*******************************************************************************
+ *    GLOBAL VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the event link. `id_exch_link` field of the base structure
+ * should not contain `#TN_ID_EXCHANGE_LINK`, otherwise, `#TN_RC_WPARAM` is
+ * returned.
+ *
+ * After that, the link should be added to the exchange by
+ * `tn_exch_link_add()`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_event
+ *    Pointer to already allocated `struct TN_ExchLinkEvent`
+ * @param eventgrp
+ *    Event group to set flag(s) in
+ * @param pattern
+ *    Flags pattern to set, can't be 0.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, `#TN_RC_WPARAM` if wrong params
+ *      were given.
+ */
+enum TN_RCode tn_exch_link_event_create(
+      struct TN_ExchLinkEvent   *exch_link_event,
+      struct TN_EventGrp        *eventgrp,
+      TN_UWord                   pattern
+      );
+
+/**
+ * Destruct the event link. If it is added to some exchange, it is removed
+ * from there.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param exch_link_event
+ *    Link to destruct
+ *
+ * @return 
+ *    * `#TN_RC_OK` if link was successfully deleted;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_exch_link_event_delete(
+      struct TN_ExchLinkEvent   *exch_link_event
+      );
+
+/**
+ * Returns base link structure, which should be given to `tn_exch_link_add()`
+ * and `tn_exch_link_remove()`.
+ */
+_TN_STATIC_INLINE struct TN_ExchLink *tn_exch_link_event_base_get(
+      struct TN_ExchLinkEvent   *exch_link_event
+      )
+{
+   return &exch_link_event->super;
+}
+
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_EXCH_LINK_EVENT_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
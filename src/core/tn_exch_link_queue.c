@@ -2,9 +2,9 @@
  *
  * TNeo: real-time kernel initially based on TNKernel
  *
- *    TNKernel:                  copyright  2004, 2013 Yuri Tiomkin.
- *    PIC32-specific routines:   copyright  2013, 2014 Anders Montonen.
- *    TNeo:                      copyright  2014       Dmitry Frank.
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
  *
  *    TNeo was born as a thorough review and re-implementation of
  *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
@@ -42,8 +42,6 @@
 #include "tn_common.h"
 #include "tn_sys.h"
 
-#include "tn_exch.h"
-
 //-- internal tnkernel headers
 #include "_tn_exch_link.h"
 #include "_tn_dqueue.h"
@@ -53,11 +51,12 @@
 //-- header of current module
 #include "tn_exch_link_queue.h"
 
+//-- header of other needed modules
+#include "tn_exch.h"
 
+//-- std header for memcpy()
+#include <string.h>
 
-/*******************************************************************************
- *    PUBLIC DATA
- ******************************************************************************/
 
 
 /*******************************************************************************
@@ -89,7 +88,7 @@ static const struct TN_ExchLink_VTable _vtable = {
  ******************************************************************************/
 
 #define _tn_get_exch_link_queue_by_exch_link(exch_link)                       \
-   (exch_link ? container_of(exch_link, struct TN_ExchLinkQueue, super) : 0)
+   container_of(exch_link, struct TN_ExchLinkQueue, super)
 
 
 
@@ -101,19 +100,19 @@ static const struct TN_ExchLink_VTable _vtable = {
 
 //-- Additional param checking {{{
 #if TN_CHECK_PARAM
-static inline enum TN_RCode _check_param_create(
-      struct TN_ExchLinkQueue   *exch_link_queue,
-      struct TN_DQueue          *queue,
-      struct TN_FMem            *fmem
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_ExchLinkQueue *exch_link_queue,
+      const struct TN_DQueue        *queue,
+      const struct TN_FMem          *fmem
       )
 {
    enum TN_RCode rc = TN_RC_OK;
 
-   if (exch_link_queue == TN_NULL){
+   if (exch_link_queue == TN_NULL || queue == TN_NULL){
       rc = TN_RC_WPARAM;
    } else if (!_tn_dqueue_is_valid(queue)){
       rc = TN_RC_WPARAM;
-   } else if (!_tn_fmem_is_valid(fmem)){
+   } else if (fmem != TN_NULL && !_tn_fmem_is_valid(fmem)){
       rc = TN_RC_WPARAM;
    }
 
@@ -121,11 +120,15 @@ static inline enum TN_RCode _check_param_create(
 }
 
 #else
-#  define _check_param_create(exch_link)        (TN_RC_OK)
+#  define _check_param_create(exch_link_queue, queue, fmem)    (TN_RC_OK)
 #endif
 // }}}
 
 
+/**
+ * Implementation of `notify()` virtual method: allocate memory block (if
+ * needed), copy exchange value there, and send it to the queue.
+ */
 static enum TN_RCode _notify(struct TN_ExchLink *exch_link)
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -133,57 +136,65 @@ static enum TN_RCode _notify(struct TN_ExchLink *exch_link)
    struct TN_ExchLinkQueue *exch_link_queue = 
       _tn_get_exch_link_queue_by_exch_link(exch_link);
 
+   struct TN_Exch *exch = exch_link->exch;
+   struct TN_FMem *fmem = exch_link_queue->fmem;
+
    void *p_msg = TN_NULL;
 
-   rc = tn_is_task_context()
-      ? tn_fmem_get(exch_link_queue->fmem, &p_msg, TN_WAIT_INFINITE)
-      : tn_fmem_iget_polling(exch_link_queue->fmem, &p_msg);
+   if (fmem == TN_NULL){
+      //-- no memory pool: the value should fit in the pointer itself
+      if (exch->size != sizeof(TN_UWord)){
+         rc = TN_RC_WPARAM;
+      } else {
+         p_msg = (void *)(*(TN_UWord *)exch->data);
+      }
+   } else if (fmem->block_size < exch->size){
+      rc = TN_RC_WPARAM;
+   } else {
+      rc = _tn_fmem_get(fmem, &p_msg);
+
+      if (rc == TN_RC_OK){
+         //-- memory was received from fixed memory pool, copy data there
+         memcpy(p_msg, exch->data, exch->size);
+      }
+   }
 
    if (rc != TN_RC_OK){
       //-- there was some error: just return rc as it is
    } else {
-      //-- memory was received from fixed-memory pool, copy data there
-      _tn_memcpy_uword(
-            p_msg,
-            exch_link->exch->data,
-            _TN_SIZE_BYTES_TO_UWORDS(exch_link->exch->size)
-            );
-
       //-- put it to the queue
-      rc = tn_is_task_context()
-         ? tn_queue_send(exch_link_queue->queue, p_msg, TN_WAIT_INFINITE)
-         : tn_queue_isend_polling(exch_link_queue->queue, p_msg);
-      if (rc != TN_RC_OK){
+      rc = _tn_queue_send_polling(exch_link_queue->queue, p_msg);
+
+      if (rc != TN_RC_OK && fmem != TN_NULL){
          //-- there was some error while sending the message,
-         //   so before we return, we should free buffer that we've allocated
-         rc = tn_is_task_context()
-            ? tn_fmem_release(exch_link_queue->fmem, p_msg)
-            : tn_fmem_irelease(exch_link_queue->fmem, p_msg);
-      } else {
-         //-- everything is fine, so, leave rc = TN_RC_OK
+         //   so before we return, we should free buffer that we've
+         //   allocated. Return code of the send is preserved.
+         _tn_fmem_release(fmem, p_msg);
       }
-
    }
 
    return rc;
 }
 
+/**
+ * Implementation of `dtor()` virtual method
+ */
 static enum TN_RCode _dtor(struct TN_ExchLink *exch_link)
 {
-   //-- just call desctructor of superclass
+   //-- just call destructor of superclass
    return _tn_exch_link_vtable()->dtor(exch_link);
 }
 
 
 
 
-
-
-
 /*******************************************************************************
  *    PUBLIC FUNCTIONS
  ******************************************************************************/
 
+/*
+ * See comments in the header file (tn_exch_link_queue.h)
+ */
 enum TN_RCode tn_exch_link_queue_create(
       struct TN_ExchLinkQueue   *exch_link_queue,
       struct TN_DQueue          *queue,
@@ -210,6 +221,9 @@ enum TN_RCode tn_exch_link_queue_create(
    return rc;
 }
 
+/*
+ * See comments in the header file (tn_exch_link_queue.h)
+ */
 enum TN_RCode tn_exch_link_queue_delete(
       struct TN_ExchLinkQueue   *exch_link_queue
       )
@@ -218,4 +232,3 @@ enum TN_RCode tn_exch_link_queue_delete(
 }
 
 
-
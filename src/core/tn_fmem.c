@@ -130,11 +130,29 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
 
    return rc;
 }
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_multi(
+      const struct TN_FMem *fmem,
+      const struct TN_FMemChain *chain,
+      int cnt
+      )
+{
+   enum TN_RCode rc = _check_param_job_perform(fmem, (void *)chain);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (cnt < 0){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
 #else
 #  define _check_param_fmem_create(fmem)               (TN_RC_OK)
 #  define _check_param_fmem_delete(fmem)               (TN_RC_OK)
 #  define _check_param_job_perform(fmem, p_data)       (TN_RC_OK)
 #  define _check_param_generic(fmem)                   (TN_RC_OK)
+#  define _check_param_multi(fmem, chain, cnt)         (TN_RC_OK)
 #endif
 // }}}
 
@@ -259,6 +277,126 @@ _TN_STATIC_INLINE enum TN_RCode _fmem_release(struct TN_FMem *fmem, void *p_data
    return rc;
 }
 
+/**
+ * Try to allocate up to `cnt` memory blocks from the pool at once.
+ *
+ * Free blocks are cut from the head of the free list as a whole: the free
+ * list is walked just to find the last block to take, and the blocks are
+ * not relinked.
+ *
+ * @param fmem
+ *    Memory pool from which blocks should be taken
+ * @param chain
+ *    Chain to append taken blocks to (it might be non-empty already)
+ * @param cnt
+ *    Maximum number of blocks to take
+ *
+ * @return
+ *    - `#TN_RC_OK`, if at least one block was taken, or `cnt` is 0;
+ *    - `#TN_RC_TIMEOUT`, if there are no free blocks.
+ */
+static enum TN_RCode _fmem_get_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain,
+      int cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (cnt == 0){
+      //-- nothing to take: succeed at once, even if there are no free
+      //   blocks (so that the caller doesn't wait)
+   } else if (fmem->free_blocks_cnt == 0){
+      //-- There are no free memory blocks.
+      rc = TN_RC_TIMEOUT;
+   } else {
+      void *head = fmem->free_list;
+      void *tail = head;
+      int i;
+
+      if (cnt > fmem->free_blocks_cnt){
+         cnt = fmem->free_blocks_cnt;
+      }
+
+      //-- find the last block to take
+      for (i = 1; i < cnt; i++){
+         tail = *(void **)tail;
+      }
+
+      //-- cut blocks from the free list
+      fmem->free_list = *(void **)tail;
+      fmem->free_blocks_cnt -= cnt;
+
+      //-- and append them to the chain
+      *(void **)tail = TN_NULL;
+      if (chain->tail == TN_NULL){
+         chain->head = head;
+      } else {
+         *(void **)chain->tail = head;
+      }
+      chain->tail = tail;
+      chain->cnt += cnt;
+   }
+
+   return rc;
+}
+
+/**
+ * Return the chain of memory blocks to the pool at once.
+ *
+ * First of all, tasks that wait for free block (if any) get one block each.
+ * The rest of the chain is spliced to the head of the free list in O(1): the
+ * tail of the chain is just linked to the old head of the free list.
+ *
+ * @param fmem
+ *    Memory pool
+ * @param chain
+ *    Chain of memory blocks to release; it becomes empty on success.
+ *
+ * @return
+ *    - `#TN_RC_OK`, if operation was successful
+ *    - `#TN_RC_OVERFLOW`, if memory pool hasn't enough room for the blocks
+ *      (nothing is released then). This may never happen in normal program
+ *      execution; if that happens, it's a programmer's mistake.
+ */
+static enum TN_RCode _fmem_release_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   //-- if there are waiting tasks, there are no free blocks, so it's enough
+   //   to check the room just once, before giving blocks to the tasks
+   if (fmem->free_blocks_cnt + chain->cnt > fmem->blocks_cnt){
+      rc = TN_RC_OVERFLOW;
+   } else {
+      //-- give one block to each waiting task, while there are blocks
+      while (
+            chain->head != TN_NULL
+            && _tn_task_first_wait_complete(
+               &fmem->wait_queue, TN_RC_OK,
+               _cb_before_task_wait_complete, chain->head, TN_NULL
+               )
+            )
+      {
+         chain->head = *(void **)chain->head;
+         chain->cnt--;
+      }
+
+      //-- splice the rest of the chain to the free list
+      if (chain->head != TN_NULL){
+         *(void **)chain->tail = fmem->free_list;
+         fmem->free_list = chain->head;
+         fmem->free_blocks_cnt += chain->cnt;
+      }
+
+      tn_fmem_chain_reset(chain);
+   }
+
+   return rc;
+}
+
 
 
 
@@ -270,8 +408,9 @@ _TN_STATIC_INLINE enum TN_RCode _fmem_release(struct TN_FMem *fmem, void *p_data
 /*
  * See comments in the header file (tn_dqueue.h)
  */
-enum TN_RCode tn_fmem_create(
+enum TN_RCode tn_fmem_create_wattr(
       struct TN_FMem   *fmem,
+      enum TN_FMemAttr  attr,
       void             *start_addr,
       unsigned int      block_size,
       int               blocks_cnt
@@ -316,6 +455,12 @@ enum TN_RCode tn_fmem_create(
    fmem->start_addr = start_addr;
    fmem->block_size = block_size;
    fmem->blocks_cnt = blocks_cnt;
+#if TN_USE_PRIO_WAIT_QUEUES
+   fmem->attr       = attr;
+   _tn_list_prio_idx_reset(&(fmem->wait_queue_prio));
+#else
+   _TN_UNUSED(attr);
+#endif
 
    //-- reset wait_queue
    _tn_list_reset(&(fmem->wait_queue));
@@ -403,8 +548,9 @@ enum TN_RCode tn_fmem_get(
       rc = _fmem_get(fmem, p_data);
 
       if (rc == TN_RC_TIMEOUT && timeout > 0){
-         _tn_task_curr_to_wait_action(
+         _tn_task_curr_to_wait_action_wprio(
                &(fmem->wait_queue),
+               _tn_fmem_wait_queue_prio(fmem),
                TN_WAIT_REASON_WFIXMEM,
                timeout
                );
@@ -529,6 +675,157 @@ enum TN_RCode tn_fmem_irelease(struct TN_FMem *fmem, void *p_data)
    return rc;
 }
 
+/*
+ * See comments in the header file (tn_fmem.h)
+ */
+enum TN_RCode tn_fmem_get_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain,
+      int cnt,
+      TN_TickCnt timeout
+      )
+{
+   TN_BOOL waited_for_data = TN_FALSE;
+   enum TN_RCode rc = _check_param_multi(fmem, chain, cnt);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      tn_fmem_chain_reset(chain);
+
+      TN_INT_DIS_SAVE();
+
+      rc = _fmem_get_multi(fmem, chain, cnt);
+
+      if (rc == TN_RC_TIMEOUT && timeout > 0){
+         _tn_task_curr_to_wait_action_wprio(
+               &(fmem->wait_queue),
+               _tn_fmem_wait_queue_prio(fmem),
+               TN_WAIT_REASON_WFIXMEM,
+               timeout
+               );
+         waited_for_data = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+      if (waited_for_data){
+
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+
+         if (rc == TN_RC_OK){
+            //-- we've got the first block; put it to the chain and take
+            //   as many more free blocks as available, without waiting.
+            //   (the pool might be deleted in the meantime, so check it)
+            tn_fmem_chain_push(
+                  chain, _tn_curr_run_task->subsys_wait.fmem.data_elem
+                  );
+
+            TN_INT_DIS_SAVE();
+            if (cnt > 1 && _tn_fmem_is_valid(fmem)){
+               _fmem_get_multi(fmem, chain, cnt - 1);
+            }
+            TN_INT_RESTORE();
+         }
+      }
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_fmem.h)
+ */
+enum TN_RCode tn_fmem_iget_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain,
+      int cnt
+      )
+{
+   enum TN_RCode rc = _check_param_multi(fmem, chain, cnt);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      tn_fmem_chain_reset(chain);
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _fmem_get_multi(fmem, chain, cnt);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_fmem.h)
+ */
+enum TN_RCode tn_fmem_release_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain
+      )
+{
+   enum TN_RCode rc = _check_param_multi(fmem, chain, 0);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _fmem_release_multi(fmem, chain);
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_fmem.h)
+ */
+enum TN_RCode tn_fmem_irelease_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain
+      )
+{
+   enum TN_RCode rc = _check_param_multi(fmem, chain, 0);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _fmem_release_multi(fmem, chain);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
 /*
  * See comments in the header file (tn_dqueue.h)
  */
@@ -564,3 +861,33 @@ int tn_fmem_used_blocks_cnt_get(struct TN_FMem *fmem)
    return ret;
 }
 
+
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the file _tn_fmem.h
+ */
+enum TN_RCode _tn_fmem_get(struct TN_FMem *fmem, void **p_data)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   return _fmem_get(fmem, p_data);
+}
+
+/*
+ * See comments in the file _tn_fmem.h
+ */
+enum TN_RCode _tn_fmem_release(struct TN_FMem *fmem, void *p_data)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   return _fmem_release(fmem, p_data);
+}
+
@@ -48,6 +48,12 @@
  *
  * The operations of getting the block from memory pool and releasing it back
  * take O(1) time independently of number or size of the blocks.
+ *
+ * If blocks are allocated and freed in batches (say, packet buffers of the
+ * networking stack), use `tn_fmem_get_multi()` and `tn_fmem_release_multi()`:
+ * they take (give back) the whole batch in a single critical section. The
+ * batch is represented as a chain of blocks, see `struct #TN_FMemChain`;
+ * releasing of a chain just splices it to the pool's free list in O(1).
  *   
  * For the useful pattern on how to use fixed memory pool together with \ref
  * tn_dqueue.h "queue", refer to the example: `examples/queue`. Be sure to
@@ -63,6 +69,7 @@
 
 #include "tn_list.h"
 #include "tn_common.h"
+#include "tn_sys.h"
 
 
 
@@ -74,6 +81,23 @@ extern "C"  {     /*}*/
  *    PUBLIC TYPES
  ******************************************************************************/
 
+/**
+ * Attributes that could be given to the fixed memory blocks pool, see
+ * `tn_fmem_create_wattr()`.
+ */
+enum TN_FMemAttr {
+   ///
+   /// No special attributes: waiting tasks are served in FIFO order.
+   TN_FMEM_ATTR_NONE          = (0),
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Tasks waiting for free memory block are served in the order of their
+   /// priority; tasks with the same priority are served in FIFO order.
+   /// Available if only `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   TN_FMEM_ATTR_PRIO          = (1 << 0),
+#endif
+};
+
 /**
  * Fixed memory blocks pool
  */
@@ -108,6 +132,39 @@ struct TN_FMem {
    /// pointer to the next free memory block as the first word, or `NULL` if
    /// this is the last block.
    void                *free_list;
+
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Attributes given to the memory pool, available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   enum TN_FMemAttr     attr;
+   ///
+   /// Priority index of `wait_queue`, used if only the memory pool is
+   /// created with `#TN_FMEM_ATTR_PRIO`. Available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   struct TN_ListPrioIdx wait_queue_prio;
+#endif
+};
+
+/**
+ * Chain of memory blocks: a batch of blocks taken by `tn_fmem_get_multi()`
+ * or given back by `tn_fmem_release_multi()`.
+ *
+ * Blocks are linked through their first word, just like in the pool's free
+ * list: so, while the block is in the chain, its first word is occupied by
+ * the pointer to the next block. Use `tn_fmem_chain_pop()` to take the block
+ * out of the chain, and `tn_fmem_chain_push()` to put it back.
+ */
+struct TN_FMemChain {
+   ///
+   /// first block of the chain, or `#TN_NULL` if the chain is empty
+   void                *head;
+   ///
+   /// last block of the chain, or `#TN_NULL` if the chain is empty
+   void                *tail;
+   ///
+   /// number of blocks in the chain
+   int                  cnt;
 };
 
 
@@ -156,6 +213,85 @@ struct TN_FMemTaskWait {
  *    PUBLIC FUNCTION PROTOTYPES
  ******************************************************************************/
 
+/**
+ * Make the chain of memory blocks empty.
+ *
+ * @param chain
+ *    Chain to reset.
+ */
+_TN_STATIC_INLINE void tn_fmem_chain_reset(struct TN_FMemChain *chain)
+{
+   chain->head = TN_NULL;
+   chain->tail = TN_NULL;
+   chain->cnt  = 0;
+}
+
+/**
+ * Put memory block to the head of the chain. The first word of the block
+ * gets overwritten.
+ *
+ * @param chain
+ *    Chain to put block to.
+ * @param p_data
+ *    Memory block.
+ */
+_TN_STATIC_INLINE void tn_fmem_chain_push(
+      struct TN_FMemChain *chain,
+      void *p_data
+      )
+{
+   *(void **)p_data = chain->head;
+   chain->head = p_data;
+   if (chain->tail == TN_NULL){
+      chain->tail = p_data;
+   }
+   chain->cnt++;
+}
+
+/**
+ * Take memory block from the head of the chain.
+ *
+ * @param chain
+ *    Chain to take block from.
+ *
+ * @return
+ *    Memory block, or `#TN_NULL` if the chain is empty.
+ */
+_TN_STATIC_INLINE void *tn_fmem_chain_pop(struct TN_FMemChain *chain)
+{
+   void *p_data = chain->head;
+
+   if (p_data != TN_NULL){
+      chain->head = *(void **)p_data;
+      if (chain->head == TN_NULL){
+         chain->tail = TN_NULL;
+      }
+      chain->cnt--;
+   }
+
+   return p_data;
+}
+
+/**
+ * The same as `tn_fmem_create()`, but takes additional argument: `attr`.
+ *
+ * @param fmem       pointer to already allocated `struct TN_FMem`.
+ * @param attr       attributes for that particular memory pool, see
+ *                   `enum #TN_FMemAttr`
+ * @param start_addr pointer to start of the array; should be aligned properly,
+ *                   see `tn_fmem_create()`
+ * @param block_size size of memory block; should be a multiple of 
+ *                   `sizeof(#TN_UWord)`
+ * @param blocks_cnt capacity (total number of blocks in the memory pool)
+ */
+enum TN_RCode tn_fmem_create_wattr(
+      struct TN_FMem   *fmem,
+      enum TN_FMemAttr  attr,
+      void             *start_addr,
+      unsigned int      block_size,
+      int               blocks_cnt
+      );
+
 /**
  * Construct fixed memory blocks pool. `id_fmp` field should not contain
  * `#TN_ID_FSMEMORYPOOL`, otherwise, `#TN_RC_WPARAM` is returned.
@@ -218,12 +354,17 @@ struct TN_FMemTaskWait {
  *
  * @see TN_MAKE_ALIG_SIZE
  */
-enum TN_RCode tn_fmem_create(
+_TN_STATIC_INLINE enum TN_RCode tn_fmem_create(
       struct TN_FMem   *fmem,
       void             *start_addr,
       unsigned int      block_size,
       int               blocks_cnt
-      );
+      )
+{
+   return tn_fmem_create_wattr(
+         fmem, TN_FMEM_ATTR_NONE, start_addr, block_size, blocks_cnt
+         );
+}
 
 /**
  * Destruct fixed memory blocks pool.
@@ -329,6 +470,105 @@ enum TN_RCode tn_fmem_release(struct TN_FMem *fmem, void *p_data);
  */
 enum TN_RCode tn_fmem_irelease(struct TN_FMem *fmem, void *p_data);
 
+/**
+ * Get up to `cnt` memory blocks from the pool at once, in a single critical
+ * section. Received blocks are stored in the `chain` (its previous contents
+ * is discarded), use `tn_fmem_chain_pop()` to take them out of it.
+ *
+ * If there are less than `cnt` free blocks, all of them are taken. If there
+ * are no free blocks at all, behavior depends on `timeout` value (refer to
+ * `#TN_TickCnt`): the task waits for the first block, and then takes as many
+ * more free blocks as available (up to `cnt`), without waiting. So, check
+ * `chain->cnt` for the number of received blocks.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param fmem
+ *    Pointer to memory pool
+ * @param chain
+ *    Chain to store received blocks at
+ * @param cnt
+ *    Maximum number of blocks to get
+ * @param timeout    
+ *    Refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if at least one block was received (or `cnt` is 0);
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_fmem_get_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain,
+      int cnt,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_fmem_get_multi()` with zero timeout, but for using in the
+ * ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_fmem_iget_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain,
+      int cnt
+      );
+
+/**
+ * Release all memory blocks from the `chain` back to the pool at once, in a
+ * single critical section; the chain becomes empty.
+ *
+ * Tasks waiting for free block (if any) get one block each, and the rest of
+ * the chain is spliced to the free list of the pool in O(1) time. If the
+ * pool has not enough room for all the blocks, none of them is released,
+ * and `#TN_RC_OVERFLOW` is returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param fmem
+ *    Pointer to memory pool.
+ * @param chain
+ *    Chain of blocks to release.
+ *
+ * @return
+ *    * `#TN_RC_OK` on success
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_OVERFLOW` if memory pool hasn't enough room for all the
+ *      blocks of the chain (nothing is released then). This may never
+ *      happen in normal program execution; if that happens, it's a
+ *      programmer's mistake.
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_fmem_release_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain
+      );
+
+/**
+ * The same as `tn_fmem_release_multi()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_fmem_irelease_multi(
+      struct TN_FMem *fmem,
+      struct TN_FMemChain *chain
+      );
+
 /**
  * Returns number of free blocks in the memory pool
  *
@@ -0,0 +1,536 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+#include "_tn_fmem.h"
+
+
+#include "tn_heap.h"
+#include "_tn_heap.h"
+
+#include "tn_tasks.h"
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_Heap *heap
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (heap == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_heap_is_valid(heap)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_Heap *heap,
+      const struct TN_HeapClass *classes,
+      int classes_cnt,
+      const unsigned char *size_map
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (heap == TN_NULL || classes == TN_NULL || size_map == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (
+         classes_cnt <= 0
+         || classes_cnt > TN_HEAP_CLASSES_MAX
+         || _tn_heap_is_valid(heap)
+         )
+   {
+      rc = TN_RC_WPARAM;
+   } else {
+      int i;
+
+      //-- all the pools should be created, and sorted by block size
+      for (i = 0; i < classes_cnt; i++){
+         if (!_tn_fmem_is_valid(&classes[i].fmem)){
+            rc = TN_RC_WPARAM;
+         } else if (
+               i > 0
+               && classes[i].fmem.block_size <= classes[i - 1].fmem.block_size
+               )
+         {
+            rc = TN_RC_WPARAM;
+         }
+      }
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_job(
+      const struct TN_Heap *heap,
+      const void *p
+      )
+{
+   enum TN_RCode rc = _check_param_generic(heap);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (p == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_alloc(
+      const struct TN_Heap *heap,
+      unsigned int size,
+      void **p_data
+      )
+{
+   enum TN_RCode rc = _check_param_job(heap, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (size == 0 || size > heap->max_size){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_stat(
+      const struct TN_Heap *heap,
+      int class_idx,
+      struct TN_HeapClassStat *stat
+      )
+{
+   enum TN_RCode rc = _check_param_job(heap, stat);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (class_idx < 0 || class_idx >= heap->classes_cnt){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(heap)                                 (TN_RC_OK)
+#  define _check_param_create(heap, classes, classes_cnt, size_map)  (TN_RC_OK)
+#  define _check_param_job(heap, p)                                  (TN_RC_OK)
+#  define _check_param_alloc(heap, size, p_data)                     (TN_RC_OK)
+#  define _check_param_stat(heap, class_idx, stat)                   (TN_RC_OK)
+#endif
+// }}}
+
+/**
+ * Returns index of the smallest class which can hold `size` bytes; `size`
+ * should be in the range `1 .. heap->max_size`.
+ */
+_TN_STATIC_INLINE int _class_idx_get(
+      const struct TN_Heap *heap,
+      unsigned int size
+      )
+{
+   return heap->size_map[ (size - 1) / sizeof(TN_UWord) ];
+}
+
+/**
+ * Update high-water mark of the class; should be called after the block is
+ * taken from the class pool.
+ */
+_TN_STATIC_INLINE void _used_max_update(struct TN_HeapClass *cls)
+{
+   int used_cnt = cls->fmem.blocks_cnt - cls->fmem.free_blocks_cnt;
+
+   if (used_cnt > cls->used_max){
+      cls->used_max = used_cnt;
+   }
+}
+
+/**
+ * Try to allocate memory block of the given class; if there are no free
+ * blocks in it, and the heap has `#TN_HEAP_OPT_FALLBACK` option, try the
+ * next classes as well.
+ *
+ * @param heap
+ *    Heap from which block should be taken
+ * @param class_idx
+ *    Index of the first class to try
+ * @param p_data
+ *    Pointer to where the result should be stored (if `#TN_RC_TIMEOUT` is
+ *    returned, this location isn't altered)
+ */
+static enum TN_RCode _heap_alloc(
+      struct TN_Heap *heap,
+      int class_idx,
+      void **p_data
+      )
+{
+   enum TN_RCode rc;
+   TN_BOOL fallback = !!(heap->opts & TN_HEAP_OPT_FALLBACK);
+
+   do {
+      struct TN_HeapClass *cls = &heap->classes[class_idx];
+
+      rc = _tn_fmem_get(&cls->fmem, p_data);
+      if (rc == TN_RC_OK){
+         _used_max_update(cls);
+      }
+
+      class_idx++;
+   } while (
+         rc == TN_RC_TIMEOUT
+         && fallback
+         && class_idx < heap->classes_cnt
+         );
+
+   return rc;
+}
+
+/**
+ * Release memory block to the class it belongs to. The class is found by
+ * the address of the block.
+ *
+ * @return
+ *    - `#TN_RC_OK`, if operation was successful;
+ *    - `#TN_RC_WPARAM`, if the block doesn't belong to the heap;
+ *    - `#TN_RC_OVERFLOW`, if the class already has all its blocks free.
+ */
+static enum TN_RCode _heap_free(struct TN_Heap *heap, void *p_data)
+{
+   enum TN_RCode rc = TN_RC_WPARAM;
+   unsigned char *p = (unsigned char *)p_data;
+   TN_BOOL found = TN_FALSE;
+   int i;
+
+   for (i = 0; !found && i < heap->classes_cnt; i++){
+      struct TN_FMem *fmem = &heap->classes[i].fmem;
+      unsigned char *start = (unsigned char *)fmem->start_addr;
+
+      if (
+            p >= start
+            && p < start + fmem->block_size * fmem->blocks_cnt
+         )
+      {
+         //-- the block belongs to this class; make sure that the address
+         //   points to the beginning of some block
+         if ((unsigned int)(p - start) % fmem->block_size == 0){
+            rc = _tn_fmem_release(fmem, p_data);
+         }
+         found = TN_TRUE;
+      }
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_heap.h)
+ */
+enum TN_RCode tn_heap_create(
+      struct TN_Heap         *heap,
+      struct TN_HeapClass    *classes,
+      int                     classes_cnt,
+      unsigned char          *size_map,
+      enum TN_HeapOpt         opts
+      )
+{
+   enum TN_RCode rc = _check_param_create(
+         heap, classes, classes_cnt, size_map
+         );
+
+   if (rc == TN_RC_OK){
+      unsigned int map_len;
+      unsigned int i;
+      int class_idx = 0;
+
+      heap->classes     = classes;
+      heap->classes_cnt = classes_cnt;
+      heap->size_map    = size_map;
+      heap->max_size    = classes[classes_cnt - 1].fmem.block_size;
+      heap->opts        = opts;
+
+      //-- fill the size map: for each size (in words), find the smallest
+      //   class which can hold it. Since classes are sorted by block size,
+      //   just walk through them once.
+      map_len = TN_HEAP_SIZE_MAP_LEN(heap->max_size);
+      for (i = 0; i < map_len; i++){
+         unsigned int size = (i + 1) * sizeof(TN_UWord);
+
+         while (classes[class_idx].fmem.block_size < size){
+            class_idx++;
+         }
+
+         size_map[i] = (unsigned char)class_idx;
+      }
+
+      //-- the pools might be already in use
+      for (class_idx = 0; class_idx < classes_cnt; class_idx++){
+         classes[class_idx].used_max = 0;
+         _used_max_update(&classes[class_idx]);
+      }
+
+      heap->id_heap = TN_ID_HEAP;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_heap.h)
+ */
+enum TN_RCode tn_heap_delete(struct TN_Heap *heap)
+{
+   enum TN_RCode rc = _check_param_generic(heap);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      int i;
+
+      heap->id_heap = TN_ID_NONE; //-- heap does not exist now
+
+      //-- delete pools of all the classes: tasks waiting for blocks (if any)
+      //   are woken up with TN_RC_DELETED
+      for (i = 0; i < heap->classes_cnt; i++){
+         enum TN_RCode fmem_rc = tn_fmem_delete(&heap->classes[i].fmem);
+
+         if (fmem_rc != TN_RC_OK){
+            rc = fmem_rc;
+         }
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_heap.h)
+ */
+enum TN_RCode tn_heap_alloc(
+      struct TN_Heap         *heap,
+      unsigned int            size,
+      void                  **p_data,
+      TN_TickCnt              timeout
+      )
+{
+   TN_BOOL waited_for_data = TN_FALSE;
+   enum TN_RCode rc = _check_param_alloc(heap, size, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      int class_idx = _class_idx_get(heap, size);
+
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _heap_alloc(heap, class_idx, p_data);
+
+      if (rc == TN_RC_TIMEOUT && timeout > 0){
+         struct TN_FMem *fmem = &(heap->classes[class_idx].fmem);
+
+         //-- wait for the block of the class in the wait queue of the pool,
+         //   just like tn_fmem_get() does (in priority order, if the pool
+         //   is created with TN_FMEM_ATTR_PRIO)
+         _tn_task_curr_to_wait_action_wprio(
+               &(fmem->wait_queue),
+               _tn_fmem_wait_queue_prio(fmem),
+               TN_WAIT_REASON_WFIXMEM,
+               timeout
+               );
+         waited_for_data = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+      if (waited_for_data){
+
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+
+         //-- if wait result is TN_RC_OK, copy memory block pointer to the
+         //   user's location
+         if (rc == TN_RC_OK){
+            *p_data = _tn_curr_run_task->subsys_wait.fmem.data_elem;
+         }
+
+      }
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_heap.h)
+ */
+enum TN_RCode tn_heap_ialloc(
+      struct TN_Heap         *heap,
+      unsigned int            size,
+      void                  **p_data
+      )
+{
+   enum TN_RCode rc = _check_param_alloc(heap, size, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _heap_alloc(heap, _class_idx_get(heap, size), p_data);
+
+      TN_INT_IRESTORE();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_heap.h)
+ */
+enum TN_RCode tn_heap_free(struct TN_Heap *heap, void *p_data)
+{
+   enum TN_RCode rc = _check_param_job(heap, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _heap_free(heap, p_data);
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_heap.h)
+ */
+enum TN_RCode tn_heap_ifree(struct TN_Heap *heap, void *p_data)
+{
+   enum TN_RCode rc = _check_param_job(heap, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      rc = _heap_free(heap, p_data);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_heap.h)
+ */
+enum TN_RCode tn_heap_class_stat_get(
+      struct TN_Heap         *heap,
+      int                     class_idx,
+      struct TN_HeapClassStat *stat
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_stat(heap, class_idx, stat);
+
+   if (rc == TN_RC_OK){
+      struct TN_HeapClass *cls = &heap->classes[class_idx];
+
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      stat->block_size  = cls->fmem.block_size;
+      stat->blocks_cnt  = cls->fmem.blocks_cnt;
+      stat->used_cnt    = cls->fmem.blocks_cnt - cls->fmem.free_blocks_cnt;
+      stat->used_max    = cls->used_max;
+
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
+
@@ -0,0 +1,412 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Heap: variable-size memory allocator built on a set of
+ * \ref tn_fmem.h "fixed memory pools" of different block sizes ("size
+ * classes").
+ *
+ * Instead of picking a pool by hand for each allocation, the application
+ * creates pools for, say, 16, 32, 64 and 256 bytes, gives them to
+ * `tn_heap_create()`, and then just calls `tn_heap_alloc()` with the size it
+ * needs: the heap takes a block from the smallest class that can hold the
+ * requested size. The lookup of the class takes O(1) time: the heap keeps a
+ * small map from the size (in words) to the class index, see
+ * `TN_HEAP_SIZE_MAP_DEF()`. So, the allocation is as deterministic as that of
+ * the plain memory pool, and there is no fragmentation.
+ *
+ * If the class is exhausted, the heap can fall back to the next (larger)
+ * classes, if `#TN_HEAP_OPT_FALLBACK` is given to `tn_heap_create()`: this
+ * way, RAM of the idle classes is used instead of failing the allocation. If
+ * there are no free blocks in all the suitable classes, the task may wait for
+ * a free block of its own class; it waits in the wait queue of the class's
+ * memory pool, so it competes fairly with tasks that call `tn_fmem_get()` on
+ * the same pool (in priority order, if the pool is created with
+ * `#TN_FMEM_ATTR_PRIO`). Note that the waiting task is woken up only when the
+ * block of its own class is released, not of the larger ones.
+ *
+ * `tn_heap_free()` finds the class of the block by its address, so the user
+ * doesn't need to remember the size of the block.
+ *
+ * For each class, the heap maintains the high-water mark (maximum number of
+ * blocks used at once), see `tn_heap_class_stat_get()`: it helps to tune the
+ * number of blocks in each class.
+ */
+
+#ifndef _TN_HEAP_H
+#define _TN_HEAP_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_fmem.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Options for `tn_heap_create()`
+ */
+enum TN_HeapOpt {
+   ///
+   /// No options
+   TN_HEAP_OPT_NONE        = 0,
+   ///
+   /// If the class for the requested size has no free blocks, try the next
+   /// (larger) classes before failing (or waiting).
+   TN_HEAP_OPT_FALLBACK    = (1 << 0),
+};
+
+/**
+ * Size class of the heap: memory pool plus statistics.
+ *
+ * The user should create `fmem` by `tn_fmem_create()` before giving the
+ * class to `tn_heap_create()`; after that, the pool belongs to the heap and
+ * shouldn't be used directly.
+ */
+struct TN_HeapClass {
+   ///
+   /// memory pool of the class
+   struct TN_FMem       fmem;
+   ///
+   /// high-water mark: maximum number of blocks used at once
+   int                  used_max;
+};
+
+/**
+ * Statistics of the heap class, see `tn_heap_class_stat_get()`
+ */
+struct TN_HeapClassStat {
+   ///
+   /// size of the block, in bytes
+   unsigned int         block_size;
+   ///
+   /// total number of blocks in the class
+   int                  blocks_cnt;
+   ///
+   /// number of currently used blocks
+   int                  used_cnt;
+   ///
+   /// high-water mark: maximum number of blocks used at once
+   int                  used_max;
+};
+
+/**
+ * Heap
+ */
+struct TN_Heap {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId        id_heap;
+   ///
+   /// array of size classes, sorted by block size (ascending)
+   struct TN_HeapClass *classes;
+   ///
+   /// number of elements in `classes`
+   int                  classes_cnt;
+   ///
+   /// map from the size to class index: element `i` contains index of the
+   /// smallest class which can hold `(i + 1)` words.
+   unsigned char       *size_map;
+   ///
+   /// block size of the largest class: maximum size that can be allocated
+   unsigned int         max_size;
+   ///
+   /// options given to `tn_heap_create()`
+   enum TN_HeapOpt      opts;
+};
+
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Maximum number of size classes in the heap
+ */
+#define TN_HEAP_CLASSES_MAX      255
+
+/**
+ * Number of elements in the size map for the heap whose largest class has
+ * block size `max_block_size`.
+ */
+#define TN_HEAP_SIZE_MAP_LEN(max_block_size)                      \
+   (TN_MAKE_ALIG_SIZE(max_block_size) / sizeof(TN_UWord))
+
+/**
+ * Convenience macro for the definition of size map for the heap.
+ *
+ * @param name
+ *    C variable name of the map array (this name should be given
+ *    to the `tn_heap_create()` as the `size_map` argument)
+ * @param max_block_size
+ *    Block size of the largest class of the heap
+ */
+#define TN_HEAP_SIZE_MAP_DEF(name, max_block_size)                \
+   unsigned char name[ TN_HEAP_SIZE_MAP_LEN(max_block_size) ]
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the heap on the given size classes. `id_heap` field should not
+ * contain `#TN_ID_HEAP`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * Memory pools of all the classes should be already created by
+ * `tn_fmem_create()`, and classes should be sorted by block size, strictly
+ * ascending.
+ *
+ * Typical definition looks as follows:
+ *
+ * \code{.c}
+ * TN_FMEM_BUF_DEF(my_buf_16,  unsigned char[16],  10);
+ * TN_FMEM_BUF_DEF(my_buf_64,  unsigned char[64],  4);
+ * TN_FMEM_BUF_DEF(my_buf_256, unsigned char[256], 2);
+ *
+ * //-- size map should be large enough for the largest class
+ * TN_HEAP_SIZE_MAP_DEF(my_size_map, 256);
+ *
+ * struct TN_HeapClass my_classes[3];
+ * struct TN_Heap my_heap;
+ *
+ * void some_func()
+ * {
+ *    tn_fmem_create(&my_classes[0].fmem, my_buf_16,  16,  10);
+ *    tn_fmem_create(&my_classes[1].fmem, my_buf_64,  64,  4);
+ *    tn_fmem_create(&my_classes[2].fmem, my_buf_256, 256, 2);
+ *
+ *    tn_heap_create(
+ *          &my_heap, my_classes, 3, my_size_map, TN_HEAP_OPT_FALLBACK
+ *          );
+ * }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param heap
+ *    Pointer to already allocated `struct TN_Heap`
+ * @param classes
+ *    Array of size classes, with memory pools already created
+ * @param classes_cnt
+ *    Number of classes, `1 .. #TN_HEAP_CLASSES_MAX`
+ * @param size_map
+ *    Size map, should be defined by `TN_HEAP_SIZE_MAP_DEF()` for the
+ *    block size of the largest class
+ * @param opts
+ *    Options, see `enum #TN_HeapOpt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if heap was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_heap_create(
+      struct TN_Heap         *heap,
+      struct TN_HeapClass    *classes,
+      int                     classes_cnt,
+      unsigned char          *size_map,
+      enum TN_HeapOpt         opts
+      );
+
+/**
+ * Destruct the heap: memory pools of all its classes are deleted (see
+ * `tn_fmem_delete()`), so all tasks waiting for memory blocks are released
+ * from waiting with `#TN_RC_DELETED` code.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param heap
+ *    Pointer to heap to be deleted
+ *
+ * @return
+ *    * `#TN_RC_OK` if heap was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_heap_delete(struct TN_Heap *heap);
+
+/**
+ * Allocate memory block of at least `size` bytes from the heap.
+ *
+ * The block is taken from the smallest class which can hold `size` bytes.
+ * If there are no free blocks in it, and the heap was created with
+ * `#TN_HEAP_OPT_FALLBACK`, the next classes are tried. If there are no free
+ * blocks at all, behavior depends on `timeout` value (refer to
+ * `#TN_TickCnt`): the task waits for the block of the first class.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param heap
+ *    Pointer to heap
+ * @param size
+ *    Requested size, in bytes: `1 .. (block size of the largest class)`
+ * @param p_data
+ *    Address of the `(void *)` to which received block address
+ *    will be saved
+ * @param timeout
+ *    Refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if block was successfully allocated;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_heap_alloc(
+      struct TN_Heap         *heap,
+      unsigned int            size,
+      void                  **p_data,
+      TN_TickCnt              timeout
+      );
+
+/**
+ * The same as `tn_heap_alloc()` with zero timeout, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_heap_ialloc(
+      struct TN_Heap         *heap,
+      unsigned int            size,
+      void                  **p_data
+      );
+
+/**
+ * Release memory block back to the heap. The class of the block is found by
+ * its address; if some task waits for the block of this class, the block is
+ * given to it.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param heap
+ *    Pointer to heap
+ * @param p_data
+ *    Address of the memory block to release, previously allocated
+ *    from the same heap
+ *
+ * @return
+ *    * `#TN_RC_OK` on success
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_WPARAM` if the block doesn't belong to the heap;
+ *    * `#TN_RC_OVERFLOW` if the class of the block already has all its
+ *      blocks free (that is, block is released twice)
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_heap_free(struct TN_Heap *heap, void *p_data);
+
+/**
+ * The same as `tn_heap_free()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_heap_ifree(struct TN_Heap *heap, void *p_data);
+
+/**
+ * Get statistics of the heap class.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param heap
+ *    Pointer to heap
+ * @param class_idx
+ *    Index of the class, `0 .. (classes_cnt - 1)`
+ * @param stat
+ *    Pointer to the structure to which statistics will be saved
+ *
+ * @return
+ *    * `#TN_RC_OK` on success
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_heap_class_stat_get(
+      struct TN_Heap         *heap,
+      int                     class_idx,
+      struct TN_HeapClassStat *stat
+      );
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_HEAP_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
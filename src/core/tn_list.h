@@ -36,7 +36,8 @@
 
 /**
  * \file
- * Circular doubly linked list, for internal kernel usage.
+ * Circular doubly linked list, and priority index of the list of tasks, for
+ * internal kernel usage.
  */
 
 
@@ -49,10 +50,21 @@
  *    INCLUDED FILES
  ******************************************************************************/
 
+#include "tn_common.h"
+#include "../arch/tn_arch.h"
+
 #ifdef __cplusplus
 extern "C"  {     /*}*/
 #endif
 
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/// Number of words in the bitmap of priorities (`struct #TN_PrioBmp`)
+#define _TN_PRIO_BMP_WORDS_CNT                                   \
+   ((TN_PRIORITIES_CNT + TN_INT_WIDTH - 1) / TN_INT_WIDTH)
+
 /*******************************************************************************
  *    PUBLIC TYPES
  ******************************************************************************/
@@ -69,12 +81,45 @@ struct TN_ListItem {
    struct TN_ListItem *next;
 };
 
-/*******************************************************************************
- *    PROTECTED GLOBAL DATA
- ******************************************************************************/
+/**
+ * Bitmap of priorities, for internal kernel usage: priority `N` is
+ * represented by the bit `(N % #TN_INT_WIDTH)` of the word
+ * `(N / #TN_INT_WIDTH)`.
+ */
+struct TN_PrioBmp {
+   ///
+   /// words of the bitmap
+   unsigned int words[ _TN_PRIO_BMP_WORDS_CNT ];
+#if (_TN_PRIO_BMP_WORDS_CNT > 1) || defined(DOXYGEN_ACTIVE)
+   ///
+   /// summary: bit `N` is set if word `N` is non-zero. Used if only there is
+   /// more than one word in the bitmap.
+   unsigned int summary;
+#endif
+};
+
+/**
+ * Priority index of the list of tasks sorted by priority (tasks of the same
+ * priority are sorted in FIFO order), for internal kernel usage: see
+ * `#TN_USE_PRIO_WAIT_QUEUES`.
+ *
+ * The list itself stays an ordinary list (so that it can be examined as
+ * usual), and the index allows to find the place for the new task in O(1)
+ * time: this is the first task of the next lower priority present in the
+ * list, which is found by the bitmap.
+ */
+struct TN_ListPrioIdx {
+   ///
+   /// priorities of the tasks in the list
+   struct TN_PrioBmp bmp;
+   ///
+   /// for each priority present in the list (see `bmp`), `task_queue` of the
+   /// first task with that priority
+   struct TN_ListItem *first[ TN_PRIORITIES_CNT ];
+};
 
 /*******************************************************************************
- *    DEFINITIONS
+ *    PROTECTED GLOBAL DATA
  ******************************************************************************/
 
 /*******************************************************************************
@@ -0,0 +1,481 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * A message queue is a FIFO of fixed-size messages, which are copied by value:
+ * unlike \ref tn_dqueue.h "data queue", which stores just a pointer (of type
+ * `void *`) in each cell, message queue copies the whole message to its own
+ * buffer on send, and copies it out to the receiver's buffer on receive. So,
+ * small messages can be passed without the \ref tn_fmem.h "fixed memory pool"
+ * and the four kernel calls per message it involves (`tn_fmem_get()`,
+ * `tn_queue_send()`, `tn_queue_receive()`, `tn_fmem_release()`): just one
+ * kernel call on each side is needed.
+ *
+ * Message size is given to `tn_msgq_create()` and can't change later; the
+ * buffer for messages is supplied by the user, see `TN_MSGQ_BUF_DEF()`.
+ *
+ * Wait semantics are exactly the same as those of the data queue: a task that
+ * sends a message waits in the `wait_send` queue until there is room in the
+ * FIFO, and a task that receives a message waits in the `wait_receive` queue
+ * until a message arrives. While the task waits, the kernel keeps the pointer
+ * to its buffer, and copies the message directly from (to) it when the other
+ * party comes. To use a message queue just for the synchronous message
+ * passing, set size of the FIFO to 0.
+ *
+ * Since messages are copied with interrupts disabled, keep them small: for
+ * large messages, data queue with the memory pool is still a better choice.
+ *
+ * Just like the data queue, message queue can be connected to the event group,
+ * refer to the section \ref eventgrp_connect for details. Related services:
+ *
+ * - `tn_msgq_eventgrp_connect()`
+ * - `tn_msgq_eventgrp_disconnect()`
+ *
+ */
+
+#ifndef _TN_MSGQ_H
+#define _TN_MSGQ_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_eventgrp.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Structure representing message queue object
+ */
+struct TN_MsgQueue {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_msgq;
+   ///
+   /// list of tasks waiting to send messages
+   struct TN_ListItem  wait_send_list;
+   ///
+   /// list of tasks waiting to receive messages
+   struct TN_ListItem  wait_receive_list;
+
+   ///
+   /// buffer to store messages, `(items_cnt * item_size)` bytes.
+   /// Can be `TN_NULL`.
+   unsigned char *data_buf;
+   ///
+   /// size of one message, in bytes
+   unsigned int   item_size;
+   ///
+   /// capacity (total messages count). Can be 0.
+   int            items_cnt;
+   ///
+   /// count of non-free items in `data_buf`
+   int            filled_items_cnt;
+   ///
+   /// index of the item which will be written next time
+   int            head_idx;
+   ///
+   /// index of the item which will be read next time
+   int            tail_idx;
+   ///
+   /// connected event group
+   struct TN_EGrpLink eventgrp_link;
+};
+
+/**
+ * MsgQueue-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_MsgQueueTaskWait {
+   /// if task tries to send the message to the message queue,
+   /// and there's no space in the queue, pointer to the message is stored
+   /// in this field
+   const void *send_msg;
+   ///
+   /// if task tries to receive the message from the message queue,
+   /// and there are no messages in the queue, pointer to the buffer
+   /// to store the message at is stored in this field
+   void *recv_msg;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for message queue. See
+ * `tn_msgq_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_msgq_create()` function as the `data_buf` argument)
+ * @param item_type
+ *    Type of message, like `struct MyMessage`.
+ * @param size
+ *    Number of messages in the queue.
+ */
+#define TN_MSGQ_BUF_DEF(name, item_type, size)                    \
+   TN_UWord name[                                                 \
+        ((size) * sizeof(item_type) + sizeof(TN_UWord) - 1)       \
+      / sizeof(TN_UWord)                                          \
+      ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct message queue. `id_msgq` member should not contain
+ * `#TN_ID_MSGQUEUE`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * Typical definition looks as follows:
+ *
+ * \code{.c}
+ *     //-- number of messages in the queue
+ *     #define MY_MSGQ_SIZE    8
+ *
+ *     //-- type of message
+ *     struct MyMessage {
+ *        // ... arbitrary fields ...
+ *     };
+ *     
+ *     //-- define buffer for message queue
+ *     TN_MSGQ_BUF_DEF(my_msgq_buf, struct MyMessage, MY_MSGQ_SIZE);
+ *
+ *     //-- define message queue structure
+ *     struct TN_MsgQueue my_msgq;
+ * \endcode
+ *
+ * And then, construct your `my_msgq` as follows:
+ *
+ * \code{.c}
+ *     enum TN_RCode rc;
+ *     rc = tn_msgq_create( &my_msgq,
+ *                          my_msgq_buf,
+ *                          sizeof(struct MyMessage),
+ *                          MY_MSGQ_SIZE );
+ *     if (rc != TN_RC_OK){
+ *        //-- handle error
+ *     }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param msgq       pointer to already allocated struct TN_MsgQueue.
+ * @param data_buf   pointer to already allocated buffer of at least
+ *                   `(item_size * items_cnt)` bytes to store messages.
+ *                   Can be `#TN_NULL`.
+ * @param item_size  size of one message, in bytes. Should be non-zero.
+ * @param items_cnt  capacity of queue (count of messages that fit in the
+ *                   `data_buf`). Can be 0.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if queue was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_msgq_create(
+      struct TN_MsgQueue *msgq,
+      void *data_buf,
+      unsigned int item_size,
+      int items_cnt
+      );
+
+
+/**
+ * Destruct message queue.
+ *
+ * All tasks that wait for writing to or reading from the queue become
+ * runnable with `#TN_RC_DELETED` code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param msgq       pointer to message queue to be deleted
+ *
+ * @return 
+ *    * `#TN_RC_OK` if queue was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_msgq_delete(struct TN_MsgQueue *msgq);
+
+
+/**
+ * Send the message pointed to by `p_msg` to the message queue specified by
+ * the `msgq`: `item_size` bytes are copied from `p_msg`.
+ *
+ * If there are tasks in the message queue's `wait_receive` list already, the
+ * message is copied directly to the buffer of the task from the head of the
+ * `wait_receive` list, and this task becomes runnable.
+ *
+ * If there are no tasks in the message queue's `wait_receive` list, the
+ * message is copied to the tail of the FIFO. If the FIFO is full, behavior
+ * depends on the `timeout` value: refer to `#TN_TickCnt`. While the task
+ * waits, the message at `p_msg` should stay untouched.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param msgq       pointer to message queue to send message to
+ * @param p_msg      pointer to message to send
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if message was successfully sent;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_msgq_send(
+      struct TN_MsgQueue *msgq,
+      const void *p_msg,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_msgq_send()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_msgq_send_polling(
+      struct TN_MsgQueue *msgq,
+      const void *p_msg
+      );
+
+/**
+ * The same as `tn_msgq_send()` with zero timeout, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_msgq_isend_polling(
+      struct TN_MsgQueue *msgq,
+      const void *p_msg
+      );
+
+/**
+ * Receive the message from the message queue specified by the `msgq`:
+ * `item_size` bytes are copied to the buffer pointed to by `p_msg`.
+ *
+ * If the FIFO already has messages, the oldest one is copied out of it. Then,
+ * if there are task(s) in the message queue's `wait_send` list, the message
+ * of the first one is copied to the freed room in the FIFO, and this task
+ * becomes runnable. If there are no messages in the FIFO and there are no
+ * tasks in the `wait_send` list, behavior depends on the `timeout` value:
+ * refer to `#TN_TickCnt`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param msgq       pointer to message queue to receive message from
+ * @param p_msg      pointer to buffer of at least `item_size` bytes to
+ *                   store the message at
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if message was successfully received;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_msgq_receive(
+      struct TN_MsgQueue *msgq,
+      void *p_msg,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_msgq_receive()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_msgq_receive_polling(
+      struct TN_MsgQueue *msgq,
+      void *p_msg
+      );
+
+/**
+ * The same as `tn_msgq_receive()` with zero timeout, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_msgq_ireceive_polling(
+      struct TN_MsgQueue *msgq,
+      void *p_msg
+      );
+
+
+/**
+ * Returns number of free items in the queue
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param msgq
+ *    Pointer to queue.
+ *
+ * @return
+ *    Number of free items in the queue, or -1 if wrong params were given (the
+ *    check is performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_msgq_free_items_cnt_get(
+      struct TN_MsgQueue  *msgq
+      );
+
+
+/**
+ * Returns number of used (non-free) items in the queue
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param msgq
+ *    Pointer to queue.
+ *
+ * @return
+ *    Number of used (non-free) items in the queue, or -1 if wrong params were
+ *    given (the check is performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_msgq_used_items_cnt_get(
+      struct TN_MsgQueue  *msgq
+      );
+
+
+/**
+ * Connect an event group to the queue. 
+ * Refer to the section \ref eventgrp_connect for details.
+ *
+ * Only one event group can be connected to the queue at a time. If you
+ * connect event group while another event group is already connected,
+ * the old link is discarded.
+ *
+ * @param msgq
+ *    queue to which event group should be connected
+ * @param eventgrp 
+ *    event groupt to connect
+ * @param pattern
+ *    flags pattern that should be managed by the queue automatically
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_msgq_eventgrp_connect(
+      struct TN_MsgQueue  *msgq,
+      struct TN_EventGrp  *eventgrp,
+      TN_UWord             pattern
+      );
+
+
+/**
+ * Disconnect a connected event group from the queue.
+ * Refer to the section \ref eventgrp_connect for details.
+ *
+ * If there is no event group connected, nothing is changed.
+ *
+ * @param msgq    queue from which event group should be disconnected
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_msgq_eventgrp_disconnect(
+      struct TN_MsgQueue  *msgq
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_MSGQ_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
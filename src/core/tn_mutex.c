@@ -44,6 +44,7 @@
 
 //-- internal tnkernel headers
 #include "_tn_mutex.h"
+#include "_tn_rwlock.h"
 #include "_tn_tasks.h"
 #include "_tn_list.h"
 
@@ -149,31 +150,48 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
 
 
 /**
- * Iterate through all the tasks that wait for locked mutex,
- * checking if task's priority is higher than ref_priority.
- *
- * Max priority (i.e. lowest value) is returned.
+ * Account the task of given priority as waiting for the mutex with priority
+ * inheritance protocol.
  */
-_TN_STATIC_INLINE int _find_max_blocked_priority(struct TN_Mutex *mutex, int ref_priority)
+static void _waiter_priority_add(struct TN_Mutex *mutex, int priority)
 {
-   int               priority;
-   struct TN_Task   *task;
+   if (_tn_prio_bmp_find(&(mutex->waiters_prio_bmp), priority) != priority){
+      //-- there are no other waiting tasks with the same priority
+      _tn_prio_bmp_set(&(mutex->waiters_prio_bmp), priority);
+      mutex->waiters_prio_cnt[priority] = 1;
+   } else {
+      mutex->waiters_prio_cnt[priority]++;
+   }
+}
 
-   priority = ref_priority;
+/**
+ * Account the task of given priority as not waiting for the mutex with
+ * priority inheritance protocol anymore.
+ */
+static void _waiter_priority_remove(struct TN_Mutex *mutex, int priority)
+{
+   mutex->waiters_prio_cnt[priority]--;
 
-   //-- Iterate through all the tasks that wait for lock mutex.
-   //   Highest priority (i.e. lowest number) will be returned eventually.
-   _tn_list_for_each_entry(
-         task, struct TN_Task, &(mutex->wait_queue), task_queue
-         )
-   {
-      if (task->priority < priority){
-         //--  task priority is higher, remember it
-         priority = task->priority;
-      }
+   if (mutex->waiters_prio_cnt[priority] == 0){
+      _tn_prio_bmp_clear(&(mutex->waiters_prio_bmp), priority);
    }
+}
 
-   return priority;
+/**
+ * Find max priority of the tasks that wait for locked mutex with priority
+ * inheritance protocol, checking if it is higher than ref_priority. It is
+ * taken from the bitmap of priorities of waiting tasks, so it takes O(1)
+ * time.
+ *
+ * Max priority (i.e. lowest value) is returned.
+ */
+_TN_STATIC_INLINE int _find_max_blocked_priority(struct TN_Mutex *mutex, int ref_priority)
+{
+   int priority = _tn_prio_bmp_find(&(mutex->waiters_prio_bmp), 0);
+
+   return (priority >= 0 && priority < ref_priority)
+      ? priority
+      : ref_priority;
 }
 
 /**
@@ -197,9 +215,8 @@ _TN_STATIC_INLINE int _find_max_priority_by_mutex(
 
       case TN_MUTEX_PROT_INHERIT:
          //-- Mutex protocol is 'priority inheritance':
-         //   we need to iterate through all the tasks that wait for 
-         //   the mutex, checking if task's priority is higher than
-         //   `ref_priority`.
+         //   we need to find max priority of the tasks that wait for
+         //   the mutex, checking if it is higher than `ref_priority`.
          priority = _find_max_blocked_priority(mutex, priority);
          break;
 
@@ -223,10 +240,16 @@ _TN_STATIC_INLINE int _find_max_priority_by_mutex(
  *      and check if priority of each task is higher than
  *      our task's base priority
  *
+ * Then, take into account the reader-writer locks held by task (see
+ * tn_rwlock.h).
+ *
  * Eventually, find out highest priority and set it.
+ *
+ * @returns TN_TRUE if task's priority has changed
  */
-static void _update_task_priority(struct TN_Task *task)
+static TN_BOOL _update_task_priority(struct TN_Task *task)
 {
+   TN_BOOL changed = TN_FALSE;
    int priority;
 
    //-- Now, we need to determine new priority of current task.
@@ -247,10 +270,16 @@ static void _update_task_priority(struct TN_Task *task)
       }
    }
 
+   //-- reader-writer locks held by the task
+   priority = _tn_rwlock_max_priority_by_task(task, priority);
+
    //-- New priority determined, set it
    if (priority != task->priority){
       _tn_change_task_priority(task, priority);
+      changed = TN_TRUE;
    }
+
+   return changed;
 }
 
 
@@ -258,6 +287,9 @@ static void _update_task_priority(struct TN_Task *task)
  * Elevate task's priority to given value (if task's priority is now lower).
  * If task is waiting for some mutex too, go on to holder of that mutex
  * and elevate its priority too, recursively. And so on.
+ *
+ * If task is waiting for reader-writer lock, elevate priorities of all its
+ * holders in the same way.
  */
 _TN_STATIC_INLINE void _task_priority_elevate(struct TN_Task *task, int priority)
 {
@@ -282,7 +314,8 @@ in:
       _tn_change_running_task_priority(task, priority);
    } else {
       //-- Task is not runnable, so, just set new priority to it
-      task->priority = priority;
+      //   (it might be moved within the priority-ordered wait queue)
+      _tn_change_task_priority(task, priority);
 
       //-- and check if the task is waiting for mutex
       if (     (_tn_task_is_waiting(task))
@@ -304,18 +337,84 @@ in:
 
          task = _get_mutex_by_wait_queque(task->pwait_queue)->holder;
          goto in;
+      } else if (    (_tn_task_is_waiting(task))
+                  && (task->task_wait_reason == TN_WAIT_REASON_RWLOCK)
+                )
+      {
+         //-- Task is waiting for reader-writer lock, which might be held
+         //   by several tasks: elevate priority of each of them
+         _tn_rwlock_holders_priority_elevate(task, priority);
       }
    }
 
 }
 
-_TN_STATIC_INLINE void _mutex_do_lock(struct TN_Mutex *mutex, struct TN_Task *task)
+/**
+ * Make given task the holder of the mutex, without touching priorities.
+ *
+ * By itself, this is the fast path of locking the mutex which is free and
+ * has priority inheritance protocol: since the mutex is free, nobody waits
+ * for it, so it can't affect priority of the task. Priority inheritance work
+ * is deferred until some other task actually tries to lock the mutex (see
+ * `_add_curr_task_to_mutex_wait_queue()`).
+ */
+_TN_STATIC_INLINE void _mutex_holder_set(
+      struct TN_Mutex *mutex,
+      struct TN_Task *task
+      )
 {
    mutex->holder = task;
    __mutex_lock_cnt_change(mutex, 1);
 
-   //-- Add mutex to task's locked mutexes queue
+   //-- Add mutex to task's locked mutexes queue: even if mutex doesn't
+   //   affect task's priority, we need it there to unlock the mutex
+   //   when the task is terminated
    _tn_list_add_tail(&(task->mutex_queue), &(mutex->mutex_queue));
+}
+
+/**
+ * Returns whether the mutex currently affects priority of its holder, so
+ * that priority of the holder should be updated when the mutex is unlocked.
+ *
+ * If nobody waits for the mutex with priority inheritance protocol, it
+ * doesn't: when a task stops waiting for the mutex, priority of the holder
+ * is updated right away (see `_tn_mutex_i_on_task_wait_complete()`).
+ *
+ * For the mutex with priority ceiling protocol, it doesn't if ceiling
+ * priority is lower than the current priority of the holder: then, the
+ * holder got its priority from somewhere else.
+ *
+ * This allows to skip `_update_task_priority()` (which examines all the
+ * mutexes and reader-writer locks held by the task) when uncontended mutex
+ * is unlocked.
+ */
+_TN_STATIC_INLINE TN_BOOL _mutex_affects_holder_priority(
+      struct TN_Mutex *mutex
+      )
+{
+   TN_BOOL ret = TN_TRUE;
+
+   switch (mutex->protocol){
+      case TN_MUTEX_PROT_CEILING:
+         ret = (mutex->ceil_priority <= mutex->holder->priority);
+         break;
+
+      case TN_MUTEX_PROT_INHERIT:
+         ret = !_tn_list_is_empty(&(mutex->wait_queue));
+         break;
+
+      default:
+         //-- should never happen
+         _TN_FATAL_ERRORF("wrong mutex protocol=%d", mutex->protocol);
+         break;
+   }
+
+   return ret;
+}
+
+_TN_STATIC_INLINE void _mutex_do_lock(struct TN_Mutex *mutex, struct TN_Task *task)
+{
+   _mutex_holder_set(mutex, task);
 
    //-- Determine new priority for the task
    {
@@ -507,6 +606,9 @@ _TN_STATIC_INLINE void _add_curr_task_to_mutex_wait_queue(
          _task_priority_elevate(mutex->holder, _tn_curr_run_task->priority);
       }
 
+      //-- remember priority of the waiting task
+      _waiter_priority_add(mutex, _tn_curr_run_task->priority);
+
       wait_reason = TN_WAIT_REASON_MUTEX_I;
    } else {
       //-- Priority ceiling protocol
@@ -542,8 +644,10 @@ static void _mutex_do_unlock(struct TN_Mutex * mutex)
    //-- Delete curr mutex from task's locked mutexes queue
    _tn_list_remove_entry(&(mutex->mutex_queue));
 
-   //-- update priority for current holder
-   _update_task_priority(mutex->holder);
+   //-- update priority for current holder, if needed
+   if (_mutex_affects_holder_priority(mutex)){
+      _update_task_priority(mutex->holder);
+   }
 
    //-- Check for the task(s) that want to lock the mutex
    if (_tn_list_is_empty(&(mutex->wait_queue))){
@@ -654,6 +758,13 @@ in:
 
       task = holder;
       goto in;
+   } else if (    (_tn_task_is_waiting(holder))
+               && (holder->task_wait_reason == TN_WAIT_REASON_RWLOCK)
+             )
+   {
+      //-- holder is waiting for reader-writer lock: update priorities
+      //   of its holders
+      _tn_rwlock_holders_priority_update(holder);
    }
 }
 
@@ -688,6 +799,7 @@ enum TN_RCode tn_mutex_create(
       mutex->holder        = TN_NULL;
       mutex->ceil_priority = ceil_priority;
       mutex->cnt           = 0;
+      _tn_prio_bmp_reset(&(mutex->waiters_prio_bmp));
       mutex->id_mutex      = TN_ID_MUTEX;
    }
 
@@ -760,7 +872,15 @@ enum TN_RCode tn_mutex_lock(struct TN_Mutex *mutex, TN_TickCnt timeout)
 
       TN_INT_DIS_SAVE();
 
-      if (_tn_curr_run_task == mutex->holder){
+      if (     mutex->holder == TN_NULL
+            && mutex->protocol == TN_MUTEX_PROT_INHERIT
+         )
+      {
+         //-- fast path: mutex is not locked, and nobody waits for it,
+         //   so priorities aren't affected. Just lock it.
+         _mutex_holder_set(mutex, _tn_curr_run_task);
+
+      } else if (_tn_curr_run_task == mutex->holder){
          //-- mutex is already locked by current task
          //   if recursive locking enabled (TN_MUTEX_REC), increment lock count,
          //   otherwise error is returned
@@ -776,16 +896,8 @@ enum TN_RCode tn_mutex_lock(struct TN_Mutex *mutex, TN_TickCnt timeout)
          rc = TN_RC_ILLEGAL_USE;
 
       } else if (mutex->holder == TN_NULL){
-         //-- mutex is not locked, let's lock it
-
-         //-- TODO: probably, we should add special flag to _mutex_do_lock,
-         //   something like "other_tasks_can_wait", and set it to false here.
-         //   When _mutex_do_lock() is called from _mutex_do_unlock(), this flag
-         //   should be set to true there.
-         //   _mutex_do_lock() should forward this flag to _find_max_priority_by_mutex(),
-         //   and if that flag is false, _find_max_priority_by_mutex() should not
-         //   call _find_max_blocked_priority().
-         //   We could save about 30 cycles then. =)
+         //-- mutex with priority ceiling protocol is not locked, let's lock
+         //   it (priority of the task might be elevated to the ceiling)
          _mutex_do_lock(mutex, _tn_curr_run_task);
 
       } else {
@@ -918,6 +1030,13 @@ void _tn_mutex_i_on_task_wait_complete(struct TN_Task *task)
    }
 #endif
 
+   //-- task doesn't wait for the mutex anymore: forget its priority (it
+   //   should be done before priorities of holders are recalculated)
+   _waiter_priority_remove(
+         _get_mutex_by_wait_queque(task->pwait_queue),
+         task->priority
+         );
+
    if (task->priority_already_updated){
       //-- priority is already updated (in _mutex_do_unlock)
       //   so, just do nothing here
@@ -934,6 +1053,44 @@ void _tn_mutex_i_on_task_wait_complete(struct TN_Task *task)
 
 }
 
+/**
+ * See comments in _tn_mutex.h file
+ */
+void _tn_mutex_i_on_waiter_priority_change(
+      struct TN_Task *task,
+      int new_priority
+      )
+{
+   struct TN_Mutex *mutex = _get_mutex_by_wait_queque(task->pwait_queue);
+
+   _waiter_priority_remove(mutex, task->priority);
+   _waiter_priority_add(mutex, new_priority);
+}
+
+/**
+ * See comments in _tn_mutex.h file
+ */
+void _tn_mutex_task_priority_elevate(struct TN_Task *task, int priority)
+{
+   _task_priority_elevate(task, priority);
+}
+
+/**
+ * See comments in _tn_mutex.h file
+ */
+TN_BOOL _tn_mutex_task_priority_update(struct TN_Task *task)
+{
+   return _update_task_priority(task);
+}
+
+/**
+ * See comments in _tn_mutex.h file
+ */
+void _tn_mutex_holders_priority_update(struct TN_Task *task)
+{
+   _update_holders_priority_recursive(task);
+}
+
 /**
  * See comments in _tn_mutex.h file
  */
@@ -80,6 +80,14 @@
  * The priority ceiling protocol prevents deadlocks and chained blocking but it
  * is slower than the priority inheritance protocol.
  *
+ * Tasks that wait for the mutex get it in FIFO order, whatever the protocol
+ * is. The mutex with priority inheritance protocol additionally keeps the
+ * bitmap of priorities of waiting tasks, and the number of waiting tasks of
+ * each priority: then, the highest priority of waiting tasks is known in
+ * O(1) time, and priority inheritance takes time which doesn't depend on the
+ * number of waiting tasks. It costs `#TN_PRIORITIES_CNT` halfwords plus the
+ * bitmap per mutex.
+ *
  * @see `#TN_USE_MUTEXES`
  */
 
@@ -150,6 +158,15 @@ struct TN_Mutex {
    ///
    /// Lock count (for recursive locking)
    int cnt;
+   ///
+   /// Priorities of the tasks that wait for the mutex, used if only
+   /// protocol is `#TN_MUTEX_PROT_INHERIT`
+   struct TN_PrioBmp waiters_prio_bmp;
+   ///
+   /// For each priority present in `waiters_prio_bmp`, number of the tasks
+   /// that wait for the mutex with that priority (values for other
+   /// priorities are meaningless)
+   unsigned short waiters_prio_cnt[ TN_PRIORITIES_CNT ];
 };
 
 /*******************************************************************************
@@ -453,7 +453,10 @@ typedef struct TN_EventGrp    TN_EVENT;
 #define tn_next_task_to_run   _tn_next_task_to_run
 #define tn_curr_run_task      _tn_curr_run_task
 
-#define tn_ready_to_run_bmp   _tn_ready_to_run_bmp
+//-- NOTE: there is no `tn_ready_to_run_bmp` anymore: `_tn_ready_to_run_bmp`
+//   is now an array (see `#TN_PRIORITIES_MAX_CNT`), so old code which uses
+//   it as a single word should fail to compile instead of silently
+//   misbehaving.
 
 #define tn_idle_task          _tn_idle_task
 
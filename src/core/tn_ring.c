@@ -0,0 +1,508 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+#include "tn_ring.h"
+#include "_tn_ring.h"
+
+#include "tn_tasks.h"
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_Ring *ring
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (ring == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_ring_is_valid(ring)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_Ring *ring,
+      void *data_buf,
+      unsigned int item_size,
+      TN_UWord items_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (ring == TN_NULL || data_buf == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (
+         item_size == 0 || items_cnt == 0
+         || items_cnt > ((TN_UWord)-1 / 2)
+         || _tn_ring_is_valid(ring)
+         )
+   {
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_job(
+      const struct TN_Ring *ring,
+      const void *p_item
+      )
+{
+   enum TN_RCode rc = _check_param_generic(ring);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (p_item == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(ring)                                 (TN_RC_OK)
+#  define _check_param_create(ring, data_buf, item_size, items_cnt)  (TN_RC_OK)
+#  define _check_param_job(ring, p_item)                             (TN_RC_OK)
+#endif
+// }}}
+
+//-- Lock-free index arithmetic {{{
+
+/**
+ * Returns number of items in the ring, given head and tail indices.
+ * Both indices are in the range `[0, 2 * items_cnt)`.
+ */
+_TN_STATIC_INLINE TN_UWord _used_cnt(
+      const struct TN_Ring *ring,
+      TN_UWord head_idx,
+      TN_UWord tail_idx
+      )
+{
+   return (head_idx >= tail_idx)
+      ? (head_idx - tail_idx)
+      : (head_idx + 2 * ring->items_cnt - tail_idx);
+}
+
+/**
+ * Returns pointer to the item in the buffer, given index in the range
+ * `[0, 2 * items_cnt)`.
+ */
+_TN_STATIC_INLINE volatile unsigned char *_item_ptr(
+      const struct TN_Ring *ring,
+      TN_UWord idx
+      )
+{
+   if (idx >= ring->items_cnt){
+      idx -= ring->items_cnt;
+   }
+   return ring->data_buf + (idx * ring->item_size);
+}
+
+/**
+ * Returns next index after the given one, wrapping at `2 * items_cnt`.
+ */
+_TN_STATIC_INLINE TN_UWord _idx_next(
+      const struct TN_Ring *ring,
+      TN_UWord idx
+      )
+{
+   idx++;
+   if (idx >= 2 * ring->items_cnt){
+      idx = 0;
+   }
+   return idx;
+}
+
+// }}}
+
+/**
+ * Producer side: copy item to the ring and publish it by advancing
+ * `head_idx`. Lock-free: should be called by the single producer only.
+ *
+ * @return
+ *    * `#TN_RC_OK` if item was written;
+ *    * `#TN_RC_TIMEOUT` if the ring is full.
+ */
+static enum TN_RCode _ring_write(
+      struct TN_Ring *ring,
+      const void *p_item
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   TN_UWord head_idx = ring->head_idx;
+
+   if (_used_cnt(ring, head_idx, ring->tail_idx) >= ring->items_cnt){
+      //-- no space for new item
+      rc = TN_RC_TIMEOUT;
+   } else {
+      volatile unsigned char *p_dst = _item_ptr(ring, head_idx);
+      const unsigned char *p_src = (const unsigned char *)p_item;
+      unsigned int i;
+
+      //-- copy item first (through volatile pointer, so that the compiler
+      //   can't move it past the index update), and then publish it.
+      for (i = 0; i < ring->item_size; i++){
+         p_dst[i] = p_src[i];
+      }
+
+      ring->head_idx = _idx_next(ring, head_idx);
+   }
+
+   return rc;
+}
+
+/**
+ * Consumer side: copy item from the ring and free its room by advancing
+ * `tail_idx`. Lock-free: should be called by the single consumer only.
+ *
+ * @return
+ *    * `#TN_RC_OK` if item was read;
+ *    * `#TN_RC_TIMEOUT` if the ring is empty.
+ */
+static enum TN_RCode _ring_read(
+      struct TN_Ring *ring,
+      void *p_item
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   TN_UWord tail_idx = ring->tail_idx;
+
+   if (ring->head_idx == tail_idx){
+      //-- nothing to read
+      rc = TN_RC_TIMEOUT;
+   } else {
+      volatile unsigned char *p_src = _item_ptr(ring, tail_idx);
+      unsigned char *p_dst = (unsigned char *)p_item;
+      unsigned int i;
+
+      //-- copy item first, and then free its room
+      for (i = 0; i < ring->item_size; i++){
+         p_dst[i] = p_src[i];
+      }
+
+      ring->tail_idx = _idx_next(ring, tail_idx);
+   }
+
+   return rc;
+}
+
+/**
+ * Checks whether the consumer waits for data. Reading of the list head is
+ * atomic; the consumer is put to the wait queue with interrupts disabled,
+ * after checking the ring once again, so if the producer sees empty wait
+ * queue here after the item is published, the consumer will see the item.
+ *
+ * The list head is read through volatile pointer: `head_idx` is volatile,
+ * so the compiler can't move this read before the publishing of the item.
+ * With plain read, it could, since the list isn't volatile.
+ */
+_TN_STATIC_INLINE TN_BOOL _consumer_waits(const struct TN_Ring *ring)
+{
+   struct TN_ListItem *const volatile *p_next =
+      &(ring->wait_receive_list.next);
+
+   //-- the same as `!_tn_list_is_empty()`, but inline: it's a hot path
+   return (*p_next != &ring->wait_receive_list);
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_create(
+      struct TN_Ring *ring,
+      void *data_buf,
+      unsigned int item_size,
+      TN_UWord items_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_create(ring, data_buf, item_size, items_cnt);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      _tn_list_reset(&(ring->wait_receive_list));
+
+      ring->data_buf    = (volatile unsigned char *)data_buf;
+      ring->item_size   = item_size;
+      ring->items_cnt   = items_cnt;
+      ring->head_idx    = 0;
+      ring->tail_idx    = 0;
+
+      ring->id_ring = TN_ID_RING;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_delete(struct TN_Ring *ring)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_generic(ring);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- notify waiting task that the object is deleted
+      //   (TN_RC_DELETED is returned)
+      _tn_wait_queue_notify_deleted(&(ring->wait_receive_list));
+
+      ring->id_ring = TN_ID_NONE; //-- ring does not exist now
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_iwrite(
+      struct TN_Ring *ring,
+      const void *p_item
+      )
+{
+   enum TN_RCode rc = _check_param_job(ring, p_item);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      rc = _ring_write(ring, p_item);
+
+      if (rc == TN_RC_OK && _consumer_waits(ring)){
+         //-- slow path: consumer waits for data, wake it up.
+         //   (it might have stopped waiting by timeout in the meantime,
+         //   `_tn_task_first_wait_complete()` handles it)
+         TN_INTSAVE_DATA_INT;
+
+         TN_INT_IDIS_SAVE();
+         _tn_task_first_wait_complete(
+               &ring->wait_receive_list, TN_RC_OK, TN_NULL, TN_NULL, TN_NULL
+               );
+         TN_INT_IRESTORE();
+         _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_write(
+      struct TN_Ring *ring,
+      const void *p_item
+      )
+{
+   enum TN_RCode rc = _check_param_job(ring, p_item);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      rc = _ring_write(ring, p_item);
+
+      if (rc == TN_RC_OK && _consumer_waits(ring)){
+         //-- slow path: consumer waits for data, wake it up.
+         TN_INTSAVE_DATA;
+
+         TN_INT_DIS_SAVE();
+         _tn_task_first_wait_complete(
+               &ring->wait_receive_list, TN_RC_OK, TN_NULL, TN_NULL, TN_NULL
+               );
+         TN_INT_RESTORE();
+         _tn_context_switch_pend_if_needed();
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_read(
+      struct TN_Ring *ring,
+      void *p_item,
+      TN_TickCnt timeout
+      )
+{
+   TN_BOOL waited = TN_FALSE;
+   enum TN_RCode rc = _check_param_job(ring, p_item);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      //-- fast path: just read the item, if any
+      rc = _ring_read(ring, p_item);
+
+      if (rc == TN_RC_TIMEOUT && timeout != 0){
+         TN_INTSAVE_DATA;
+
+         TN_INT_DIS_SAVE();
+
+         //-- The producer might have written an item after we've checked
+         //   the ring: check it once again, now with interrupts disabled.
+         //   If it's still empty, go to wait: the producer will see us
+         //   in the wait queue after it publishes the next item.
+         rc = _ring_read(ring, p_item);
+         if (rc == TN_RC_TIMEOUT){
+            _tn_task_curr_to_wait_action(
+                  &(ring->wait_receive_list),
+                  TN_WAIT_REASON_RING_WRECEIVE,
+                  timeout
+                  );
+            waited = TN_TRUE;
+         }
+
+         TN_INT_RESTORE();
+         _tn_context_switch_pend_if_needed();
+
+         if (waited){
+            //-- get wait result
+            rc = _tn_curr_run_task->task_wait_rc;
+
+            if (rc == TN_RC_OK){
+               //-- we were woken up by the producer, so the item is there
+               rc = _ring_read(ring, p_item);
+               if (rc != TN_RC_OK){
+                  _TN_FATAL_ERROR("ring should not be empty here");
+               }
+            }
+         }
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+enum TN_RCode tn_ring_read_polling(
+      struct TN_Ring *ring,
+      void *p_item
+      )
+{
+   enum TN_RCode rc = _check_param_job(ring, p_item);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      rc = _ring_read(ring, p_item);
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_ring.h)
+ */
+int tn_ring_used_items_cnt_get(
+      struct TN_Ring *ring
+      )
+{
+   int ret = -1;
+   enum TN_RCode rc = _check_param_generic(ring);
+
+   if (rc == TN_RC_OK){
+      //-- indices are read atomically, so the result is consistent
+      //   (though it might be outdated at once, of course)
+      ret = (int)_used_cnt(ring, ring->head_idx, ring->tail_idx);
+   }
+
+   return ret;
+}
+
+
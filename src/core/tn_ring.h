@@ -0,0 +1,357 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * A ring is a lock-free single-producer / single-consumer FIFO of fixed-size
+ * items, designed for high-rate streaming from an ISR to a task (ADC samples,
+ * UART RX bytes, etc).
+ *
+ * Unlike \ref tn_dqueue.h "data queue" or \ref tn_msgq.h "message queue",
+ * writing to the ring doesn't disable interrupts and doesn't call the
+ * scheduler in the common case: the producer just copies the item to the
+ * buffer and advances the head index; the consumer copies the item out and
+ * advances the tail index. Each index is written by one side only, and
+ * reading or writing of `#TN_UWord` is atomic, so no locking is needed.
+ *
+ * The consumer task blocks only when the ring is empty: it is put to the
+ * ring's wait queue (with interrupts disabled, as usual). The producer checks
+ * whether the wait queue is non-empty after publishing an item, and only in
+ * this case takes the slow path: disables interrupts and wakes the consumer
+ * up. So, while the consumer is busy, producer pays just for a copy and a
+ * couple of index operations.
+ *
+ * Restrictions that come with it:
+ *
+ * - There should be at most one producer and one consumer at a time. Usually,
+ *   the producer is the ISR (`tn_ring_iwrite()`), and the consumer is the task
+ *   (`tn_ring_read()`); the producer can also be a task (`tn_ring_write()`).
+ *   If you need several producers or consumers, use \ref tn_msgq.h "message
+ *   queue" instead.
+ * - Producer never waits: if the ring is full, the write returns
+ *   `#TN_RC_TIMEOUT` and the item is dropped, which is the only sensible
+ *   behavior for the ISR anyway.
+ * - Items are copied byte by byte through `volatile` pointer, so that the
+ *   compiler can't move the copying past the index update. Keep items small:
+ *   a sample or a few bytes.
+ *
+ */
+
+#ifndef _TN_RING_H
+#define _TN_RING_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Structure representing single-producer / single-consumer ring
+ */
+struct TN_Ring {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_ring;
+   ///
+   /// list of tasks waiting to read data (there may be at most one task)
+   struct TN_ListItem  wait_receive_list;
+
+   ///
+   /// buffer to store items, `(items_cnt * item_size)` bytes
+   volatile unsigned char *data_buf;
+   ///
+   /// size of one item, in bytes
+   unsigned int   item_size;
+   ///
+   /// capacity (total items count)
+   TN_UWord       items_cnt;
+   ///
+   /// index of the item which will be written next time, in the range
+   /// `[0, 2 * items_cnt)`: it "wraps" twice as late as the actual item
+   /// position does, so that the full ring can be told from the empty one.
+   /// Written by the producer only.
+   volatile TN_UWord head_idx;
+   ///
+   /// index of the item which will be read next time, in the same range as
+   /// `head_idx`. Written by the consumer only.
+   volatile TN_UWord tail_idx;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for the ring. See
+ * `tn_ring_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_ring_create()` function as the `data_buf` argument)
+ * @param item_type
+ *    Type of item, like `unsigned short`.
+ * @param size
+ *    Number of items in the ring.
+ */
+#define TN_RING_BUF_DEF(name, item_type, size)                    \
+   TN_UWord name[                                                 \
+        ((size) * sizeof(item_type) + sizeof(TN_UWord) - 1)       \
+      / sizeof(TN_UWord)                                          \
+      ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the ring. `id_ring` member should not contain `#TN_ID_RING`,
+ * otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * Typical usage looks as follows:
+ *
+ * \code{.c}
+ *     //-- define buffer for 64 ADC samples
+ *     TN_RING_BUF_DEF(adc_ring_buf, unsigned short, 64);
+ *
+ *     //-- define ring structure
+ *     struct TN_Ring adc_ring;
+ *
+ *     void init(void)
+ *     {
+ *        tn_ring_create(
+ *              &adc_ring, adc_ring_buf, sizeof(unsigned short), 64
+ *              );
+ *     }
+ *
+ *     void adc_isr(void)
+ *     {
+ *        unsigned short sample = ADC_RESULT;
+ *        if (tn_ring_iwrite(&adc_ring, &sample) != TN_RC_OK){
+ *           //-- overrun: the sample is lost
+ *        }
+ *     }
+ *
+ *     void adc_task_body(void *param)
+ *     {
+ *        unsigned short sample;
+ *        for (;;){
+ *           tn_ring_read(&adc_ring, &sample, TN_WAIT_INFINITE);
+ *           //-- handle the sample
+ *        }
+ *     }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to already allocated struct TN_Ring.
+ * @param data_buf   pointer to already allocated buffer of at least
+ *                   `(item_size * items_cnt)` bytes to store items.
+ * @param item_size  size of one item, in bytes. Should be non-zero.
+ * @param items_cnt  capacity of the ring. Should be non-zero.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if ring was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_ring_create(
+      struct TN_Ring *ring,
+      void *data_buf,
+      unsigned int item_size,
+      TN_UWord items_cnt
+      );
+
+/**
+ * Destruct the ring.
+ *
+ * The task that waits for data (if any) becomes runnable with
+ * `#TN_RC_DELETED` code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to ring to be deleted
+ *
+ * @return 
+ *    * `#TN_RC_OK` if ring was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_ring_delete(struct TN_Ring *ring);
+
+/**
+ * Write the item to the ring from the ISR: `item_size` bytes are copied from
+ * `p_item`. Interrupts are not disabled, unless there is a task waiting for
+ * data: in this case, it is woken up.
+ *
+ * Only one producer (either ISR or task) is allowed for each ring.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to ring to write item to
+ * @param p_item     pointer to item to write
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if item was successfully written;
+ *    * `#TN_RC_TIMEOUT` if the ring is full; the item is not written;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_ring_iwrite(
+      struct TN_Ring *ring,
+      const void *p_item
+      );
+
+/**
+ * The same as `tn_ring_iwrite()`, but for using in the task.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_ring_write(
+      struct TN_Ring *ring,
+      const void *p_item
+      );
+
+/**
+ * Read the item from the ring: `item_size` bytes are copied to `p_item`.
+ * If the ring is empty, behavior depends on the `timeout` value: refer to
+ * `#TN_TickCnt`.
+ *
+ * Only one consumer task is allowed for each ring.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring       pointer to ring to read item from
+ * @param p_item     pointer to buffer of at least `item_size` bytes to
+ *                   store the item at
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if item was successfully read;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_ring_read(
+      struct TN_Ring *ring,
+      void *p_item,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_ring_read()` with zero timeout. It never disables
+ * interrupts.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_ring_read_polling(
+      struct TN_Ring *ring,
+      void *p_item
+      );
+
+/**
+ * Returns number of used (non-free) items in the ring
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param ring
+ *    Pointer to ring.
+ *
+ * @return
+ *    Number of used (non-free) items in the ring, or -1 if wrong params were
+ *    given (the check is performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_ring_used_items_cnt_get(
+      struct TN_Ring *ring
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_RING_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
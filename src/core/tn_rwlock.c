@@ -0,0 +1,731 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+//-- common tnkernel headers
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_rwlock.h"
+#include "_tn_mutex.h"
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+//-- header of current module
+#include "tn_rwlock.h"
+
+//-- header of other needed modules
+#include "tn_tasks.h"
+
+
+#if TN_USE_RWLOCKS
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+#define _get_rwlock_by_wait_queue(que)                \
+   container_of(que, struct TN_RWLock, wait_queue)
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_RWLock *rwlock
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (rwlock == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_rwlock_is_valid(rwlock)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_RWLock *rwlock,
+      enum TN_RWLockOpt       opts
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (rwlock == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (_tn_rwlock_is_valid(rwlock)){
+      rc = TN_RC_WPARAM;
+   } else if ((opts & ~TN_RWLOCK_OPT_WRITER_PREF) != 0){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(rwlock)             (TN_RC_OK)
+#  define _check_param_create(rwlock, opts)        (TN_RC_OK)
+#endif
+// }}}
+
+/**
+ * Find the hold record of given lock in the task's `rwlock_holds` array.
+ * If `rwlock` is `TN_NULL`, unused record is found.
+ *
+ * @returns pointer to the record, or `TN_NULL` if there's no such record.
+ */
+static struct TN_RWLockHold *_hold_find(
+      struct TN_Task *task,
+      const struct TN_RWLock *rwlock
+      )
+{
+   struct TN_RWLockHold *ret = TN_NULL;
+   int i;
+
+   for (i = 0; (ret == TN_NULL) && (i < TN_RWLOCK_HOLDS_MAX); i++){
+      if (task->rwlock_holds[i].rwlock == rwlock){
+         ret = &(task->rwlock_holds[i]);
+      }
+   }
+
+   return ret;
+}
+
+/**
+ * Make the task hold the lock (for reading or for writing), using its
+ * unused hold record. The caller must ensure there is one.
+ */
+static void _hold_add(
+      struct TN_RWLock *rwlock,
+      struct TN_Task *task,
+      TN_BOOL write
+      )
+{
+   struct TN_RWLockHold *hold = _hold_find(task, TN_NULL);
+
+   _TN_BUG_ON(hold == TN_NULL);
+
+   hold->rwlock = rwlock;
+   hold->cnt    = 1;
+   _tn_list_add_tail(&(rwlock->holds_list), &(hold->holds_list_item));
+
+   if (write){
+      rwlock->writer = task;
+   } else {
+      rwlock->readers_cnt++;
+   }
+}
+
+/**
+ * Release the lock held by the task, and make the hold record unused.
+ */
+static void _hold_remove(struct TN_RWLockHold *hold)
+{
+   struct TN_RWLock *rwlock = hold->rwlock;
+
+   if (rwlock->writer == hold->task){
+      rwlock->writer = TN_NULL;
+   } else {
+      rwlock->readers_cnt--;
+   }
+
+   _tn_list_remove_entry(&(hold->holds_list_item));
+   hold->rwlock = TN_NULL;
+   hold->cnt    = 0;
+}
+
+/**
+ * Account the task of given priority as waiting for the lock.
+ */
+static void _waiter_priority_add(struct TN_RWLock *rwlock, int priority)
+{
+   if (_tn_prio_bmp_find(&(rwlock->waiters_prio_bmp), priority) != priority){
+      //-- there are no other waiting tasks with the same priority
+      _tn_prio_bmp_set(&(rwlock->waiters_prio_bmp), priority);
+      rwlock->waiters_prio_cnt[priority] = 1;
+   } else {
+      rwlock->waiters_prio_cnt[priority]++;
+   }
+}
+
+/**
+ * Account the task of given priority as not waiting for the lock anymore.
+ */
+static void _waiter_priority_remove(struct TN_RWLock *rwlock, int priority)
+{
+   rwlock->waiters_prio_cnt[priority]--;
+
+   if (rwlock->waiters_prio_cnt[priority] == 0){
+      _tn_prio_bmp_clear(&(rwlock->waiters_prio_bmp), priority);
+   }
+}
+
+/**
+ * Find max priority of the tasks that wait for the lock, checking if it is
+ * higher than `ref_priority`. It is taken from the bitmap of priorities of
+ * waiting tasks, so it takes O(1) time.
+ *
+ * Max priority (i.e. lowest value) is returned.
+ */
+static int _find_max_blocked_priority(
+      struct TN_RWLock *rwlock,
+      int ref_priority
+      )
+{
+   int priority = _tn_prio_bmp_find(&(rwlock->waiters_prio_bmp), 0);
+
+   return (priority >= 0 && priority < ref_priority)
+      ? priority
+      : ref_priority;
+}
+
+
+/**
+ * Recalculate priorities of all the holders of the lock. If priority of
+ * some holder has changed, and the holder waits for some mutex with priority
+ * inheritance or other reader-writer lock, go on to that object's holders.
+ *
+ * NOTE: recursion goes on only if the priority has changed, so it
+ * terminates even if tasks are in deadlock.
+ */
+static void _holders_priority_update(struct TN_RWLock *rwlock)
+{
+   struct TN_RWLockHold *hold;
+
+   _tn_list_for_each_entry(
+         hold, struct TN_RWLockHold, &(rwlock->holds_list), holds_list_item
+         )
+   {
+      struct TN_Task *task = hold->task;
+
+      if (     _tn_mutex_task_priority_update(task)
+            && _tn_task_is_waiting(task)
+         )
+      {
+         if (task->task_wait_reason == TN_WAIT_REASON_MUTEX_I){
+            _tn_mutex_holders_priority_update(task);
+         } else if (task->task_wait_reason == TN_WAIT_REASON_RWLOCK){
+            _tn_rwlock_holders_priority_update(task);
+         }
+      }
+   }
+}
+
+/**
+ * Give the lock to the waiting tasks, if possible: see comments in the
+ * header file (tn_rwlock.h) for the rules.
+ *
+ * NOTE: priorities of the new holders are not updated here, caller should
+ * call `_holders_priority_update()` if something was granted.
+ *
+ * @returns TN_TRUE if the lock was given to some task
+ */
+static TN_BOOL _grant_waiters(struct TN_RWLock *rwlock)
+{
+   struct TN_Task *task;      //-- "cursor" for the loop iteration
+   struct TN_Task *tmp_task;  //-- we need for temporary item because
+                              //   item is removed from the list
+                              //   in _tn_task_wait_complete().
+
+   TN_BOOL granted = TN_FALSE;
+   TN_BOOL stop = TN_FALSE;
+
+   _tn_list_for_each_entry_safe(
+         task, struct TN_Task, tmp_task, &(rwlock->wait_queue), task_queue
+         )
+   {
+      TN_BOOL write = task->subsys_wait.rwlock.write;
+      TN_BOOL grant = TN_FALSE;
+
+      if (stop){
+         //-- nobody else can get the lock now
+      } else if (write){
+         if (rwlock->writer == TN_NULL && rwlock->readers_cnt == 0){
+            //-- lock is free: writer gets it, and nobody else can
+            grant = TN_TRUE;
+            stop  = TN_TRUE;
+         } else if (rwlock->opts & TN_RWLOCK_OPT_WRITER_PREF){
+            //-- readers behind the waiting writer should wait as well
+            stop  = TN_TRUE;
+         } else {
+            //-- reader preference: readers behind the waiting writer
+            //   can get the lock
+         }
+      } else if (rwlock->writer == TN_NULL){
+         //-- lock isn't held for writing: reader gets it
+         grant = TN_TRUE;
+      } else {
+         stop = TN_TRUE;
+      }
+
+      if (grant){
+         //-- NOTE: the hold should be added before waking the task up,
+         //   see _tn_rwlock_on_task_wait_complete()
+         task->subsys_wait.rwlock.granted = TN_TRUE;
+         _hold_add(rwlock, task, write);
+         _tn_task_wait_complete(task, TN_RC_OK);
+
+         granted = TN_TRUE;
+      }
+   }
+
+   return granted;
+}
+
+/**
+ * Common code for `tn_rwlock_read_lock()` and `tn_rwlock_write_lock()`.
+ * Interrupts should be disabled.
+ *
+ * If current task is put to wait, `*p_waited` is set to `TN_TRUE`, and the
+ * actual return code should be taken from `task_wait_rc` after the context
+ * switch.
+ */
+static enum TN_RCode _rwlock_lock(
+      struct TN_RWLock *rwlock,
+      TN_BOOL write,
+      TN_TickCnt timeout,
+      TN_BOOL *p_waited
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   struct TN_Task *task = _tn_curr_run_task;
+   struct TN_RWLockHold *hold = _hold_find(task, rwlock);
+
+   if (hold != TN_NULL){
+      if (write || rwlock->writer == task){
+         //-- upgrading or downgrading the lock is not allowed,
+         //   as well as recursive locking for writing
+         rc = TN_RC_ILLEGAL_USE;
+      } else {
+         //-- recursive locking for reading: never blocks, even if some
+         //   writer waits for the lock (otherwise, there would be deadlock)
+         hold->cnt++;
+      }
+   } else if (_hold_find(task, TN_NULL) == TN_NULL){
+      //-- no free hold records
+      rc = TN_RC_OVERFLOW;
+   } else if (write
+         ?  (rwlock->writer == TN_NULL && rwlock->readers_cnt == 0)
+         :  (     rwlock->writer == TN_NULL
+               && (     !(rwlock->opts & TN_RWLOCK_OPT_WRITER_PREF)
+                     || _tn_list_is_empty(&(rwlock->wait_queue))
+                  )
+            )
+         )
+   {
+      //-- lock can be got at once
+      _hold_add(rwlock, task, write);
+
+      //-- in case of reader preference, some writers might wait for the
+      //   lock already: the new reader inherits their priority.
+      if (!_tn_list_is_empty(&(rwlock->wait_queue))){
+         int priority = _find_max_blocked_priority(rwlock, task->priority);
+         if (priority != task->priority){
+            _tn_change_task_priority(task, priority);
+         }
+      }
+   } else if (timeout == 0){
+      //-- in polling mode, just return TN_RC_TIMEOUT
+      rc = TN_RC_TIMEOUT;
+   } else {
+      //-- all holders of the lock inherit priority of current task
+      //   (if it is higher)
+      _tn_list_for_each_entry(
+            hold, struct TN_RWLockHold, &(rwlock->holds_list), holds_list_item
+            )
+      {
+         _tn_mutex_task_priority_elevate(hold->task, task->priority);
+      }
+
+      task->subsys_wait.rwlock.write   = write;
+      task->subsys_wait.rwlock.granted = TN_FALSE;
+
+      _waiter_priority_add(rwlock, task->priority);
+
+      _tn_task_curr_to_wait_action(
+            &(rwlock->wait_queue), TN_WAIT_REASON_RWLOCK, timeout
+            );
+
+      *p_waited = TN_TRUE;
+   }
+
+   return rc;
+}
+
+/**
+ * Common code for `tn_rwlock_read_lock()` and `tn_rwlock_write_lock()`:
+ * check params and context, and call `_rwlock_lock()`.
+ */
+static enum TN_RCode _rwlock_lock_job(
+      struct TN_RWLock *rwlock,
+      TN_BOOL write,
+      TN_TickCnt timeout
+      )
+{
+   enum TN_RCode rc = _check_param_generic(rwlock);
+   TN_BOOL waited = TN_FALSE;
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _rwlock_lock(rwlock, write, timeout, &waited);
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+      }
+   }
+
+   return rc;
+}
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_rwlock.h)
+ */
+enum TN_RCode tn_rwlock_create(
+      struct TN_RWLock   *rwlock,
+      enum TN_RWLockOpt   opts
+      )
+{
+   enum TN_RCode rc = _check_param_create(rwlock, opts);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      _tn_list_reset(&(rwlock->wait_queue));
+      _tn_list_reset(&(rwlock->holds_list));
+      _tn_prio_bmp_reset(&(rwlock->waiters_prio_bmp));
+
+      rwlock->readers_cnt  = 0;
+      rwlock->writer       = TN_NULL;
+      rwlock->opts         = opts;
+      rwlock->id_rwlock    = TN_ID_RWLOCK;
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_rwlock.h)
+ */
+enum TN_RCode tn_rwlock_delete(struct TN_RWLock *rwlock)
+{
+   enum TN_RCode rc = _check_param_generic(rwlock);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+      struct TN_RWLockHold *hold;
+      int holders_cnt;
+
+      TN_INT_DIS_SAVE();
+
+      hold = _hold_find(_tn_curr_run_task, rwlock);
+      holders_cnt = rwlock->readers_cnt + (rwlock->writer != TN_NULL ? 1 : 0);
+
+      //-- lock can be deleted if only it isn't held by other tasks
+      if (holders_cnt > (hold != TN_NULL ? 1 : 0)){
+         rc = TN_RC_ILLEGAL_USE;
+      } else {
+         //-- lock does not exist now. NOTE: it should be marked invalid
+         //   before notifying waiting tasks, so that
+         //   _tn_rwlock_on_task_wait_complete() doesn't try to give them
+         //   the lock.
+         rwlock->id_rwlock = TN_ID_NONE;
+
+         //-- Remove all tasks (if any) from the lock's wait queue
+         _tn_wait_queue_notify_deleted(&(rwlock->wait_queue));
+
+         if (hold != TN_NULL){
+            //-- current task holds the lock: release it, and recalculate
+            //   its priority (it might inherit priority of waiting tasks)
+            _hold_remove(hold);
+            _tn_mutex_task_priority_update(_tn_curr_run_task);
+         }
+      }
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_rwlock.h)
+ */
+enum TN_RCode tn_rwlock_read_lock(
+      struct TN_RWLock *rwlock,
+      TN_TickCnt timeout
+      )
+{
+   return _rwlock_lock_job(rwlock, TN_FALSE, timeout);
+}
+
+/*
+ * See comments in the header file (tn_rwlock.h)
+ */
+enum TN_RCode tn_rwlock_read_lock_polling(struct TN_RWLock *rwlock)
+{
+   return _rwlock_lock_job(rwlock, TN_FALSE, 0);
+}
+
+/*
+ * See comments in the header file (tn_rwlock.h)
+ */
+enum TN_RCode tn_rwlock_write_lock(
+      struct TN_RWLock *rwlock,
+      TN_TickCnt timeout
+      )
+{
+   return _rwlock_lock_job(rwlock, TN_TRUE, timeout);
+}
+
+/*
+ * See comments in the header file (tn_rwlock.h)
+ */
+enum TN_RCode tn_rwlock_write_lock_polling(struct TN_RWLock *rwlock)
+{
+   return _rwlock_lock_job(rwlock, TN_TRUE, 0);
+}
+
+/*
+ * See comments in the header file (tn_rwlock.h)
+ */
+enum TN_RCode tn_rwlock_unlock(struct TN_RWLock *rwlock)
+{
+   enum TN_RCode rc = _check_param_generic(rwlock);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+      struct TN_RWLockHold *hold;
+
+      TN_INT_DIS_SAVE();
+
+      hold = _hold_find(_tn_curr_run_task, rwlock);
+
+      if (hold == TN_NULL){
+         //-- unlocking is enabled only for the holders
+         rc = TN_RC_ILLEGAL_USE;
+      } else {
+         hold->cnt--;
+
+         if (hold->cnt > 0){
+            //-- there was recursive lock for reading, so here we just
+            //   decremented counter, but don't unlock it.
+         } else {
+            _hold_remove(hold);
+
+            //-- give the lock to the waiting tasks (if possible),
+            //   and make them inherit priorities of the rest of waiters
+            if (_grant_waiters(rwlock)){
+               _holders_priority_update(rwlock);
+            }
+
+            //-- current task doesn't inherit priorities of the lock's
+            //   waiters anymore
+            _tn_mutex_task_priority_update(_tn_curr_run_task);
+         }
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    INTERNAL TNKERNEL FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * See comments in _tn_rwlock.h file
+ */
+void _tn_rwlock_unlock_all_by_task(struct TN_Task *task)
+{
+   int i;
+
+   for (i = 0; i < TN_RWLOCK_HOLDS_MAX; i++){
+      struct TN_RWLock *rwlock = task->rwlock_holds[i].rwlock;
+
+      if (rwlock != TN_NULL){
+         _hold_remove(&(task->rwlock_holds[i]));
+
+         if (_grant_waiters(rwlock)){
+            _holders_priority_update(rwlock);
+         }
+      }
+   }
+}
+
+/**
+ * See comments in _tn_rwlock.h file
+ */
+int _tn_rwlock_max_priority_by_task(struct TN_Task *task, int ref_priority)
+{
+   int priority = ref_priority;
+   int i;
+
+   for (i = 0; i < TN_RWLOCK_HOLDS_MAX; i++){
+      struct TN_RWLock *rwlock = task->rwlock_holds[i].rwlock;
+
+      if (rwlock != TN_NULL){
+         priority = _find_max_blocked_priority(rwlock, priority);
+      }
+   }
+
+   return priority;
+}
+
+/**
+ * See comments in _tn_rwlock.h file
+ */
+void _tn_rwlock_holders_priority_elevate(struct TN_Task *task, int priority)
+{
+   struct TN_RWLock *rwlock = _get_rwlock_by_wait_queue(task->pwait_queue);
+   struct TN_RWLockHold *hold;
+
+   _tn_list_for_each_entry(
+         hold, struct TN_RWLockHold, &(rwlock->holds_list), holds_list_item
+         )
+   {
+      //-- NOTE: it does nothing if holder's priority is already high
+      //   enough, so, recursion terminates even if tasks are in deadlock.
+      _tn_mutex_task_priority_elevate(hold->task, priority);
+   }
+}
+
+/**
+ * See comments in _tn_rwlock.h file
+ */
+void _tn_rwlock_holders_priority_update(struct TN_Task *task)
+{
+   _holders_priority_update(_get_rwlock_by_wait_queue(task->pwait_queue));
+}
+
+/**
+ * See comments in _tn_rwlock.h file
+ */
+void _tn_rwlock_on_waiter_priority_change(
+      struct TN_Task *task,
+      int new_priority
+      )
+{
+   struct TN_RWLock *rwlock = _get_rwlock_by_wait_queue(task->pwait_queue);
+
+   _waiter_priority_remove(rwlock, task->priority);
+   _waiter_priority_add(rwlock, new_priority);
+}
+
+/**
+ * See comments in _tn_rwlock.h file
+ */
+void _tn_rwlock_on_task_wait_complete(struct TN_Task *task)
+{
+   struct TN_RWLock *rwlock = _get_rwlock_by_wait_queue(task->pwait_queue);
+
+   //-- task doesn't wait for the lock anymore: forget its priority (it
+   //   should be done before priorities of holders are recalculated)
+   _waiter_priority_remove(rwlock, task->priority);
+
+   if (task->subsys_wait.rwlock.granted){
+      //-- task got the lock: priorities are handled by the code which
+      //   gave the lock (see _grant_waiters()), so, do nothing here
+   } else if (!_tn_rwlock_is_valid(rwlock)){
+      //-- lock is being deleted: priority of its holder (if any) is
+      //   handled in tn_rwlock_delete()
+   } else {
+      //-- task stopped waiting because of timeout, or it was released
+      //   from waiting, or terminated.
+      //
+      //   If it was a writer, it might block the readers behind it: so,
+      //   let them get the lock, if possible.
+      if (task->subsys_wait.rwlock.write){
+         _grant_waiters(rwlock);
+      }
+
+      //-- holders don't inherit priority of the task anymore
+      _holders_priority_update(rwlock);
+   }
+}
+
+#endif // TN_USE_RWLOCKS
+
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
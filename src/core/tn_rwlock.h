@@ -0,0 +1,396 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * A reader-writer lock is an object used to protect shared resources which
+ * are read much more often than they are modified: say, routing or
+ * calibration tables.
+ *
+ * Unlike \ref tn_mutex.h "mutex", which is held by at most one task at a
+ * time, reader-writer lock can be held either by any number of tasks for
+ * reading, or by just one task for writing. So, readers don't serialize
+ * each other, and the writer has exclusive access to the resource.
+ *
+ * Reader-writer lock features in TNeo:
+ *
+ *    - Recursive locking for reading is supported: the task which already
+ *      holds the lock for reading may lock it for reading once again (it
+ *      never blocks), and it should unlock it the same number of times;
+ *    - Timeouts, as usual, refer to `#TN_TickCnt`;
+ *    - Priority inheritance: if a task has to wait for the lock, every task
+ *      which holds it (be it the writer or readers) inherits the priority of
+ *      the waiting task, if it is higher. The inheritance is transitive: it
+ *      goes on through the mutexes with priority inheritance and other
+ *      reader-writer locks which holders wait for, and back. This is done by
+ *      the same machinery that is used by mutexes, so the task's priority is
+ *      always the highest one among its base priority, mutexes it holds and
+ *      reader-writer locks it holds;
+ *    - Writer preference, optionally (see `#TN_RWLOCK_OPT_WRITER_PREF`).
+ *
+ * By default, the lock prefers readers: a task that wants to lock it for
+ * reading gets it at once if there's no writer holding the lock, even if
+ * there are writers waiting for it. This gives maximum throughput for
+ * readers, but writers might starve if there's always some reader holding
+ * the lock. With `#TN_RWLOCK_OPT_WRITER_PREF` set, as soon as some writer
+ * waits for the lock, new readers wait as well (unless they already hold
+ * the lock), so, the writer gets the lock as soon as current readers unlock
+ * it.
+ *
+ * Waiting tasks are served in FIFO order: when the lock gets free, and the
+ * first waiting task is a writer, the writer gets the lock. Otherwise,
+ * waiting readers get it: with reader preference, all of them; with writer
+ * preference, the ones that are ahead of the first waiting writer.
+ *
+ * The lock additionally keeps the bitmap of priorities of waiting tasks, and
+ * the number of waiting tasks of each priority: then, the highest priority
+ * of waiting tasks is known in O(1) time, while the tasks still wait in FIFO
+ * order. It costs `#TN_PRIORITIES_CNT` halfwords plus the bitmap per lock.
+ *
+ * Each task contains `#TN_RWLOCK_HOLDS_MAX` records of held reader-writer
+ * locks (they are needed to maintain priority inheritance), so, the task
+ * can hold at most that number of reader-writer locks at a time.
+ *
+ * Restrictions that come with it:
+ *
+ * - The task can't upgrade the lock held for reading to the one held for
+ *   writing, or vice versa: it should unlock it first.
+ * - Deadlock detection (see `#TN_MUTEX_DEADLOCK_DETECT`) doesn't cover
+ *   reader-writer locks.
+ *
+ * @see `#TN_USE_RWLOCKS`
+ */
+
+#ifndef _TN_RWLOCK_H
+#define _TN_RWLOCK_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    EXTERNAL TYPES
+ ******************************************************************************/
+
+struct TN_Task;
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Options for `tn_rwlock_create()`
+ */
+enum TN_RWLockOpt {
+   ///
+   /// Reader preference (default): readers get the lock if only there's no
+   /// writer holding it.
+   TN_RWLOCK_OPT_READER_PREF  = 0,
+   ///
+   /// Writer preference: readers get the lock if only there's no writer
+   /// holding or waiting for it. See details in the description of the
+   /// \ref tn_rwlock.h "reader-writer locks".
+   TN_RWLOCK_OPT_WRITER_PREF  = (1 << 0),
+};
+
+/**
+ * Reader-writer lock
+ */
+struct TN_RWLock {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_rwlock;
+   ///
+   /// List of tasks that wait for the lock
+   struct TN_ListItem wait_queue;
+   ///
+   /// List of hold records (`struct #TN_RWLockHold`) of all the tasks that
+   /// hold the lock: either readers or the writer
+   struct TN_ListItem holds_list;
+   ///
+   /// Number of tasks that hold the lock for reading
+   int readers_cnt;
+   ///
+   /// Task that holds the lock for writing, or `TN_NULL`
+   struct TN_Task *writer;
+   ///
+   /// Options given to `tn_rwlock_create()`
+   enum TN_RWLockOpt opts;
+   ///
+   /// Priorities of the tasks that wait for the lock
+   struct TN_PrioBmp waiters_prio_bmp;
+   ///
+   /// For each priority present in `waiters_prio_bmp`, number of the tasks
+   /// that wait for the lock with that priority (values for other
+   /// priorities are meaningless)
+   unsigned short waiters_prio_cnt[ TN_PRIORITIES_CNT ];
+};
+
+/**
+ * Record of the reader-writer lock held by some task, to be included in
+ * struct TN_Task (there are `#TN_RWLOCK_HOLDS_MAX` of them)
+ */
+struct TN_RWLockHold {
+   ///
+   /// An item to include in the `holds_list` of the lock
+   struct TN_ListItem holds_list_item;
+   ///
+   /// Lock which is held, or `TN_NULL` if the record is unused
+   struct TN_RWLock *rwlock;
+   ///
+   /// Task which holds the lock
+   struct TN_Task *task;
+   ///
+   /// Lock count: how many times the task has locked it for reading (for
+   /// the writer, it's always `1`)
+   int cnt;
+};
+
+/**
+ * Reader-writer lock-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_RWLockTaskWait {
+   ///
+   /// Whether the task waits to lock it for writing
+   TN_BOOL write;
+   ///
+   /// Whether the lock is granted to the task (if not, the task stopped
+   /// waiting because of timeout, deletion of the lock, etc)
+   TN_BOOL granted;
+};
+
+
+
+/*******************************************************************************
+ *    GLOBAL VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the reader-writer lock. The field `id_rwlock` should not contain
+ * `#TN_ID_RWLOCK`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param rwlock
+ *    Pointer to already allocated `struct TN_RWLock`
+ * @param opts
+ *    Options, see `enum #TN_RWLockOpt`.
+ *
+ * @return
+ *    * `#TN_RC_OK` if lock was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_rwlock_create(
+      struct TN_RWLock   *rwlock,
+      enum TN_RWLockOpt   opts
+      );
+
+/**
+ * Destruct the reader-writer lock.
+ *
+ * All tasks that wait for the lock become runnable with `#TN_RC_DELETED`
+ * code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param rwlock     reader-writer lock to destruct
+ *
+ * @return
+ *    * `#TN_RC_OK` if lock was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_ILLEGAL_USE` if the lock is held by some task other than
+ *      current one;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_rwlock_delete(struct TN_RWLock *rwlock);
+
+/**
+ * Lock the reader-writer lock for reading.
+ *
+ * * If the lock isn't held for writing (and, in case of
+ *   `#TN_RWLOCK_OPT_WRITER_PREF`, no writers wait for it), the current task
+ *   gets it at once;
+ * * If the current task already holds the lock for reading, lock count is
+ *   just incremented, and `#TN_RC_OK` is returned at once;
+ * * Otherwise, the task waits for the lock, and holders of the lock inherit
+ *   its priority (if it is higher). Behavior depends on `timeout` value:
+ *   refer to `#TN_TickCnt`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param rwlock     reader-writer lock to lock
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if lock was successfully locked for reading;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_ILLEGAL_USE` if current task already holds the lock for
+ *      writing;
+ *    * `#TN_RC_OVERFLOW` if current task already holds
+ *      `#TN_RWLOCK_HOLDS_MAX` other reader-writer locks;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_rwlock_read_lock(
+      struct TN_RWLock *rwlock,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_rwlock_read_lock()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_rwlock_read_lock_polling(struct TN_RWLock *rwlock);
+
+/**
+ * Lock the reader-writer lock for writing.
+ *
+ * * If the lock isn't held by anyone, the current task gets it at once;
+ * * Otherwise, the task waits for the lock, and holders of the lock inherit
+ *   its priority (if it is higher). Behavior depends on `timeout` value:
+ *   refer to `#TN_TickCnt`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param rwlock     reader-writer lock to lock
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if lock was successfully locked for writing;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_ILLEGAL_USE` if current task already holds the lock (either
+ *      for reading or for writing);
+ *    * `#TN_RC_OVERFLOW` if current task already holds
+ *      `#TN_RWLOCK_HOLDS_MAX` other reader-writer locks;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_rwlock_write_lock(
+      struct TN_RWLock *rwlock,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_rwlock_write_lock()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_rwlock_write_lock_polling(struct TN_RWLock *rwlock);
+
+/**
+ * Unlock the reader-writer lock held by the current task, either for
+ * reading or for writing. If the lock gets free (or, at least, not held for
+ * writing), waiting tasks get it, and the priority of the current task is
+ * recalculated.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param rwlock     reader-writer lock to unlock
+ *
+ * @return
+ *    * `#TN_RC_OK` if lock was unlocked successfully
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_ILLEGAL_USE` if current task doesn't hold the lock;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_rwlock_unlock(struct TN_RWLock *rwlock);
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_RWLOCK_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -46,6 +46,7 @@
 //-- internal tnkernel headers
 #include "_tn_tasks.h"
 #include "_tn_list.h"
+#include "_tn_wait_any.h"
 
 
 //-- header of current module
@@ -104,27 +105,116 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_create(
    return rc;
 }
 
+/**
+ * Additional param checking for bulk operations: count of units should be
+ * from 1 to `max_count`
+ */
+_TN_STATIC_INLINE enum TN_RCode _check_param_cnt(
+      const struct TN_Sem *sem,
+      int cnt
+      )
+{
+   enum TN_RCode rc = _check_param_generic(sem);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (cnt <= 0 || cnt > sem->max_count){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
 #else
 #  define _check_param_generic(sem)                            (TN_RC_OK)
 #  define _check_param_create(sem, start_count, max_count)     (TN_RC_OK)
+#  define _check_param_cnt(sem, cnt)                           (TN_RC_OK)
 #endif
 // }}}
 
+/**
+ * Returns priority index of the semaphore's wait queue if tasks wait for
+ * the semaphore in priority order, or `TN_NULL` otherwise
+ */
+_TN_STATIC_INLINE struct TN_ListPrioIdx *_wait_queue_prio(struct TN_Sem *sem)
+{
+#if TN_USE_PRIO_WAIT_QUEUES
+   return (sem->attr & TN_SEM_ATTR_PRIO) ? &(sem->wait_queue_prio) : TN_NULL;
+#else
+   _TN_UNUSED(sem);
+   return TN_NULL;
+#endif
+}
+
+
+/**
+ * Hand `avail` units out to the waiting tasks, in FIFO order: the first
+ * task in the wait queue gets all the units it waits for, or nothing (and
+ * then, tasks behind it get nothing as well). If there are no more tasks in
+ * the wait queue, units are given to the tasks that wait for the semaphore
+ * in `tn_wait_any()`, one unit to each.
+ *
+ * NOTE: `sem->count` should be zero while this function is called, so
+ * that `_tn_sem_on_task_wait_complete()` (which is called from
+ * `_tn_task_wait_complete()`) doesn't hand units out on its own.
+ *
+ * @returns count of units that are left.
+ */
+static int _sem_units_distribute(struct TN_Sem *sem, int avail)
+{
+   TN_BOOL stop = TN_FALSE;
+
+   while (!stop && !_tn_list_is_empty(&(sem->wait_queue))){
+      struct TN_Task *task = _tn_list_first_entry(
+            &(sem->wait_queue), struct TN_Task, task_queue
+            );
+
+      if (task->subsys_wait.sem.cnt <= avail){
+         avail -= task->subsys_wait.sem.cnt;
+         _tn_task_wait_complete(task, TN_RC_OK);
+      } else {
+         //-- first task waits for more units than we have: it should
+         //   get them first, so, stop here
+         stop = TN_TRUE;
+      }
+   }
+
+#if TN_USE_WAIT_ANY
+   if (!stop){
+      struct TN_WaitAnyItem *item;
+
+      while (     (avail > 0)
+               && ((item = _tn_wait_any_first_get(&sem->wait_any_list))
+                  != TN_NULL)
+            )
+      {
+         //-- some task waits for the semaphore in tn_wait_any():
+         //   the unit is acquired by that task.
+         _tn_wait_any_item_complete(item, TN_RC_OK);
+         avail--;
+      }
+   }
+#endif
+
+   return avail;
+}
 
 /**
  * Generic function that performs job from task context
  *
  * @param sem        semaphore to perform job on
  * @param p_worker   pointer to actual worker function
+ * @param cnt        count of units to give to `p_worker`
  * @param timeout    see `#TN_TickCnt`
  */
 _TN_STATIC_INLINE enum TN_RCode _sem_job_perform(
       struct TN_Sem *sem,
-      enum TN_RCode (p_worker)(struct TN_Sem *sem),
+      enum TN_RCode (p_worker)(struct TN_Sem *sem, int cnt),
+      int cnt,
       TN_TickCnt timeout
       )
 {
-   enum TN_RCode rc = _check_param_generic(sem);
+   enum TN_RCode rc = _check_param_cnt(sem, cnt);
    TN_BOOL waited_for_sem = TN_FALSE;
 
    if (rc != TN_RC_OK){
@@ -134,13 +224,16 @@ _TN_STATIC_INLINE enum TN_RCode _sem_job_perform(
    } else {
       TN_INTSAVE_DATA;
 
-      TN_INT_DIS_SAVE();      //-- disable interrupts
-      rc = p_worker(sem);     //-- call actual worker function
+      TN_INT_DIS_SAVE();         //-- disable interrupts
+      rc = p_worker(sem, cnt);   //-- call actual worker function
 
       //-- if we should wait, put current task to wait
       if (rc == TN_RC_TIMEOUT && timeout != 0){
-         _tn_task_curr_to_wait_action(
-               &(sem->wait_queue), TN_WAIT_REASON_SEM, timeout
+         _tn_curr_run_task->subsys_wait.sem.cnt = cnt;
+
+         _tn_task_curr_to_wait_action_wprio(
+               &(sem->wait_queue), _wait_queue_prio(sem),
+               TN_WAIT_REASON_SEM, timeout
                );
 
          //-- rc will be set later thanks to waited_for_sem
@@ -170,13 +263,15 @@ _TN_STATIC_INLINE enum TN_RCode _sem_job_perform(
  *
  * @param sem        semaphore to perform job on
  * @param p_worker   pointer to actual worker function
+ * @param cnt        count of units to give to `p_worker`
  */
 _TN_STATIC_INLINE enum TN_RCode _sem_job_iperform(
       struct TN_Sem *sem,
-      enum TN_RCode (p_worker)(struct TN_Sem *sem)
+      enum TN_RCode (p_worker)(struct TN_Sem *sem, int cnt),
+      int cnt
       )
 {
-   enum TN_RCode rc = _check_param_generic(sem);
+   enum TN_RCode rc = _check_param_cnt(sem, cnt);
 
    //-- perform additional params checking (if enabled by TN_CHECK_PARAM)
    if (rc != TN_RC_OK){
@@ -186,46 +281,48 @@ _TN_STATIC_INLINE enum TN_RCode _sem_job_iperform(
    } else {
       TN_INTSAVE_DATA_INT;
 
-      TN_INT_IDIS_SAVE();     //-- disable interrupts
-      rc = p_worker(sem);     //-- call actual worker function
-      TN_INT_IRESTORE();      //-- restore previous interrupts state
+      TN_INT_IDIS_SAVE();        //-- disable interrupts
+      rc = p_worker(sem, cnt);   //-- call actual worker function
+      TN_INT_IRESTORE();         //-- restore previous interrupts state
       _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
    }
    return rc;
 }
 
-_TN_STATIC_INLINE enum TN_RCode _sem_signal(struct TN_Sem *sem)
+_TN_STATIC_INLINE enum TN_RCode _sem_signal(struct TN_Sem *sem, int cnt)
 {
    enum TN_RCode rc = TN_RC_OK;
-
-   //-- wake up first (if any) task from the semaphore wait queue
-   if (  !_tn_task_first_wait_complete(
-            &sem->wait_queue, TN_RC_OK,
-            TN_NULL, TN_NULL, TN_NULL
-            )
-      )
-   {
-      //-- no tasks are waiting for that semaphore,
-      //   so, just increase its count if possible.
-      if (sem->count < sem->max_count){
-         sem->count++;
-      } else {
-         rc = TN_RC_OVERFLOW;
-      }
+   int avail = sem->count + cnt;
+
+   //-- hand units out to the waiting tasks (if any); see comments for
+   //   _sem_units_distribute() on why count is zeroed meanwhile
+   sem->count = 0;
+   avail = _sem_units_distribute(sem, avail);
+
+   //-- the rest of units is kept in the semaphore, as long as it doesn't
+   //   exceed max_count.
+   if (avail > sem->max_count){
+      avail = sem->max_count;
+      rc = TN_RC_OVERFLOW;
    }
 
+   sem->count = avail;
+
    return rc;
 }
 
-_TN_STATIC_INLINE enum TN_RCode _sem_wait(struct TN_Sem *sem)
+_TN_STATIC_INLINE enum TN_RCode _sem_wait(struct TN_Sem *sem, int cnt)
 {
    enum TN_RCode rc = TN_RC_OK;
 
-   //-- decrement semaphore count if possible.
+   //-- decrease semaphore count if possible. Tasks which already wait for
+   //   the semaphore (for more units than available) should get them
+   //   first, so we can't take units until they are done.
+   //
    //   If not, return TN_RC_TIMEOUT
    //   (it is handled in _sem_job_perform() / _sem_job_iperform())
-   if (sem->count > 0){
-      sem->count--;
+   if (sem->count >= cnt && _tn_list_is_empty(&(sem->wait_queue))){
+      sem->count -= cnt;
    } else {
       rc = TN_RC_TIMEOUT;
    }
@@ -244,8 +341,9 @@ _TN_STATIC_INLINE enum TN_RCode _sem_wait(struct TN_Sem *sem)
 /*
  * See comments in the header file (tn_sem.h)
  */
-enum TN_RCode tn_sem_create(
+enum TN_RCode tn_sem_create_wattr(
       struct TN_Sem *sem,
+      enum TN_SemAttr attr,
       int start_count,
       int max_count
       )
@@ -258,9 +356,18 @@ enum TN_RCode tn_sem_create(
    } else {
 
       _tn_list_reset(&(sem->wait_queue));
+#if TN_USE_WAIT_ANY
+      _tn_list_reset(&(sem->wait_any_list));
+#endif
 
       sem->count     = start_count;
       sem->max_count = max_count;
+#if TN_USE_PRIO_WAIT_QUEUES
+      sem->attr      = attr;
+      _tn_list_prio_idx_reset(&(sem->wait_queue_prio));
+#else
+      _TN_UNUSED(attr);
+#endif
       sem->id_sem    = TN_ID_SEMAPHORE;
 
    }
@@ -284,10 +391,17 @@ enum TN_RCode tn_sem_delete(struct TN_Sem * sem)
 
       TN_INT_DIS_SAVE();
 
+      //-- Semaphore does not exist now. NOTE: it should be marked invalid
+      //   before notifying waiting tasks, so that
+      //   _tn_sem_on_task_wait_complete() doesn't hand units out to them.
+      sem->id_sem = TN_ID_NONE;
+
       //-- Remove all tasks from wait queue, returning the TN_RC_DELETED code.
       _tn_wait_queue_notify_deleted(&(sem->wait_queue));
+#if TN_USE_WAIT_ANY
+      _tn_wait_any_notify_deleted(&(sem->wait_any_list));
+#endif
 
-      sem->id_sem = TN_ID_NONE;        //-- Semaphore does not exist now
       TN_INT_RESTORE();
 
       //-- we might need to switch context if _tn_wait_queue_notify_deleted()
@@ -302,7 +416,7 @@ enum TN_RCode tn_sem_delete(struct TN_Sem * sem)
  */
 enum TN_RCode tn_sem_signal(struct TN_Sem *sem)
 {
-   return _sem_job_perform(sem, _sem_signal, 0);
+   return _sem_job_perform(sem, _sem_signal, 1, 0);
 }
 
 /*
@@ -310,7 +424,23 @@ enum TN_RCode tn_sem_signal(struct TN_Sem *sem)
  */
 enum TN_RCode tn_sem_isignal(struct TN_Sem *sem)
 {
-   return _sem_job_iperform(sem, _sem_signal);
+   return _sem_job_iperform(sem, _sem_signal, 1);
+}
+
+/*
+ * See comments in the header file (tn_sem.h)
+ */
+enum TN_RCode tn_sem_signal_n(struct TN_Sem *sem, int cnt)
+{
+   return _sem_job_perform(sem, _sem_signal, cnt, 0);
+}
+
+/*
+ * See comments in the header file (tn_sem.h)
+ */
+enum TN_RCode tn_sem_isignal_n(struct TN_Sem *sem, int cnt)
+{
+   return _sem_job_iperform(sem, _sem_signal, cnt);
 }
 
 /*
@@ -318,7 +448,15 @@ enum TN_RCode tn_sem_isignal(struct TN_Sem *sem)
  */
 enum TN_RCode tn_sem_wait(struct TN_Sem *sem, TN_TickCnt timeout)
 {
-   return _sem_job_perform(sem, _sem_wait, timeout);
+   return _sem_job_perform(sem, _sem_wait, 1, timeout);
+}
+
+/*
+ * See comments in the header file (tn_sem.h)
+ */
+enum TN_RCode tn_sem_wait_n(struct TN_Sem *sem, int cnt, TN_TickCnt timeout)
+{
+   return _sem_job_perform(sem, _sem_wait, cnt, timeout);
 }
 
 /*
@@ -326,7 +464,7 @@ enum TN_RCode tn_sem_wait(struct TN_Sem *sem, TN_TickCnt timeout)
  */
 enum TN_RCode tn_sem_wait_polling(struct TN_Sem *sem)
 {
-   return _sem_job_perform(sem, _sem_wait, 0);
+   return _sem_job_perform(sem, _sem_wait, 1, 0);
 }
 
 /*
@@ -334,7 +472,48 @@ enum TN_RCode tn_sem_wait_polling(struct TN_Sem *sem)
  */
 enum TN_RCode tn_sem_iwait_polling(struct TN_Sem *sem)
 {
-   return _sem_job_iperform(sem, _sem_wait);
+   return _sem_job_iperform(sem, _sem_wait, 1);
+}
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+#if TN_USE_WAIT_ANY
+/*
+ * See comments in the header file (_tn_sem.h)
+ */
+enum TN_RCode _tn_sem_wait_polling(struct TN_Sem *sem)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   return _sem_wait(sem, 1);
+}
+#endif
+
+/*
+ * See comments in the header file (_tn_sem.h)
+ */
+void _tn_sem_on_task_wait_complete(struct TN_Task *task)
+{
+   struct TN_Sem *sem = container_of(task->pwait_queue, struct TN_Sem, wait_queue);
+
+   //-- If there are units in the semaphore, the task which stops waiting
+   //   waited for more units than available, and it might be the first
+   //   task in the queue (say, it stopped waiting by timeout). Then,
+   //   tasks behind it may be able to get units now.
+   //
+   //   NOTE: if the task is woken up by _sem_units_distribute(), count is
+   //   zero, so nothing happens here.
+   if (sem->count > 0 && _tn_sem_is_valid(sem)){
+      int avail = sem->count;
+
+      sem->count = 0;
+      sem->count = _sem_units_distribute(sem, avail);
+   }
 }
 
 
@@ -60,6 +60,29 @@
  * In addition to the article mentioned above, you may want to look at the
  * [related question on stackoverflow.com](http://goo.gl/ZBReHK).
  *
+ * \section tn_sem__bulk Bulk operations
+ *
+ * Semaphore may be signaled and waited for by more than one unit at a time:
+ * see `tn_sem_signal_n()`, `tn_sem_isignal_n()` and `tn_sem_wait_n()`. All
+ * the units are handled in a single critical section, which is much cheaper
+ * than calling `tn_sem_signal()` in a loop, and also guarantees that no other
+ * task gets in between.
+ *
+ * Waiting tasks are served in strict FIFO order (or in priority order, if
+ * semaphore is created with `#TN_SEM_ATTR_PRIO`), and the request of each
+ * task is satisfied entirely or not at all: there are no partial grants.
+ * When units are added to the semaphore, they are handed out to the waiting
+ * tasks one by one, starting from the first one in the queue; if the first
+ * task waits for more units than available, it keeps waiting, and so do
+ * all the tasks behind it, even though smaller requests could be
+ * satisfied. Similarly, a task that calls `tn_sem_wait_n()` while there are
+ * other tasks waiting doesn't get units before them. This way, a task that
+ * waits for many units can't be starved by tasks that take units one by one.
+ *
+ * When the first task stops waiting without getting units (say, because of
+ * timeout, or `tn_task_release_wait()`), the units which are available in
+ * the semaphore are handed out to the tasks behind it.
+ *
  */
 
 #ifndef _TN_SEM_H
@@ -82,6 +105,23 @@ extern "C"  {     /*}*/
  *    PUBLIC TYPES
  ******************************************************************************/
 
+/**
+ * Attributes that could be given to the semaphore, see
+ * `tn_sem_create_wattr()`.
+ */
+enum TN_SemAttr {
+   ///
+   /// No special attributes: waiting tasks are served in FIFO order.
+   TN_SEM_ATTR_NONE           = (0),
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Waiting tasks are served in the order of their priority; tasks with
+   /// the same priority are served in FIFO order. Available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   TN_SEM_ATTR_PRIO           = (1 << 0),
+#endif
+};
+
 /**
  * Semaphore
  */
@@ -100,6 +140,36 @@ struct TN_Sem {
    ///
    /// Max value of `count`
    int max_count;
+
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// Attributes given to the semaphore, available if only
+   /// `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero.
+   enum TN_SemAttr attr;
+   ///
+   /// Priority index of `wait_queue`, used if only the semaphore is created
+   /// with `#TN_SEM_ATTR_PRIO`. Available if only `#TN_USE_PRIO_WAIT_QUEUES`
+   /// option is non-zero.
+   struct TN_ListPrioIdx wait_queue_prio;
+#endif
+
+#if TN_USE_WAIT_ANY || defined(DOXYGEN_ACTIVE)
+   ///
+   /// List of items of the tasks that wait for the semaphore in
+   /// `tn_wait_any()`, available if only `#TN_USE_WAIT_ANY` option is
+   /// non-zero.
+   struct TN_ListItem wait_any_list;
+#endif
+};
+
+/**
+ * Semaphore-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_SemTaskWait {
+   ///
+   /// count of units the task waits for
+   int cnt;
 };
 
 
@@ -115,6 +185,25 @@ struct TN_Sem {
  *    PUBLIC FUNCTION PROTOTYPES
  ******************************************************************************/
 
+/**
+ * The same as `tn_sem_create()`, but takes additional argument: `attr`.
+ *
+ * @param sem
+ *    Pointer to already allocated `struct TN_Sem`
+ * @param attr
+ *    Attributes for that particular semaphore, see `enum #TN_SemAttr`
+ * @param start_count
+ *    Initial counter value, typically it is equal to `max_count`
+ * @param max_count
+ *    Maximum counter value.
+ */
+enum TN_RCode tn_sem_create_wattr(
+      struct TN_Sem *sem,
+      enum TN_SemAttr attr,
+      int start_count,
+      int max_count
+      );
+
 /**
  * Construct the semaphore. `id_sem` field should not contain
  * `#TN_ID_SEMAPHORE`, otherwise, `#TN_RC_WPARAM` is returned.
@@ -135,11 +224,14 @@ struct TN_Sem {
  *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
  *      is available: `#TN_RC_WPARAM`.
  */
-enum TN_RCode tn_sem_create(
+_TN_STATIC_INLINE enum TN_RCode tn_sem_create(
       struct TN_Sem *sem,
       int start_count,
       int max_count
-      );
+      )
+{
+   return tn_sem_create_wattr(sem, TN_SEM_ATTR_NONE, start_count, max_count);
+}
 
 /**
  * Destruct the semaphore.
@@ -197,6 +289,48 @@ enum TN_RCode tn_sem_signal(struct TN_Sem *sem);
  */
 enum TN_RCode tn_sem_isignal(struct TN_Sem *sem);
 
+/**
+ * Signal the semaphore by `cnt` units at once, in a single critical section.
+ *
+ * Units are handed out to the waiting tasks in FIFO order: the first task
+ * in the wait queue becomes runnable (with `#TN_RC_OK` returned from
+ * `tn_sem_wait()` or `tn_sem_wait_n()`) if all the units it waits for are
+ * available, and so on. As soon as some task waits for more units than
+ * available, the rest of the units is added to the semaphore counter
+ * (`count`), and that task (as well as all the tasks behind it) keeps
+ * waiting. See \ref tn_sem__bulk for details.
+ *
+ * If the counter would exceed `max_count`, it is set to `max_count`, the
+ * excess is discarded and `#TN_RC_OVERFLOW` is returned; waiting tasks
+ * are served anyway.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param sem     semaphore to signal
+ * @param cnt     count of units to add, from `1` to `max_count`
+ *
+ * @return
+ *    * `#TN_RC_OK` if successful
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_OVERFLOW` if some units were discarded because `count`
+ *      would exceed `max_count`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_sem_signal_n(struct TN_Sem *sem, int cnt);
+
+/**
+ * The same as `tn_sem_signal_n()` but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ */
+enum TN_RCode tn_sem_isignal_n(struct TN_Sem *sem, int cnt);
+
 /**
  * Wait for the semaphore.
  *
@@ -206,6 +340,11 @@ enum TN_RCode tn_sem_isignal(struct TN_Sem *sem);
  * tn_sem_signal "signaled" the semaphore or until the `timeout` expired. refer
  * to `#TN_TickCnt`.
  *
+ * Waiting tasks are served in FIFO order: if there are tasks already waiting
+ * for the semaphore (which is possible with non-zero `count` if the first
+ * task waits for several units, see `tn_sem_wait_n()`), the caller can't
+ * get the unit before them.
+ *
  * $(TN_CALL_FROM_TASK)
  * $(TN_CAN_SWITCH_CONTEXT)
  * $(TN_CAN_SLEEP)
@@ -223,6 +362,35 @@ enum TN_RCode tn_sem_isignal(struct TN_Sem *sem);
  */
 enum TN_RCode tn_sem_wait(struct TN_Sem *sem, TN_TickCnt timeout);
 
+/**
+ * Wait for `cnt` units of the semaphore at once.
+ *
+ * The units are taken all together or not at all: if the current
+ * semaphore counter (`count`) is at least `cnt` and there are no other
+ * tasks waiting for the semaphore, it is decreased by `cnt` and `#TN_RC_OK`
+ * is returned. Otherwise, behavior depends on `timeout` value: task might
+ * switch to $(TN_TASK_STATE_WAIT) state until it gets all the `cnt` units
+ * (in FIFO order with other waiting tasks, see \ref tn_sem__bulk) or until
+ * the `timeout` expired. refer to `#TN_TickCnt`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param sem     semaphore to wait for
+ * @param cnt     count of units to wait for, from `1` to `max_count`
+ * @param timeout refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if waiting was successfull, `cnt` units are taken
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`; in this case, no units are taken.
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_sem_wait_n(struct TN_Sem *sem, int cnt, TN_TickCnt timeout);
+
 /**
  * The same as `tn_sem_wait()` with zero timeout.
  *
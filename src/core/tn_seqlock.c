@@ -0,0 +1,461 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+#include "tn_seqlock.h"
+#include "_tn_seqlock.h"
+
+#include "tn_tasks.h"
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_SeqLock *seqlock
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (seqlock == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_seqlock_is_valid(seqlock)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_SeqLock *seqlock,
+      void *data_buf,
+      unsigned int data_size
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (seqlock == TN_NULL || data_buf == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (data_size == 0 || _tn_seqlock_is_valid(seqlock)){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_job(
+      const struct TN_SeqLock *seqlock,
+      const void *p_data
+      )
+{
+   enum TN_RCode rc = _check_param_generic(seqlock);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (p_data == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_read_next(
+      const struct TN_SeqLock *seqlock,
+      const void *p_data,
+      const TN_UWord *p_seq
+      )
+{
+   enum TN_RCode rc = _check_param_job(seqlock, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (p_seq == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(seqlock)                        (TN_RC_OK)
+#  define _check_param_create(seqlock, data_buf, data_size)    (TN_RC_OK)
+#  define _check_param_job(seqlock, p_data)                    (TN_RC_OK)
+#  define _check_param_read_next(seqlock, p_data, p_seq)       (TN_RC_OK)
+#endif
+// }}}
+
+/**
+ * Returns pointer to the copy of the data which is current when the sequence
+ * number is `seq`.
+ */
+_TN_STATIC_INLINE volatile unsigned char *_copy_ptr(
+      const struct TN_SeqLock *seqlock,
+      TN_UWord seq
+      )
+{
+   return seqlock->data_buf + ((seq & 1) ? seqlock->copy_offset : 0);
+}
+
+/**
+ * Writer side: copy new data to the copy which isn't current, and publish it
+ * by incrementing the sequence number. Lock-free: should be called by the
+ * single writer only.
+ */
+static void _seqlock_write(
+      struct TN_SeqLock *seqlock,
+      const void *p_data
+      )
+{
+   TN_UWord seq = seqlock->seq;
+   volatile unsigned char *p_dst = _copy_ptr(seqlock, seq + 1);
+   const unsigned char *p_src = (const unsigned char *)p_data;
+   unsigned int i;
+
+   //-- copy data first (through volatile pointer, so that the compiler
+   //   can't move it past the sequence number update), and then publish it.
+   for (i = 0; i < seqlock->data_size; i++){
+      p_dst[i] = p_src[i];
+   }
+
+   seqlock->seq = seq + 1;
+}
+
+/**
+ * Reader side: copy the current data out, retrying if the writer might have
+ * started overwriting it in the meantime. Lock-free: may be called by any
+ * number of readers.
+ *
+ * The copy that is current for the sequence number `seq` is overwritten only
+ * by the write that starts after the sequence number becomes `(seq + 1)`, so
+ * if the sequence number is still the same after the copying, the data is
+ * consistent.
+ *
+ * @return sequence number of the data that was read
+ */
+static TN_UWord _seqlock_read(
+      const struct TN_SeqLock *seqlock,
+      void *p_data
+      )
+{
+   TN_UWord seq;
+   unsigned char *p_dst = (unsigned char *)p_data;
+
+   do {
+      volatile unsigned char *p_src;
+      unsigned int i;
+
+      seq = seqlock->seq;
+      p_src = _copy_ptr(seqlock, seq);
+
+      for (i = 0; i < seqlock->data_size; i++){
+         p_dst[i] = p_src[i];
+      }
+   } while (seqlock->seq != seq);
+
+   return seq;
+}
+
+/**
+ * Checks whether some task waits for the next update. Reading of the list
+ * head is atomic; the reader is put to the wait queue with interrupts
+ * disabled, after checking the sequence number once again, so if the writer
+ * sees empty wait queue here after the data is published, the reader will
+ * see the new sequence number.
+ *
+ * The list head is read through volatile pointer: `seq` is volatile, so the
+ * compiler can't move this read before the publishing of the data. With
+ * plain read, it could, since the list isn't volatile.
+ */
+_TN_STATIC_INLINE TN_BOOL _readers_wait(const struct TN_SeqLock *seqlock)
+{
+   struct TN_ListItem *const volatile *p_next = &(seqlock->wait_queue.next);
+
+   //-- the same as `!_tn_list_is_empty()`, but inline: it's a hot path
+   return (*p_next != &seqlock->wait_queue);
+}
+
+/**
+ * Wake up all the tasks that wait for the next update.
+ *
+ * \attention Caller must disable interrupts.
+ */
+static void _readers_wake_all(struct TN_SeqLock *seqlock)
+{
+   while (
+         _tn_task_first_wait_complete(
+            &seqlock->wait_queue, TN_RC_OK, TN_NULL, TN_NULL, TN_NULL
+            )
+         )
+   {
+      //-- task is woken up, proceed to the next one
+   }
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_seqlock.h)
+ */
+enum TN_RCode tn_seqlock_create(
+      struct TN_SeqLock *seqlock,
+      void *data_buf,
+      unsigned int data_size
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_create(seqlock, data_buf, data_size);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      _tn_list_reset(&(seqlock->wait_queue));
+
+      seqlock->data_buf    = (volatile unsigned char *)data_buf;
+      seqlock->data_size   = data_size;
+      seqlock->copy_offset = TN_MAKE_ALIG_SIZE(data_size);
+      seqlock->seq         = 0;
+
+      seqlock->id_seqlock = TN_ID_SEQLOCK;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_seqlock.h)
+ */
+enum TN_RCode tn_seqlock_delete(struct TN_SeqLock *seqlock)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_generic(seqlock);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- notify waiting tasks that the object is deleted
+      //   (TN_RC_DELETED is returned)
+      _tn_wait_queue_notify_deleted(&(seqlock->wait_queue));
+
+      seqlock->id_seqlock = TN_ID_NONE; //-- seqlock does not exist now
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_seqlock.h)
+ */
+enum TN_RCode tn_seqlock_write(
+      struct TN_SeqLock *seqlock,
+      const void *p_data
+      )
+{
+   enum TN_RCode rc = _check_param_job(seqlock, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      _seqlock_write(seqlock, p_data);
+
+      if (_readers_wait(seqlock)){
+         //-- slow path: some tasks wait for the update, wake them up.
+         TN_INTSAVE_DATA;
+
+         TN_INT_DIS_SAVE();
+         _readers_wake_all(seqlock);
+         TN_INT_RESTORE();
+         _tn_context_switch_pend_if_needed();
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_seqlock.h)
+ */
+enum TN_RCode tn_seqlock_iwrite(
+      struct TN_SeqLock *seqlock,
+      const void *p_data
+      )
+{
+   enum TN_RCode rc = _check_param_job(seqlock, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      _seqlock_write(seqlock, p_data);
+
+      if (_readers_wait(seqlock)){
+         //-- slow path: some tasks wait for the update, wake them up.
+         //   (they might have stopped waiting by timeout in the meantime,
+         //   `_tn_task_first_wait_complete()` handles it)
+         TN_INTSAVE_DATA_INT;
+
+         TN_INT_IDIS_SAVE();
+         _readers_wake_all(seqlock);
+         TN_INT_IRESTORE();
+         _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_seqlock.h)
+ */
+enum TN_RCode tn_seqlock_read(
+      struct TN_SeqLock *seqlock,
+      void *p_data,
+      TN_UWord *p_seq
+      )
+{
+   enum TN_RCode rc = _check_param_job(seqlock, p_data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      TN_UWord seq = _seqlock_read(seqlock, p_data);
+
+      if (p_seq != TN_NULL){
+         *p_seq = seq;
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_seqlock.h)
+ */
+enum TN_RCode tn_seqlock_read_next(
+      struct TN_SeqLock *seqlock,
+      void *p_data,
+      TN_UWord *p_seq,
+      TN_TickCnt timeout
+      )
+{
+   enum TN_RCode rc = _check_param_read_next(seqlock, p_data, p_seq);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else if (seqlock->seq != *p_seq){
+      //-- fast path: newer data is there already
+      *p_seq = _seqlock_read(seqlock, p_data);
+   } else if (timeout == 0){
+      rc = TN_RC_TIMEOUT;
+   } else {
+      TN_BOOL waited = TN_FALSE;
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- The writer might have written new data after we've checked the
+      //   sequence number: check it once again, now with interrupts
+      //   disabled. If it's still the same, go to wait: the writer will see
+      //   us in the wait queue after it publishes the next data.
+      if (seqlock->seq == *p_seq){
+         _tn_task_curr_to_wait_action(
+               &(seqlock->wait_queue),
+               TN_WAIT_REASON_SEQLOCK,
+               timeout
+               );
+         waited = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+      }
+
+      if (rc == TN_RC_OK){
+         //-- new data is there
+         *p_seq = _seqlock_read(seqlock, p_data);
+      }
+   }
+
+   return rc;
+}
+
+
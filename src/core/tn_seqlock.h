@@ -0,0 +1,382 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * A seqlock is a shared data object for the single-writer / many-readers
+ * case: one task (or ISR) updates some state (configuration, sensor
+ * snapshot, etc), and any number of tasks and ISRs read it.
+ *
+ * Unlike protecting the data with \ref tn_mutex.h "mutex", readers never
+ * block, never disable interrupts and never contend with each other: there's
+ * no lock to take at all. Instead, the seqlock keeps two copies of the data
+ * (double buffer) and the sequence number of the last write:
+ *
+ * - The writer copies new data to the copy which isn't current, and then
+ *   publishes it by incrementing the sequence number, so the current copy is
+ *   never modified while it is current.
+ * - The reader remembers the sequence number, copies the current copy out,
+ *   and checks the sequence number once again. If it has changed, the writer
+ *   might have started overwriting the copy being read (that happens only if
+ *   the writer has completed one write and started another one while the
+ *   reader was copying), so the reader retries.
+ *
+ * So, the ISR which interrupts the writer reads the data at once, without
+ * retries; the reader task retries only if it is preempted by the writer for
+ * a time long enough to write the data twice.
+ *
+ * Besides that, the reader task may wait for the next update by
+ * `tn_seqlock_read_next()`: it uses ordinary wait queue of the kernel. The
+ * writer checks whether there are waiting tasks after publishing the data,
+ * and only in this case takes the slow path: disables interrupts and wakes
+ * all of them up.
+ *
+ * Restrictions that come with it:
+ *
+ * - There should be at most one writer at a time. If there are several ones,
+ *   the application should serialize them (say, by the mutex which is taken
+ *   by writers only).
+ * - Data is copied byte by byte through `volatile` pointer, so that the
+ *   compiler can't move the copying past the sequence number access. Keep
+ *   the data reasonably small.
+ *
+ */
+
+#ifndef _TN_SEQLOCK_H
+#define _TN_SEQLOCK_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Structure representing seqlock
+ */
+struct TN_SeqLock {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_seqlock;
+   ///
+   /// list of tasks waiting for the next update
+   struct TN_ListItem  wait_queue;
+
+   ///
+   /// buffer for two copies of the data, each one is at the offset which is
+   /// multiple of `sizeof(#TN_UWord)`
+   volatile unsigned char *data_buf;
+   ///
+   /// size of the data, in bytes
+   unsigned int   data_size;
+   ///
+   /// offset of the second copy of the data in `data_buf`, in bytes
+   unsigned int   copy_offset;
+   ///
+   /// sequence number: count of writes (it wraps around). The current copy
+   /// of the data is the one with the index `(seq & 1)`. Written by the
+   /// writer only.
+   volatile TN_UWord seq;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Convenience macro for the definition of buffer for the seqlock (two copies
+ * of the data). See `tn_seqlock_create()` for usage example.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_seqlock_create()` function as the `data_buf` argument)
+ * @param data_type
+ *    Type of the data, like `struct MySensorData`.
+ */
+#define TN_SEQLOCK_BUF_DEF(name, data_type)                          \
+   TN_UWord name[                                                    \
+      2 * (TN_MAKE_ALIG_SIZE(sizeof(data_type)) / sizeof(TN_UWord))  \
+      ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the seqlock. `id_seqlock` member should not contain
+ * `#TN_ID_SEQLOCK`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * Initial value of the data is taken from the first copy in the buffer
+ * (i.e. from the first `data_size` bytes of `data_buf`), so, for the buffer
+ * defined statically, it is all zeros.
+ *
+ * Typical usage looks as follows:
+ *
+ * \code{.c}
+ *     struct MySensorData {
+ *        int temperature;
+ *        int pressure;
+ *     };
+ *
+ *     //-- define buffer and seqlock structure
+ *     TN_SEQLOCK_BUF_DEF(sensor_buf, struct MySensorData);
+ *     struct TN_SeqLock sensor_seqlock;
+ *
+ *     void init(void)
+ *     {
+ *        tn_seqlock_create(
+ *              &sensor_seqlock, sensor_buf, sizeof(struct MySensorData)
+ *              );
+ *     }
+ *
+ *     //-- the only writer
+ *     void sensor_task_body(void *param)
+ *     {
+ *        struct MySensorData data;
+ *        for (;;){
+ *           //-- measure data
+ *           tn_seqlock_write(&sensor_seqlock, &data);
+ *        }
+ *     }
+ *
+ *     //-- any number of readers that just get the latest data
+ *     void some_task_body(void *param)
+ *     {
+ *        struct MySensorData data;
+ *        tn_seqlock_read(&sensor_seqlock, &data, TN_NULL);
+ *     }
+ *
+ *     //-- reader that handles each update (skipping the ones that happen
+ *     //   while it is busy)
+ *     void logger_task_body(void *param)
+ *     {
+ *        struct MySensorData data;
+ *        TN_UWord seq;
+ *
+ *        tn_seqlock_read(&sensor_seqlock, &data, &seq);
+ *        for (;;){
+ *           tn_seqlock_read_next(
+ *                 &sensor_seqlock, &data, &seq, TN_WAIT_INFINITE
+ *                 );
+ *           //-- log data
+ *        }
+ *     }
+ * \endcode
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param seqlock    pointer to already allocated struct TN_SeqLock.
+ * @param data_buf   pointer to already allocated buffer for two copies of
+ *                   the data (see `TN_SEQLOCK_BUF_DEF()`), it must be
+ *                   aligned properly.
+ * @param data_size  size of the data, in bytes. Should be non-zero.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if seqlock was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_seqlock_create(
+      struct TN_SeqLock *seqlock,
+      void *data_buf,
+      unsigned int data_size
+      );
+
+/**
+ * Destruct the seqlock.
+ *
+ * All tasks that wait for the next update become runnable with
+ * `#TN_RC_DELETED` code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param seqlock    pointer to seqlock to be deleted
+ *
+ * @return 
+ *    * `#TN_RC_OK` if seqlock was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_seqlock_delete(struct TN_SeqLock *seqlock);
+
+/**
+ * Write new data: `data_size` bytes are copied from `p_data`. Interrupts are
+ * not disabled, unless there are tasks waiting for the next update: in this
+ * case, all of them are woken up.
+ *
+ * Only one writer (either task or ISR) is allowed at a time.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param seqlock    pointer to seqlock to write data to
+ * @param p_data     pointer to new data
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if data was successfully written;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_seqlock_write(
+      struct TN_SeqLock *seqlock,
+      const void *p_data
+      );
+
+/**
+ * The same as `tn_seqlock_write()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_seqlock_iwrite(
+      struct TN_SeqLock *seqlock,
+      const void *p_data
+      );
+
+/**
+ * Read the current data: `data_size` bytes are copied to `p_data`. It never
+ * blocks and never disables interrupts: if the data is overwritten while it
+ * is being copied, it is just copied once again.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param seqlock    pointer to seqlock to read data from
+ * @param p_data     pointer to buffer of at least `data_size` bytes to
+ *                   store the data at
+ * @param p_seq      pointer to store the sequence number of the data that
+ *                   was read, to be given to `tn_seqlock_read_next()` later.
+ *                   May be `TN_NULL`.
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if data was successfully read;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_seqlock_read(
+      struct TN_SeqLock *seqlock,
+      void *p_data,
+      TN_UWord *p_seq
+      );
+
+/**
+ * Read the data which is newer than the one with the sequence number
+ * `*p_seq` (as stored by previous `tn_seqlock_read()` or
+ * `tn_seqlock_read_next()`). If there is newer data already, it is read at
+ * once; otherwise, behavior depends on the `timeout` value: refer to
+ * `#TN_TickCnt`.
+ *
+ * If the data is written several times before the task gets to it, only the
+ * latest one is read.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param seqlock    pointer to seqlock to read data from
+ * @param p_data     pointer to buffer of at least `data_size` bytes to
+ *                   store the data at
+ * @param p_seq      pointer to the sequence number of the data that the
+ *                   task has already read; the sequence number of the new
+ *                   data is stored there.
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if data was successfully read;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_seqlock_read_next(
+      struct TN_SeqLock *seqlock,
+      void *p_data,
+      TN_UWord *p_seq,
+      TN_TickCnt timeout
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_SEQLOCK_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -0,0 +1,947 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+#include "tn_stream.h"
+#include "_tn_stream.h"
+
+#include "tn_tasks.h"
+
+//-- std header for memcpy()
+#include <string.h>
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_StreamBuf *stream
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (stream == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_stream_is_valid(stream)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size,
+      TN_UWord trigger_level
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (stream == TN_NULL || buf == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (
+         size == 0
+         || trigger_level == 0 || trigger_level > size
+         || _tn_stream_is_valid(stream)
+         )
+   {
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_trigger_level(
+      const struct TN_StreamBuf *stream,
+      TN_UWord trigger_level
+      )
+{
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (trigger_level == 0 || trigger_level > stream->size){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_job(
+      const struct TN_StreamBuf *stream,
+      const void *ptr
+      )
+{
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (ptr == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(stream)                                (TN_RC_OK)
+#  define _check_param_create(stream, buf, size, trigger_level)       (TN_RC_OK)
+#  define _check_param_trigger_level(stream, trigger_level)           (TN_RC_OK)
+#  define _check_param_job(stream, ptr)                               (TN_RC_OK)
+#endif
+// }}}
+
+_TN_STATIC_INLINE TN_UWord _min(TN_UWord a, TN_UWord b)
+{
+   return (a < b) ? a : b;
+}
+
+//-- Storage processing {{{
+
+/**
+ * Compute the region of `cnt` bytes which starts at `idx` and might wrap
+ * around the end of the buffer.
+ */
+static void _region_get(
+      struct TN_StreamBuf *stream,
+      TN_UWord idx,
+      TN_UWord cnt,
+      struct TN_StreamRegion *region
+      )
+{
+   region->ptr1   = stream->buf + idx;
+   region->size1  = _min(cnt, stream->size - idx);
+   region->size2  = cnt - region->size1;
+   region->ptr2   = (region->size2 != 0) ? stream->buf : TN_NULL;
+}
+
+/**
+ * Returns index advanced by `cnt` bytes, wrapping around the end of the
+ * buffer.
+ */
+_TN_STATIC_INLINE TN_UWord _idx_advance(
+      struct TN_StreamBuf *stream,
+      TN_UWord idx,
+      TN_UWord cnt
+      )
+{
+   idx += cnt;
+   if (idx >= stream->size){
+      idx -= stream->size;
+   }
+   return idx;
+}
+
+/**
+ * Returns count of free bytes available for copying writers: if write region
+ * is acquired, the free space is reserved for the acquirer.
+ */
+_TN_STATIC_INLINE TN_UWord _free_cnt(struct TN_StreamBuf *stream)
+{
+   return stream->write_acquired
+      ? 0
+      : (stream->size - stream->filled_cnt);
+}
+
+/**
+ * Returns count of stored bytes available for copying readers: if read region
+ * is acquired, the data is reserved for the acquirer.
+ */
+_TN_STATIC_INLINE TN_UWord _used_cnt(struct TN_StreamBuf *stream)
+{
+   return stream->read_acquired
+      ? 0
+      : stream->filled_cnt;
+}
+
+/**
+ * Copy as many bytes from `data` to the buffer as fit (up to `size`).
+ * Returns count of copied bytes.
+ */
+static TN_UWord _buf_write(
+      struct TN_StreamBuf *stream,
+      const unsigned char *data,
+      TN_UWord size
+      )
+{
+   struct TN_StreamRegion region;
+   TN_UWord cnt = _min(size, _free_cnt(stream));
+
+   _region_get(stream, stream->head_idx, cnt, &region);
+
+   memcpy(region.ptr1, data, region.size1);
+   if (region.size2 != 0){
+      memcpy(region.ptr2, data + region.size1, region.size2);
+   }
+
+   stream->head_idx = _idx_advance(stream, stream->head_idx, cnt);
+   stream->filled_cnt += cnt;
+
+   return cnt;
+}
+
+/**
+ * Copy as many bytes from the buffer to `buf` as available (up to `size`).
+ * Returns count of copied bytes.
+ */
+static TN_UWord _buf_read(
+      struct TN_StreamBuf *stream,
+      unsigned char *buf,
+      TN_UWord size
+      )
+{
+   struct TN_StreamRegion region;
+   TN_UWord cnt = _min(size, _used_cnt(stream));
+
+   _region_get(stream, stream->tail_idx, cnt, &region);
+
+   memcpy(buf, region.ptr1, region.size1);
+   if (region.size2 != 0){
+      memcpy(buf + region.size1, region.ptr2, region.size2);
+   }
+
+   stream->tail_idx = _idx_advance(stream, stream->tail_idx, cnt);
+   stream->filled_cnt -= cnt;
+
+   return cnt;
+}
+
+/**
+ * Whether reader which wants `size` bytes can be satisfied right now,
+ * see \ref stream_trigger.
+ */
+_TN_STATIC_INLINE TN_BOOL _read_is_ready(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      )
+{
+   return (_used_cnt(stream) >= _min(stream->trigger_level, size));
+}
+
+// }}}
+
+/**
+ * Serve waiting tasks after the state of the stream buffer has changed:
+ *
+ * - The first waiting reader gets its data and is woken up, if there is
+ *   enough data for it (see \ref stream_trigger);
+ * - The first waiting writer gets as much of its data written as fits, and
+ *   it is woken up when all its data is written.
+ *
+ * Serving a reader frees room for writers, and vice versa, so it's repeated
+ * until nobody can be served.
+ *
+ * Should be called with interrupts disabled.
+ */
+static void _waiters_serve(struct TN_StreamBuf *stream)
+{
+   TN_BOOL progress = TN_TRUE;
+   struct TN_Task *task;
+   struct TN_StreamTaskWait *wait;
+
+   while (progress){
+      progress = TN_FALSE;
+
+      if (!_tn_list_is_empty(&stream->wait_receive_list)){
+         task = _tn_get_task_by_tsk_queue(stream->wait_receive_list.next);
+         wait = &task->subsys_wait.stream;
+
+         if (_read_is_ready(stream, wait->size)){
+            wait->done_cnt = _buf_read(stream, wait->read_ptr, wait->size);
+            _tn_task_wait_complete(task, TN_RC_OK);
+            progress = TN_TRUE;
+         }
+      }
+
+      if (!_tn_list_is_empty(&stream->wait_send_list)){
+         TN_UWord cnt;
+         task = _tn_get_task_by_tsk_queue(stream->wait_send_list.next);
+         wait = &task->subsys_wait.stream;
+
+         cnt = _buf_write(
+               stream,
+               wait->write_ptr + wait->done_cnt,
+               wait->size - wait->done_cnt
+               );
+
+         if (cnt != 0){
+            wait->done_cnt += cnt;
+            if (wait->done_cnt == wait->size){
+               _tn_task_wait_complete(task, TN_RC_OK);
+            }
+            progress = TN_TRUE;
+         }
+      }
+   }
+}
+
+/**
+ * Write as much data as fits and serve the waiters. Should be called with
+ * interrupts disabled.
+ *
+ * Waiting reader might take the data written so far and free the room, so
+ * writing is repeated while it makes progress: otherwise, the writer could
+ * go to wait for room in the empty buffer.
+ *
+ * @return count of written bytes.
+ */
+static TN_UWord _stream_write(
+      struct TN_StreamBuf *stream,
+      const void *data,
+      TN_UWord size
+      )
+{
+   const unsigned char *ptr = (const unsigned char *)data;
+   TN_UWord cnt = 0;
+   TN_UWord portion_cnt;
+
+   do {
+      portion_cnt = _buf_write(stream, ptr + cnt, size - cnt);
+      cnt += portion_cnt;
+      _waiters_serve(stream);
+   } while (portion_cnt != 0 && cnt < size);
+
+   return cnt;
+}
+
+/**
+ * Read as much data as available and serve the waiters. Should be called
+ * with interrupts disabled.
+ *
+ * @return count of read bytes.
+ */
+static TN_UWord _stream_read(
+      struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size
+      )
+{
+   TN_UWord cnt = _buf_read(stream, (unsigned char *)buf, size);
+   _waiters_serve(stream);
+   return cnt;
+}
+
+/**
+ * Commit acquired write or read region. Should be called with interrupts
+ * disabled.
+ */
+static enum TN_RCode _commit(
+      struct TN_StreamBuf *stream,
+      TN_BOOL write,
+      TN_UWord size
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (write){
+      if (!stream->write_acquired){
+         rc = TN_RC_ILLEGAL_USE;
+      } else if (size > stream->write_acq_cnt){
+         rc = TN_RC_WPARAM;
+      } else {
+         stream->write_acquired = TN_FALSE;
+         stream->head_idx = _idx_advance(stream, stream->head_idx, size);
+         stream->filled_cnt += size;
+      }
+   } else {
+      if (!stream->read_acquired){
+         rc = TN_RC_ILLEGAL_USE;
+      } else if (size > stream->read_acq_cnt){
+         rc = TN_RC_WPARAM;
+      } else {
+         stream->read_acquired = TN_FALSE;
+         stream->tail_idx = _idx_advance(stream, stream->tail_idx, size);
+         stream->filled_cnt -= size;
+      }
+   }
+
+   if (rc == TN_RC_OK){
+      _waiters_serve(stream);
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_create(
+      struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size,
+      TN_UWord trigger_level
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_create(stream, buf, size, trigger_level);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      _tn_list_reset(&(stream->wait_send_list));
+      _tn_list_reset(&(stream->wait_receive_list));
+
+      stream->buf             = (unsigned char *)buf;
+      stream->size            = size;
+      stream->filled_cnt      = 0;
+      stream->head_idx        = 0;
+      stream->tail_idx        = 0;
+      stream->trigger_level   = trigger_level;
+      stream->write_acq_cnt   = 0;
+      stream->read_acq_cnt    = 0;
+      stream->write_acquired  = TN_FALSE;
+      stream->read_acquired   = TN_FALSE;
+
+      stream->id_stream = TN_ID_STREAMBUF;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_delete(struct TN_StreamBuf *stream)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   rc = _check_param_generic(stream);
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- notify waiting tasks that the object is deleted
+      //   (TN_RC_DELETED is returned)
+      _tn_wait_queue_notify_deleted(&(stream->wait_send_list));
+      _tn_wait_queue_notify_deleted(&(stream->wait_receive_list));
+
+      stream->id_stream = TN_ID_NONE; //-- stream buffer does not exist now
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_trigger_level_set(
+      struct TN_StreamBuf *stream,
+      TN_UWord trigger_level
+      )
+{
+   enum TN_RCode rc = _check_param_trigger_level(stream, trigger_level);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      stream->trigger_level = trigger_level;
+      _waiters_serve(stream);
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_write(
+      struct TN_StreamBuf *stream,
+      const void *data,
+      TN_UWord size,
+      TN_UWord *p_written,
+      TN_TickCnt timeout
+      )
+{
+   TN_BOOL waited = TN_FALSE;
+   TN_UWord cnt = 0;
+   enum TN_RCode rc = _check_param_job(stream, data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      cnt = _stream_write(stream, data, size);
+
+      if (cnt == size){
+         rc = TN_RC_OK;
+      } else if (timeout != 0){
+         //-- Not all data fits, and user asked to wait: the rest will
+         //   be written by readers as the room appears, see
+         //   `_waiters_serve()`
+         struct TN_StreamTaskWait *wait = &_tn_curr_run_task->subsys_wait.stream;
+         wait->write_ptr   = (const unsigned char *)data;
+         wait->size        = size;
+         wait->done_cnt    = cnt;
+
+         _tn_task_curr_to_wait_action(
+               &(stream->wait_send_list),
+               TN_WAIT_REASON_STREAM_WSEND,
+               timeout
+               );
+         waited = TN_TRUE;
+      } else {
+         rc = TN_RC_TIMEOUT;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+         //-- get wait result and number of bytes written while we waited
+         rc = _tn_curr_run_task->task_wait_rc;
+         cnt = _tn_curr_run_task->subsys_wait.stream.done_cnt;
+      }
+   }
+
+   if (p_written != TN_NULL){
+      *p_written = cnt;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_iwrite(
+      struct TN_StreamBuf *stream,
+      const void *data,
+      TN_UWord size,
+      TN_UWord *p_written
+      )
+{
+   TN_UWord cnt = 0;
+   enum TN_RCode rc = _check_param_job(stream, data);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      cnt = _stream_write(stream, data, size);
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+
+      rc = (cnt == size) ? TN_RC_OK : TN_RC_TIMEOUT;
+   }
+
+   if (p_written != TN_NULL){
+      *p_written = cnt;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_read(
+      struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size,
+      TN_UWord *p_read,
+      TN_TickCnt timeout
+      )
+{
+   TN_BOOL waited = TN_FALSE;
+   TN_UWord cnt = 0;
+   enum TN_RCode rc = _check_param_job(stream, buf);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      if (timeout == 0 || _read_is_ready(stream, size)){
+         //-- just read what we have
+         cnt = _stream_read(stream, buf, size);
+         rc = (cnt != 0 || size == 0) ? TN_RC_OK : TN_RC_TIMEOUT;
+      } else {
+         //-- Not enough data, and user asked to wait: the data will be
+         //   read for us by the writer, see `_waiters_serve()`
+         struct TN_StreamTaskWait *wait = &_tn_curr_run_task->subsys_wait.stream;
+         wait->read_ptr    = (unsigned char *)buf;
+         wait->size        = size;
+         wait->done_cnt    = 0;
+
+         _tn_task_curr_to_wait_action(
+               &(stream->wait_receive_list),
+               TN_WAIT_REASON_STREAM_WRECEIVE,
+               timeout
+               );
+         waited = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+         cnt = _tn_curr_run_task->subsys_wait.stream.done_cnt;
+
+         if (rc == TN_RC_TIMEOUT){
+            //-- trigger level wasn't reached: get what we have.
+            //   (the stream buffer might be deleted in the meantime,
+            //   so check it)
+            TN_INT_DIS_SAVE();
+            if (_tn_stream_is_valid(stream)){
+               cnt = _stream_read(stream, buf, size);
+               if (cnt != 0){
+                  rc = TN_RC_OK;
+               }
+            }
+            TN_INT_RESTORE();
+            _tn_context_switch_pend_if_needed();
+         }
+      }
+   }
+
+   if (p_read != TN_NULL){
+      *p_read = cnt;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_iread(
+      struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size,
+      TN_UWord *p_read
+      )
+{
+   TN_UWord cnt = 0;
+   enum TN_RCode rc = _check_param_job(stream, buf);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      cnt = _stream_read(stream, buf, size);
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+
+      rc = (cnt != 0 || size == 0) ? TN_RC_OK : TN_RC_TIMEOUT;
+   }
+
+   if (p_read != TN_NULL){
+      *p_read = cnt;
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_write_acquire(
+      struct TN_StreamBuf *stream,
+      struct TN_StreamRegion *region
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_job(stream, region);
+
+   if (rc == TN_RC_OK){
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      if (stream->write_acquired){
+         rc = TN_RC_ILLEGAL_USE;
+      } else if (stream->filled_cnt == stream->size){
+         rc = TN_RC_TIMEOUT;
+      } else {
+         stream->write_acq_cnt = stream->size - stream->filled_cnt;
+         stream->write_acquired = TN_TRUE;
+         _region_get(stream, stream->head_idx, stream->write_acq_cnt, region);
+      }
+
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_write_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      )
+{
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _commit(stream, TN_TRUE, size);
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_iwrite_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      )
+{
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      rc = _commit(stream, TN_TRUE, size);
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_read_acquire(
+      struct TN_StreamBuf *stream,
+      struct TN_StreamRegion *region
+      )
+{
+   TN_UWord sr_saved;
+   enum TN_RCode rc = _check_param_job(stream, region);
+
+   if (rc == TN_RC_OK){
+      sr_saved = tn_arch_sr_save_int_dis();
+
+      if (stream->read_acquired){
+         rc = TN_RC_ILLEGAL_USE;
+      } else if (stream->filled_cnt == 0){
+         rc = TN_RC_TIMEOUT;
+      } else {
+         stream->read_acq_cnt = stream->filled_cnt;
+         stream->read_acquired = TN_TRUE;
+         _region_get(stream, stream->tail_idx, stream->read_acq_cnt, region);
+      }
+
+      tn_arch_sr_restore(sr_saved);
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_read_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      )
+{
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _commit(stream, TN_FALSE, size);
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+enum TN_RCode tn_stream_iread_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      )
+{
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      rc = _commit(stream, TN_FALSE, size);
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+int tn_stream_used_cnt_get(
+      struct TN_StreamBuf *stream
+      )
+{
+   int ret = -1;
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc == TN_RC_OK){
+      //-- It's not needed to disable interrupts here, since `filled_cnt`
+      //   is read by just one assembler instruction.
+      ret = (int)stream->filled_cnt;
+   }
+
+   return ret;
+}
+
+
+/*
+ * See comments in the header file (tn_stream.h)
+ */
+int tn_stream_free_cnt_get(
+      struct TN_StreamBuf *stream
+      )
+{
+   int ret = -1;
+   enum TN_RCode rc = _check_param_generic(stream);
+
+   if (rc == TN_RC_OK){
+      //-- It's not needed to disable interrupts here, since `filled_cnt`
+      //   is read by just one assembler instruction, and `size` never
+      //   changes.
+      ret = (int)(stream->size - stream->filled_cnt);
+   }
+
+   return ret;
+}
+
+
@@ -0,0 +1,556 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * A stream buffer is a FIFO of bytes, intended for variable-length byte
+ * streams: UART or USB CDC data, log output, etc. Unlike \ref tn_dqueue.h
+ * "data queue" with \ref tn_fmem.h "memory pool" blocks, it doesn't waste
+ * space for partially filled blocks, and it is a single object.
+ *
+ * There are two ways to put data to the stream buffer and to get data out of
+ * it:
+ *
+ * - Copying: `tn_stream_write()` and `tn_stream_read()` (and their ISR
+ *   variants) copy data from the caller's buffer to the stream buffer and
+ *   back;
+ * - Zero-copy: `tn_stream_write_acquire()` hands out the free space of the
+ *   stream buffer as (at most) two contiguous regions, see `struct
+ *   #TN_StreamRegion`; the caller (or DMA) fills them directly and then calls
+ *   `tn_stream_write_commit()` with the number of bytes written. Reading
+ *   works in the same way: `tn_stream_read_acquire()` hands out the stored
+ *   data, and `tn_stream_read_commit()` frees the consumed part of it. Two
+ *   regions are needed because the free space (stored data) may wrap around
+ *   the end of the buffer.
+ *
+ * \section stream_trigger Trigger level
+ *
+ * A task that waits for data (`tn_stream_read()`) is woken up not as soon as
+ * the first byte arrives, but when the amount of stored data reaches the
+ * trigger level (or the number of bytes the task asked for, whichever is
+ * less). This way, writing of a stream byte by byte (say, from UART ISR)
+ * doesn't cause a context switch per byte. The trigger level is given to
+ * `tn_stream_create()` and can be changed by `tn_stream_trigger_level_set()`.
+ * If the wait times out, the task gets whatever data is stored.
+ *
+ * A task that waits for room (`tn_stream_write()`) gets its data copied
+ * part by part as the room appears, and is woken up when all its data is
+ * written (or on timeout, with the number of bytes written so far).
+ *
+ * \section stream_acquire Acquired regions
+ *
+ * While a write region is acquired, nobody else can write to the stream
+ * buffer: the free space is reserved for the acquirer, so other writers
+ * behave as if the buffer is full. The same applies to reading: while a read
+ * region is acquired, other readers behave as if the buffer is empty. Only
+ * one region of each kind can be acquired at a time.
+ *
+ */
+
+#ifndef _TN_STREAM_H
+#define _TN_STREAM_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Structure representing stream buffer object
+ */
+struct TN_StreamBuf {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId id_stream;
+   ///
+   /// list of tasks waiting to write data
+   struct TN_ListItem  wait_send_list;
+   ///
+   /// list of tasks waiting to read data
+   struct TN_ListItem  wait_receive_list;
+
+   ///
+   /// buffer to store data
+   unsigned char *buf;
+   ///
+   /// size of `buf`, in bytes
+   TN_UWord       size;
+   ///
+   /// count of stored bytes
+   TN_UWord       filled_cnt;
+   ///
+   /// index of the byte which will be written next time
+   TN_UWord       head_idx;
+   ///
+   /// index of the byte which will be read next time
+   TN_UWord       tail_idx;
+   ///
+   /// see \ref stream_trigger
+   TN_UWord       trigger_level;
+   ///
+   /// size of acquired write region (valid if only `write_acquired` is set)
+   TN_UWord       write_acq_cnt;
+   ///
+   /// size of acquired read region (valid if only `read_acquired` is set)
+   TN_UWord       read_acq_cnt;
+   ///
+   /// whether write region is acquired, see \ref stream_acquire
+   TN_BOOL        write_acquired;
+   ///
+   /// whether read region is acquired, see \ref stream_acquire
+   TN_BOOL        read_acquired;
+};
+
+/**
+ * Region of the stream buffer handed out by `tn_stream_write_acquire()` or
+ * `tn_stream_read_acquire()`: at most two contiguous spans. The second span
+ * is non-empty if only the region wraps around the end of the buffer; it
+ * always starts at the beginning of the buffer.
+ */
+struct TN_StreamRegion {
+   ///
+   /// start of the first span
+   unsigned char *ptr1;
+   ///
+   /// size of the first span, in bytes
+   TN_UWord       size1;
+   ///
+   /// start of the second span (`#TN_NULL` if `size2` is 0)
+   unsigned char *ptr2;
+   ///
+   /// size of the second span, in bytes
+   TN_UWord       size2;
+};
+
+/**
+ * StreamBuf-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_StreamTaskWait {
+   /// if task waits to write data, pointer to the data
+   const unsigned char *write_ptr;
+   ///
+   /// if task waits to read data, pointer to the buffer to store data at
+   unsigned char *read_ptr;
+   ///
+   /// number of bytes task wants to write (read)
+   TN_UWord size;
+   ///
+   /// number of bytes already written (read) while task waits
+   TN_UWord done_cnt;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct stream buffer. `id_stream` member should not contain
+ * `#TN_ID_STREAMBUF`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream        pointer to already allocated struct TN_StreamBuf.
+ * @param buf           pointer to already allocated buffer of `size` bytes
+ * @param size          size of `buf`, should be non-zero.
+ * @param trigger_level see \ref stream_trigger; should be from 1 to `size`.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if stream buffer was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_stream_create(
+      struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size,
+      TN_UWord trigger_level
+      );
+
+/**
+ * Destruct stream buffer.
+ *
+ * All tasks that wait for writing to or reading from the stream buffer become
+ * runnable with `#TN_RC_DELETED` code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream     pointer to stream buffer to be deleted
+ *
+ * @return 
+ *    * `#TN_RC_OK` if stream buffer was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_stream_delete(struct TN_StreamBuf *stream);
+
+/**
+ * Set trigger level of the stream buffer, see \ref stream_trigger. If the
+ * task waiting for data is satisfied with the new level, it is woken up.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream        pointer to stream buffer
+ * @param trigger_level new trigger level, from 1 to the size of the buffer
+ *
+ * @return 
+ *    * `#TN_RC_OK` if trigger level was set;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_stream_trigger_level_set(
+      struct TN_StreamBuf *stream,
+      TN_UWord trigger_level
+      );
+
+/**
+ * Write `size` bytes from `data` to the stream buffer.
+ *
+ * As many bytes as fit are copied at once. If not all of them fit,
+ * behavior depends on the `timeout` value (refer to `#TN_TickCnt`): the task
+ * waits while the rest of data is copied part by part, as the room appears,
+ * and it is woken up when all data is written. While the task waits, `data`
+ * should stay untouched.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream     pointer to stream buffer to write data to
+ * @param data       data to write
+ * @param size       number of bytes to write
+ * @param p_written  number of actually written bytes is stored here (which
+ *                   is less than `size` if only the return code is not
+ *                   `#TN_RC_OK`); can be `#TN_NULL`.
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if all data was written;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_stream_write(
+      struct TN_StreamBuf *stream,
+      const void *data,
+      TN_UWord size,
+      TN_UWord *p_written,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_stream_write()` with zero timeout, but for using in the
+ * ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_stream_iwrite(
+      struct TN_StreamBuf *stream,
+      const void *data,
+      TN_UWord size,
+      TN_UWord *p_written
+      );
+
+/**
+ * Read up to `size` bytes from the stream buffer to `buf`.
+ *
+ * If the stream buffer stores at least `size` bytes or at least trigger level
+ * bytes (see \ref stream_trigger), the data is copied at once. Otherwise,
+ * behavior depends on the `timeout` value (refer to `#TN_TickCnt`): the task
+ * waits until there is enough data. If the wait times out, the task gets the
+ * data stored at the moment, if any. With zero `timeout`, the data stored at
+ * the moment (if any) is copied, regardless of the trigger level.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream     pointer to stream buffer to read data from
+ * @param buf        buffer to store data at
+ * @param size       size of `buf`, in bytes
+ * @param p_read     number of actually read bytes is stored here;
+ *                   can be `#TN_NULL`.
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if some data was read;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_stream_read(
+      struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size,
+      TN_UWord *p_read,
+      TN_TickCnt timeout
+      );
+
+/**
+ * The same as `tn_stream_read()` with zero timeout, but for using in the
+ * ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_stream_iread(
+      struct TN_StreamBuf *stream,
+      void *buf,
+      TN_UWord size,
+      TN_UWord *p_read
+      );
+
+/**
+ * Acquire all the free space of the stream buffer for writing, see \ref
+ * stream_acquire. Fill the region and call `tn_stream_write_commit()` (or
+ * `tn_stream_iwrite_commit()`) then.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream     pointer to stream buffer
+ * @param region     free space is stored here
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if region was acquired;
+ *    * `#TN_RC_TIMEOUT` if there is no free space; nothing is acquired;
+ *    * `#TN_RC_ILLEGAL_USE` if write region is already acquired;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_stream_write_acquire(
+      struct TN_StreamBuf *stream,
+      struct TN_StreamRegion *region
+      );
+
+/**
+ * Commit `size` bytes written to the region acquired by
+ * `tn_stream_write_acquire()`, and release the region. Data is committed
+ * from the beginning of the region; `size` can be 0 to just release the
+ * region. Tasks waiting for data are woken up, if needed.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream     pointer to stream buffer
+ * @param size       number of bytes written, not more than the region size
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if data was committed;
+ *    * `#TN_RC_ILLEGAL_USE` if write region is not acquired;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_stream_write_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      );
+
+/**
+ * The same as `tn_stream_write_commit()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_stream_iwrite_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      );
+
+/**
+ * Acquire all the data stored in the stream buffer for reading, see \ref
+ * stream_acquire. Consume the region and call `tn_stream_read_commit()` (or
+ * `tn_stream_iread_commit()`) then.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream     pointer to stream buffer
+ * @param region     stored data is stored here
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if region was acquired;
+ *    * `#TN_RC_TIMEOUT` if there is no data; nothing is acquired;
+ *    * `#TN_RC_ILLEGAL_USE` if read region is already acquired;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_stream_read_acquire(
+      struct TN_StreamBuf *stream,
+      struct TN_StreamRegion *region
+      );
+
+/**
+ * Free `size` bytes consumed from the region acquired by
+ * `tn_stream_read_acquire()`, and release the region. Data is freed from the
+ * beginning of the region; `size` can be 0 to just release the region. Tasks
+ * waiting for room are served, if needed.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream     pointer to stream buffer
+ * @param size       number of bytes consumed, not more than the region size
+ *
+ * @return  
+ *    * `#TN_RC_OK`   if data was freed;
+ *    * `#TN_RC_ILLEGAL_USE` if read region is not acquired;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_stream_read_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      );
+
+/**
+ * The same as `tn_stream_read_commit()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_stream_iread_commit(
+      struct TN_StreamBuf *stream,
+      TN_UWord size
+      );
+
+/**
+ * Returns number of bytes stored in the stream buffer
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream
+ *    Pointer to stream buffer.
+ *
+ * @return
+ *    Number of stored bytes, or -1 if wrong params were given (the check is
+ *    performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_stream_used_cnt_get(
+      struct TN_StreamBuf *stream
+      );
+
+/**
+ * Returns number of free bytes in the stream buffer
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stream
+ *    Pointer to stream buffer.
+ *
+ * @return
+ *    Number of free bytes, or -1 if wrong params were given (the check is
+ *    performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_stream_free_cnt_get(
+      struct TN_StreamBuf *stream
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_STREAM_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
@@ -103,7 +103,12 @@ struct TN_Task *_tn_next_task_to_run;
 struct TN_Task *_tn_curr_run_task;
 
 // See comments in the internal/_tn_sys.h file
-volatile unsigned int _tn_ready_to_run_bmp;
+volatile unsigned int _tn_ready_to_run_bmp[ _TN_READY_BMP_WORDS_CNT ];
+
+#if _TN_READY_BMP_WORDS_CNT > 1
+// See comments in the internal/_tn_sys.h file
+volatile unsigned int _tn_ready_to_run_bmp_summary;
+#endif
 
 // See comments in the internal/_tn_sys.h file
 struct TN_Task _tn_idle_task;
@@ -139,6 +144,15 @@ TN_CBDeadlock *_tn_cb_deadlock = TN_NULL;
 /// Time slice values for each available priority, in system ticks.
 unsigned short _tn_tslice_ticks[TN_PRIORITIES_CNT];
 
+/// One-shot timer which expires when the time slice of `#_tn_tslice_task`
+/// is over. It is active only while the next task to run has at least one
+/// more runnable task with the same priority, and round-robin is enabled
+/// for that priority; so, there's no per-tick round-robin overhead.
+struct TN_Timer _tn_tslice_timer;
+
+/// Task which `#_tn_tslice_timer` is armed for, or `TN_NULL`.
+struct TN_Task *_tn_tslice_task;
+
 #if TN_MUTEX_DEADLOCK_DETECT
 /// Number of deadlocks active at the moment. Normally it is equal to 0.
 int _tn_deadlocks_cnt = 0;
@@ -178,58 +192,77 @@ static void _idle_task_body(void *par)
 }
 
 /**
- * Manage round-robin (if used)
+ * Checks whether the time slice timer is needed for the given task (which is
+ * the next task to run): round-robin should be enabled for its priority, and
+ * there should be more than one runnable task with this priority.
  */
-#if TN_DYNAMIC_TICK
+_TN_STATIC_INLINE TN_BOOL _tslice_is_needed(struct TN_Task *task)
+{
+   struct TN_ListItem *pri_queue = &(_tn_tasks_ready_list[task->priority]);
 
-_TN_STATIC_INLINE void _round_robin_manage(void) {
-   /*TODO: round-robin should be powered by timers mechanism.
-    * So, when round-robin is active, the system isn't so "tickless".
-    */
+   //-- the queue is never empty here: it contains `task`
+   return (
+         _tn_tslice_ticks[task->priority] != TN_NO_TIME_SLICE
+         && pri_queue->next->next != pri_queue
+         );
 }
 
-#else
-
-_TN_STATIC_INLINE void _round_robin_manage(void)
+/**
+ * The time slice of the given task is over: if it is the head of the ready
+ * queue of its priority, and there are other tasks in this queue, move it
+ * to the tail of the queue.
+ */
+static void _tslice_task_rotate(struct TN_Task *task)
 {
-   //-- Manage round robin if only context switch is not already needed for
-   //   some other reason
-   if (_tn_curr_run_task == _tn_next_task_to_run) {
-      //-- volatile is used here only to solve
-      //   IAR(c) compiler's high optimization mode problem
-      _TN_VOLATILE_WORKAROUND struct TN_ListItem *curr_que;
-      _TN_VOLATILE_WORKAROUND struct TN_ListItem *pri_queue;
-      _TN_VOLATILE_WORKAROUND int priority = _tn_curr_run_task->priority;
-
-      if (_tn_tslice_ticks[priority] != TN_NO_TIME_SLICE){
-         _tn_curr_run_task->tslice_count++;
-
-         if (_tn_curr_run_task->tslice_count >= _tn_tslice_ticks[priority]){
-            _tn_curr_run_task->tslice_count = 0;
-
-            pri_queue = &(_tn_tasks_ready_list[priority]);
-            //-- If ready queue is not empty and there are more than 1 
-            //   task in the queue
-            if (     !(_tn_list_is_empty((struct TN_ListItem *)pri_queue))
-                  && pri_queue->next->next != pri_queue
-               )
-            {
-               //-- Remove task from head and add it to the tail of
-               //-- ready queue for current priority
-
-               curr_que = _tn_list_remove_head(&(_tn_tasks_ready_list[priority]));
-               _tn_list_add_tail(&(_tn_tasks_ready_list[priority]), curr_que);
-
-               _tn_next_task_to_run = _tn_get_task_by_tsk_queue(
-                     _tn_tasks_ready_list[priority].next
-                     );
-            }
-         }
+   struct TN_ListItem *pri_queue = &(_tn_tasks_ready_list[task->priority]);
+
+   if (     pri_queue->next == &(task->task_queue)
+         && pri_queue->prev != &(task->task_queue)
+      )
+   {
+      //-- Remove task from head and add it to the tail of
+      //-- ready queue for current priority
+      _tn_list_add_tail(pri_queue, _tn_list_remove_head(pri_queue));
+
+      if (_tn_next_task_to_run == task){
+         _tn_next_task_to_run = _tn_get_task_by_tsk_queue(pri_queue->next);
       }
    }
 }
 
-#endif
+/**
+ * Callback of the time slice timer `#_tn_tslice_timer`: the time slice of
+ * `#_tn_tslice_task` is over, so, move it to the tail of the ready queue of
+ * its priority, and arm the timer for the task which becomes the next one
+ * to run.
+ */
+static void _tslice_timer_func(struct TN_Timer *timer, void *p_user_data)
+{
+   TN_INTSAVE_DATA_INT;
+
+   TN_INT_IDIS_SAVE();
+
+   //-- timer callback is called with interrupts enabled, so, some interrupt
+   //   might have already re-armed the timer for another task. If so,
+   //   there's nothing to do here.
+   if (!_tn_timer_is_active(timer) && _tn_tslice_task != TN_NULL){
+      struct TN_Task *task = _tn_tslice_task;
+
+      _tn_tslice_task = TN_NULL;
+      task->tslice_count = 0;
+
+      _tslice_task_rotate(task);
+
+      //-- arm the timer for the new next task to run (if needed)
+      _tn_sys_tslice_update();
+   }
+
+   TN_INT_IRESTORE();
+
+   //-- context switch (if needed) is pended by `tn_tick_int_processing()`
+
+   _TN_UNUSED(p_user_data);
+}
 
 
 #if _TN_ON_CONTEXT_SWITCH_HANDLER
@@ -454,10 +487,22 @@ static void _build_cfg_check(void)
       _TN_FATAL_ERROR("TN_MUTEX_DEADLOCK_DETECT doesn't match");
    }
 
+   if (kernel_build_cfg.use_rwlocks != app_build_cfg->use_rwlocks){
+      _TN_FATAL_ERROR("TN_USE_RWLOCKS doesn't match");
+   }
+
+   if (kernel_build_cfg.rwlock_holds_max != app_build_cfg->rwlock_holds_max){
+      _TN_FATAL_ERROR("TN_RWLOCK_HOLDS_MAX doesn't match");
+   }
+
    if (kernel_build_cfg.tick_lists_cnt_minus_one != app_build_cfg->tick_lists_cnt_minus_one){
       _TN_FATAL_ERROR("TN_TICK_LISTS_CNT doesn't match");
    }
 
+   if (kernel_build_cfg.tick_lists_levels != app_build_cfg->tick_lists_levels){
+      _TN_FATAL_ERROR("TN_TICK_LISTS_LEVELS doesn't match");
+   }
+
    if (kernel_build_cfg.api_make_alig_arg != app_build_cfg->api_make_alig_arg){
       _TN_FATAL_ERROR("TN_API_MAKE_ALIG_ARG doesn't match");
    }
@@ -478,6 +523,38 @@ static void _build_cfg_check(void)
       _TN_FATAL_ERROR("TN_DYNAMIC_TICK doesn't match");
    }
 
+   if (kernel_build_cfg.dynamic_tick_heap != app_build_cfg->dynamic_tick_heap){
+      _TN_FATAL_ERROR("TN_DYNAMIC_TICK_HEAP doesn't match");
+   }
+
+   if (kernel_build_cfg.timer_task != app_build_cfg->timer_task){
+      _TN_FATAL_ERROR("TN_TIMER_TASK doesn't match");
+   }
+
+   if (kernel_build_cfg.tlsf_fl_index_max != app_build_cfg->tlsf_fl_index_max){
+      _TN_FATAL_ERROR("TN_TLSF_FL_INDEX_MAX doesn't match");
+   }
+
+   if (  kernel_build_cfg.eventgrp_wait_lists_cnt
+         != app_build_cfg->eventgrp_wait_lists_cnt)
+   {
+      _TN_FATAL_ERROR("TN_EVENTGRP_WAIT_LISTS_CNT doesn't match");
+   }
+
+   if (kernel_build_cfg.use_wait_any != app_build_cfg->use_wait_any){
+      _TN_FATAL_ERROR("TN_USE_WAIT_ANY doesn't match");
+   }
+
+   if (kernel_build_cfg.use_task_notify != app_build_cfg->use_task_notify){
+      _TN_FATAL_ERROR("TN_USE_TASK_NOTIFY doesn't match");
+   }
+
+   if (  kernel_build_cfg.use_prio_wait_queues
+         != app_build_cfg->use_prio_wait_queues)
+   {
+      _TN_FATAL_ERROR("TN_USE_PRIO_WAIT_QUEUES doesn't match");
+   }
+
    if (kernel_build_cfg.old_events_api != app_build_cfg->old_events_api){
       _TN_FATAL_ERROR("TN_OLD_EVENT_API doesn't match");
    }
@@ -528,6 +605,11 @@ void tn_sys_start(
    //-- init timers
    _tn_timers_init();
 
+   //-- create time slice timer (it is started on demand, see
+   //   `_tn_sys_tslice_update()`)
+   _tn_timer_create(&_tn_tslice_timer, _tslice_timer_func, TN_NULL);
+   _tn_tslice_task = TN_NULL;
+
    //-- check that build configuration for the kernel and application match
    //   (if only TN_CHECK_BUILD_CFG is non-zero)
    _build_cfg_check();
@@ -548,7 +630,12 @@ void tn_sys_start(
    _tn_sys_state = (enum TN_StateFlag)(0);  
 
    //-- reset bitmask of priorities with runnable tasks
-   _tn_ready_to_run_bmp = 0;
+   for (i = 0; i < _TN_READY_BMP_WORDS_CNT; i++){
+      _tn_ready_to_run_bmp[i] = 0;
+   }
+#if _TN_READY_BMP_WORDS_CNT > 1
+   _tn_ready_to_run_bmp_summary = 0;
+#endif
 
    //-- reset pointers to currently running task and next task to run
    _tn_next_task_to_run = TN_NULL;
@@ -597,6 +684,11 @@ void tn_sys_start(
 #endif
 #endif
 
+#if TN_TIMER_TASK
+   //-- create timer task (see \ref timers_task)
+   _tn_timer_task_create();
+#endif
+
    //-- now, we can create user's task(s)
    //   (by user-provided callback)
    cb_user_task_create();
@@ -627,12 +719,9 @@ void tn_tick_int_processing(void)
    //-- check stack overflow
    _tn_sys_stack_overflow_check(_tn_curr_run_task);
 
-   //-- manage timers
+   //-- manage timers (round-robin is managed by the time slice timer as well)
    _tn_timers_tick_proceed(TN_INTSAVE_VAR);
 
-   //-- manage round-robin (if used)
-   _round_robin_manage();
-
    TN_INT_IRESTORE();
    _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
 }
@@ -656,6 +745,10 @@ enum TN_RCode tn_sys_tslice_set(int priority, int ticks)
 
       TN_INT_DIS_SAVE();
       _tn_tslice_ticks[priority] = ticks;
+
+      //-- round-robin for the priority of the next task to run might have
+      //   just been turned on or off
+      _tn_sys_tslice_update();
       TN_INT_RESTORE();
    }
    return rc;
@@ -803,6 +896,54 @@ enum TN_StateFlag _tn_sys_state_flags_clear(enum TN_StateFlag flags)
    return ret;
 }
 
+/**
+ * See comments in the file _tn_sys.h
+ */
+void _tn_sys_tslice_update(void)
+{
+   struct TN_Task *task = _tn_next_task_to_run;
+
+   if (     _tn_tslice_task != TN_NULL
+         && (_tn_tslice_task != task || !_tslice_is_needed(task))
+      )
+   {
+      //-- the task which timer is armed for is preempted (or round-robin
+      //   isn't needed for it anymore): remember the rest of its time slice,
+      //   so that it is continued when the task is going to run again
+      struct TN_Task *prev_task = _tn_tslice_task;
+      TN_TickCnt time_left = _tn_timer_time_left(&_tn_tslice_timer);
+
+      _tn_timer_cancel(&_tn_tslice_timer);
+      _tn_tslice_task = TN_NULL;
+
+      if (time_left == 0 || time_left == TN_WAIT_INFINITE){
+         //-- the time slice is over right in this tick (the timer just hasn't
+         //   fired yet), so, the task goes to the tail of its ready queue
+         //   now, just like the timer callback would do
+         prev_task->tslice_count = 0;
+         _tslice_task_rotate(prev_task);
+
+         //-- the rotation might have changed the next task to run
+         task = _tn_next_task_to_run;
+      } else {
+         prev_task->tslice_count = (int)time_left;
+      }
+   }
+
+   if (_tn_tslice_task == TN_NULL && _tslice_is_needed(task)){
+      //-- start new time slice, or continue the interrupted one
+      TN_TickCnt timeout = _tn_tslice_ticks[task->priority];
+
+      if (task->tslice_count > 0 && task->tslice_count < (int)timeout){
+         timeout = task->tslice_count;
+      }
+      task->tslice_count = 0;
+
+      _tn_tslice_task = task;
+      _tn_timer_start(&_tn_tslice_timer, timeout);
+   }
+}
+
 
 #if TN_MUTEX_DEADLOCK_DETECT
 /**
@@ -126,12 +126,22 @@ struct TN_Mutex;
    (_p_struct)->use_mutexes               = TN_USE_MUTEXES;             \
    (_p_struct)->mutex_rec                 = TN_MUTEX_REC;               \
    (_p_struct)->mutex_deadlock_detect     = TN_MUTEX_DEADLOCK_DETECT;   \
+   (_p_struct)->use_rwlocks               = TN_USE_RWLOCKS;             \
+   (_p_struct)->rwlock_holds_max          = TN_RWLOCK_HOLDS_MAX;        \
    (_p_struct)->tick_lists_cnt_minus_one  = (TN_TICK_LISTS_CNT - 1);    \
+   (_p_struct)->tick_lists_levels         = TN_TICK_LISTS_LEVELS;       \
    (_p_struct)->api_make_alig_arg         = TN_API_MAKE_ALIG_ARG;       \
    (_p_struct)->profiler                  = TN_PROFILER;                \
    (_p_struct)->profiler_wait_time        = TN_PROFILER_WAIT_TIME;      \
    (_p_struct)->stack_overflow_check      = TN_STACK_OVERFLOW_CHECK;    \
    (_p_struct)->dynamic_tick              = TN_DYNAMIC_TICK;            \
+   (_p_struct)->dynamic_tick_heap         = TN_DYNAMIC_TICK_HEAP;       \
+   (_p_struct)->timer_task                = TN_TIMER_TASK;              \
+   (_p_struct)->tlsf_fl_index_max         = TN_TLSF_FL_INDEX_MAX;       \
+   (_p_struct)->eventgrp_wait_lists_cnt   = TN_EVENTGRP_WAIT_LISTS_CNT; \
+   (_p_struct)->use_wait_any              = TN_USE_WAIT_ANY;            \
+   (_p_struct)->use_task_notify           = TN_USE_TASK_NOTIFY;         \
+   (_p_struct)->use_prio_wait_queues      = TN_USE_PRIO_WAIT_QUEUES;    \
    (_p_struct)->old_events_api            = TN_OLD_EVENT_API;           \
                                                                         \
    _TN_BUILD_CFG_ARCH_STRUCT_FILL(_p_struct);                           \
@@ -169,7 +179,7 @@ struct TN_Mutex;
 struct _TN_BuildCfg {
    ///
    /// Value of `#TN_PRIORITIES_CNT`
-   unsigned          priorities_cnt             : 7;
+   unsigned          priorities_cnt             : 11;
    ///
    /// Value of `#TN_CHECK_PARAM`
    unsigned          check_param                : 1;
@@ -188,9 +198,18 @@ struct _TN_BuildCfg {
    /// Value of `#TN_MUTEX_DEADLOCK_DETECT`
    unsigned          mutex_deadlock_detect      : 1;
    ///
+   /// Value of `#TN_USE_RWLOCKS`
+   unsigned          use_rwlocks                : 1;
+   ///
+   /// Value of `#TN_RWLOCK_HOLDS_MAX`
+   unsigned          rwlock_holds_max           : 8;
+   ///
    /// Value of `#TN_TICK_LISTS_CNT` minus one
    unsigned          tick_lists_cnt_minus_one   : 8;
    ///
+   /// Value of `#TN_TICK_LISTS_LEVELS`
+   unsigned          tick_lists_levels          : 6;
+   ///
    /// Value of `#TN_API_MAKE_ALIG_ARG`
    unsigned          api_make_alig_arg          : 2;
    ///
@@ -206,6 +225,27 @@ struct _TN_BuildCfg {
    /// Value of `#TN_DYNAMIC_TICK`
    unsigned          dynamic_tick               : 1;
    ///
+   /// Value of `#TN_DYNAMIC_TICK_HEAP`
+   unsigned          dynamic_tick_heap          : 1;
+   ///
+   /// Value of `#TN_TIMER_TASK`
+   unsigned          timer_task                 : 1;
+   ///
+   /// Value of `#TN_TLSF_FL_INDEX_MAX`
+   unsigned          tlsf_fl_index_max          : 6;
+   ///
+   /// Value of `#TN_EVENTGRP_WAIT_LISTS_CNT`
+   unsigned          eventgrp_wait_lists_cnt    : 7;
+   ///
+   /// Value of `#TN_USE_WAIT_ANY`
+   unsigned          use_wait_any               : 1;
+   ///
+   /// Value of `#TN_USE_TASK_NOTIFY`
+   unsigned          use_task_notify            : 1;
+   ///
+   /// Value of `#TN_USE_PRIO_WAIT_QUEUES`
+   unsigned          use_prio_wait_queues       : 1;
+   ///
    /// Value of `#TN_OLD_EVENT_API`
    unsigned          old_events_api             : 1;
    ///
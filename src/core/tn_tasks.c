@@ -44,9 +44,12 @@
 
 //-- internal tnkernel headers
 #include "_tn_tasks.h"
+#include "_tn_sem.h"
 #include "_tn_mutex.h"
+#include "_tn_rwlock.h"
 #include "_tn_timer.h"
 #include "_tn_list.h"
+#include "_tn_wait_any.h"
 
 
 //-- header of current module
@@ -87,8 +90,29 @@ _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
    return rc;
 }
 
+_TN_STATIC_INLINE enum TN_RCode _check_param_notify(
+      const struct TN_Task *task,
+      enum TN_TaskNotifyAction action
+      )
+{
+   enum TN_RCode rc = _check_param_generic(task);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (    action != TN_TASK_NOTIFY_SET_BITS
+               && action != TN_TASK_NOTIFY_INCREMENT
+               && action != TN_TASK_NOTIFY_OVERWRITE
+             )
+   {
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
 #else
 #  define _check_param_generic(task)            (TN_RC_OK)
+#  define _check_param_notify(task, action)     (TN_RC_OK)
 #endif
 // }}}
 
@@ -115,39 +139,235 @@ _TN_STATIC_INLINE void _init_deadlock_list(struct TN_Task *task)
 #  define   _init_deadlock_list(task)
 #endif
 
+#if TN_USE_RWLOCKS
+
+_TN_STATIC_INLINE void _init_rwlock_holds(struct TN_Task *task)
+{
+   int i;
+
+   for (i = 0; i < TN_RWLOCK_HOLDS_MAX; i++){
+      task->rwlock_holds[i].rwlock = TN_NULL;
+      task->rwlock_holds[i].task   = task;
+      task->rwlock_holds[i].cnt    = 0;
+      _tn_list_reset(&(task->rwlock_holds[i].holds_list_item));
+   }
+}
+
+#else
+#  define   _init_rwlock_holds(task)
+#endif
+
+
 
 /**
- * Looks for first runnable task with highest priority,
- * set _tn_next_task_to_run to it.
- *
- * @return `TN_TRUE` if _tn_next_task_to_run was changed, `TN_FALSE` otherwise.
+ * Returns index of the least significant bit set in the given word (which
+ * must be non-zero). So, for `0xa8` it returns `3`.
  */
-static void _find_next_task_to_run(void)
+_TN_STATIC_INLINE int _find_first_set(unsigned int word)
 {
-   int priority;
-
 #ifdef _TN_FFS
    //-- architecture-dependent way to find-first-set-bit is available,
    //   so use it.
-   priority = _TN_FFS(_tn_ready_to_run_bmp);
-   priority--;
+   return _TN_FFS(word) - 1;
 #else
    //-- there is no architecture-dependent way to find-first-set-bit available,
    //   so, use generic (somewhat naive) algorithm.
+   int ret = 0;
+
+   while (!(word & 1)){
+      word >>= 1;
+      ret++;
+   }
+
+   return ret;
+#endif
+}
+
+//-- bitmap of priorities {{{
+
+/*
+ * Bitmap of priorities is organized just like the bitmap of priorities with
+ * runnable tasks (`_tn_ready_to_run_bmp`): one word for each `TN_INT_WIDTH`
+ * priorities, and, if there's more than one word, the summary word.
+ */
+
+/*
+ * See comment in the _tn_tasks.h file
+ */
+void _tn_prio_bmp_reset(struct TN_PrioBmp *bmp)
+{
    int i;
-   unsigned int mask;
 
-   mask = 1;
-   priority = 0;
+   for (i = 0; i < _TN_PRIO_BMP_WORDS_CNT; i++){
+      bmp->words[i] = 0;
+   }
+#if _TN_PRIO_BMP_WORDS_CNT > 1
+   bmp->summary = 0;
+#endif
+}
 
-   for (i = 0; i < TN_PRIORITIES_CNT; i++){
-      //-- for each bit in bmp
-      if (_tn_ready_to_run_bmp & mask){
-         priority = i;
-         break;
+/*
+ * See comment in the _tn_tasks.h file
+ */
+void _tn_prio_bmp_set(struct TN_PrioBmp *bmp, int priority)
+{
+   unsigned int word_idx = (unsigned int)priority / TN_INT_WIDTH;
+
+   bmp->words[word_idx] |= (1u << ((unsigned int)priority % TN_INT_WIDTH));
+#if _TN_PRIO_BMP_WORDS_CNT > 1
+   bmp->summary |= (1u << word_idx);
+#endif
+}
+
+/*
+ * See comment in the _tn_tasks.h file
+ */
+void _tn_prio_bmp_clear(struct TN_PrioBmp *bmp, int priority)
+{
+   unsigned int word_idx = (unsigned int)priority / TN_INT_WIDTH;
+
+   bmp->words[word_idx] &= ~(1u << ((unsigned int)priority % TN_INT_WIDTH));
+#if _TN_PRIO_BMP_WORDS_CNT > 1
+   if (bmp->words[word_idx] == 0){
+      bmp->summary &= ~(1u << word_idx);
+   }
+#endif
+}
+
+/*
+ * See comment in the _tn_tasks.h file
+ */
+int _tn_prio_bmp_find(const struct TN_PrioBmp *bmp, int priority)
+{
+   int ret = -1;
+
+   if (priority < TN_PRIORITIES_CNT){
+      unsigned int word_idx = (unsigned int)priority / TN_INT_WIDTH;
+
+      //-- bits of the priorities which are not higher than the given one,
+      //   in the same word
+      unsigned int word = bmp->words[word_idx]
+         & (~0u << ((unsigned int)priority % TN_INT_WIDTH));
+
+#if _TN_PRIO_BMP_WORDS_CNT > 1
+      if (word == 0){
+         //-- look for the next non-empty word by the summary
+         unsigned int summary = bmp->summary & (~1u << word_idx);
+
+         if (summary != 0){
+            word_idx = (unsigned int)_find_first_set(summary);
+            word = bmp->words[word_idx];
+         }
+      }
+#endif
+
+      if (word != 0){
+         ret = (int)(word_idx * TN_INT_WIDTH) + _find_first_set(word);
+      }
+   }
+
+   return ret;
+}
+
+// }}}
+
+#if TN_USE_PRIO_WAIT_QUEUES
+
+//-- priority-ordered wait queues {{{
+
+/*
+ * Priority-ordered wait queue is an ordinary wait queue (so that objects can
+ * examine it as usual), in which tasks are sorted by priority, and tasks of
+ * the same priority are sorted in FIFO order. Object additionally maintains
+ * the priority index of the queue (`struct TN_ListPrioIdx`): bitmap of
+ * priorities of the waiting tasks, and the first task of each of these
+ * priorities.
+ *
+ * So, the new task is put right before the first task of the next lower
+ * priority, which is found by the bitmap, and both putting a task to the
+ * queue and removing it take O(1) time.
+ */
+
+/**
+ * Put the task into the priority-ordered wait queue: after all the tasks
+ * with the same or higher priority.
+ *
+ * Task's `pwait_queue` and `pwait_queue_prio` are not touched here.
+ */
+static void _prio_wait_queue_add(
+      struct TN_ListItem     *wait_que,
+      struct TN_ListPrioIdx  *idx,
+      struct TN_Task         *task
+      )
+{
+   int priority = task->priority;
+   int next_priority = _tn_prio_bmp_find(&(idx->bmp), priority + 1);
+
+   if (next_priority >= 0){
+      //-- task goes right before the first task of the next lower priority
+      _tn_list_add_tail(idx->first[next_priority], &(task->task_queue));
+   } else {
+      //-- there are no tasks with lower priority: task goes to the end
+      _tn_list_add_tail(wait_que, &(task->task_queue));
+   }
+
+   if (_tn_prio_bmp_find(&(idx->bmp), priority) != priority){
+      //-- there are no other tasks with the same priority
+      _tn_prio_bmp_set(&(idx->bmp), priority);
+      idx->first[priority] = &(task->task_queue);
+   }
+}
+
+/**
+ * Remove the task from the priority index of the wait queue: if the task is
+ * the first one of its priority, the next task becomes the first one (if it
+ * has the same priority), or the priority is removed from the bitmap.
+ *
+ * Should be called right before the task is removed from the
+ * priority-ordered wait queue (which is done by the caller).
+ */
+static void _prio_wait_queue_unlink(struct TN_Task *task)
+{
+   struct TN_ListPrioIdx *idx = task->pwait_queue_prio;
+   int priority = task->priority;
+
+   if (idx->first[priority] == &(task->task_queue)){
+      struct TN_ListItem *next = task->task_queue.next;
+
+      if (     next != task->pwait_queue
+            && _tn_get_task_by_tsk_queue(next)->priority == priority
+         )
+      {
+         idx->first[priority] = next;
+      } else {
+         _tn_prio_bmp_clear(&(idx->bmp), priority);
       }
-      mask = (mask << 1);
    }
+}
+
+// }}}
+
+#endif // TN_USE_PRIO_WAIT_QUEUES
+
+/**
+ * Looks for first runnable task with highest priority,
+ * set _tn_next_task_to_run to it.
+ *
+ * @return `TN_TRUE` if _tn_next_task_to_run was changed, `TN_FALSE` otherwise.
+ */
+static void _find_next_task_to_run(void)
+{
+   int priority;
+
+#if _TN_READY_BMP_WORDS_CNT > 1
+   //-- two-level bitmap: find the first non-empty word by the summary,
+   //   and then, the first set bit in it
+   int word_idx = _find_first_set(_tn_ready_to_run_bmp_summary);
+
+   priority = word_idx * TN_INT_WIDTH
+      + _find_first_set(_tn_ready_to_run_bmp[word_idx]);
+#else
+   priority = _find_first_set(_tn_ready_to_run_bmp[0]);
 #endif
 
    //-- set task to run: fetch next task from ready list of appropriate
@@ -185,6 +405,74 @@ _TN_STATIC_INLINE enum TN_RCode _task_wakeup(struct TN_Task *task)
    return rc;
 }
 
+#if TN_USE_TASK_NOTIFY
+/**
+ * Take the notification value of the task: store it to `*p_value` (if
+ * `p_value` isn't `TN_NULL`) and clear it.
+ */
+_TN_STATIC_INLINE void _task_notify_take(
+      struct TN_Task *task,
+      TN_UWord *p_value
+      )
+{
+   if (p_value != TN_NULL){
+      *p_value = task->notify_value;
+   }
+
+   task->notify_value   = 0;
+   task->notify_pending = TN_FALSE;
+}
+
+/**
+ * See the comment for tn_task_notify, tn_task_inotify in the tn_tasks.h
+ */
+_TN_STATIC_INLINE enum TN_RCode _task_notify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (_tn_task_is_dormant(task)){
+      rc = TN_RC_WSTATE;
+   } else {
+      switch (action){
+         case TN_TASK_NOTIFY_SET_BITS:
+            task->notify_value |= value;
+            break;
+
+         case TN_TASK_NOTIFY_INCREMENT:
+            task->notify_value++;
+            break;
+
+         case TN_TASK_NOTIFY_OVERWRITE:
+            task->notify_value = value;
+            break;
+
+         default:
+            //-- should never happen
+            _TN_FATAL_ERRORF("wrong notify action=%d", action);
+            break;
+      }
+
+      task->notify_pending = TN_TRUE;
+
+      if (     (_tn_task_is_waiting(task))
+            && (task->task_wait_reason == TN_WAIT_REASON_NOTIFY)
+         )
+      {
+         //-- Task waits for notification: hand the value over to it
+         //   and wake it up, no wait queue is involved.
+         _task_notify_take(task, task->subsys_wait.notify.p_value);
+         _tn_task_wait_complete(task, TN_RC_OK);
+      }
+   }
+
+   return rc;
+}
+#endif // TN_USE_TASK_NOTIFY
+
 _TN_STATIC_INLINE enum TN_RCode _task_release_wait(struct TN_Task *task)
 {
    enum TN_RCode rc = TN_RC_OK;
@@ -286,7 +574,19 @@ _TN_STATIC_INLINE TN_BOOL _remove_entry_from_ready_queue(
 
    if (ret){
       //-- list is empty, so, modify bitmask _tn_ready_to_run_bmp
-      _tn_ready_to_run_bmp &= ~(1 << priority);
+#if _TN_READY_BMP_WORDS_CNT > 1
+      unsigned int word_idx = (unsigned int)priority / TN_INT_WIDTH;
+
+      _tn_ready_to_run_bmp[word_idx]
+         &= ~(1u << ((unsigned int)priority % TN_INT_WIDTH));
+
+      if (_tn_ready_to_run_bmp[word_idx] == 0){
+         //-- no more runnable tasks in the whole group
+         _tn_ready_to_run_bmp_summary &= ~(1u << word_idx);
+      }
+#else
+      _tn_ready_to_run_bmp[0] &= ~(1u << priority);
+#endif
    }
 
    return ret;
@@ -297,7 +597,18 @@ _TN_STATIC_INLINE void _add_entry_to_ready_queue(
       )
 {
    _tn_list_add_tail(&(_tn_tasks_ready_list[priority]), list_node);
-   _tn_ready_to_run_bmp |= (1 << priority);
+
+#if _TN_READY_BMP_WORDS_CNT > 1
+   {
+      unsigned int word_idx = (unsigned int)priority / TN_INT_WIDTH;
+
+      _tn_ready_to_run_bmp[word_idx]
+         |= (1u << ((unsigned int)priority % TN_INT_WIDTH));
+      _tn_ready_to_run_bmp_summary |= (1u << word_idx);
+   }
+#else
+   _tn_ready_to_run_bmp[0] |= (1u << priority);
+#endif
 }
 
 // }}}
@@ -326,6 +637,11 @@ _TN_STATIC_INLINE void _add_entry_to_ready_queue(
  */
 static void _on_task_wait_complete(struct TN_Task *task)
 {
+   //-- for semaphore, hand units out to the tasks behind (if possible)
+   if (task->task_wait_reason == TN_WAIT_REASON_SEM){
+      _tn_sem_on_task_wait_complete(task);
+   }
+
    //-- for mutex with priority inheritance, call special handler
    if (task->task_wait_reason == TN_WAIT_REASON_MUTEX_I){
       _tn_mutex_i_on_task_wait_complete(task);
@@ -339,13 +655,23 @@ static void _on_task_wait_complete(struct TN_Task *task)
       _tn_mutex_on_task_wait_complete(task);
    }
 
+   //-- for tn_wait_any(), remove task's items from the objects' lists
+   if (task->task_wait_reason == TN_WAIT_REASON_WAIT_ANY){
+      _tn_wait_any_on_task_wait_complete(task);
+   }
+
+   //-- for reader-writer lock, handle priorities of its holders
+   if (task->task_wait_reason == TN_WAIT_REASON_RWLOCK){
+      _tn_rwlock_on_task_wait_complete(task);
+   }
+
 }
 
 /**
  * NOTE: task_state should be set to TN_TASK_STATE_NONE before calling.
  *
  * Teminate task:
- *    * unlock all mutexes that are held by task
+ *    * unlock all mutexes and reader-writer locks that are held by task
  *    * set dormant state (reinitialize everything)
  *    * reitinialize stack
  */
@@ -360,6 +686,9 @@ static void _task_terminate(struct TN_Task *task)
    //-- Unlock all mutexes locked by the task
    _tn_mutex_unlock_all_by_task(task);
 
+   //-- Unlock all reader-writer locks held by the task
+   _tn_rwlock_unlock_all_by_task(task);
+
    //-- task is already in the state NONE, so, we just need 
    //   to set dormant state.
    _tn_task_set_dormant(task);
@@ -491,6 +820,9 @@ enum TN_RCode tn_task_create(
    //-- reset task_queue (the queue used to include task to runqueue or 
    //   waitqueue)
    _tn_list_reset(&(task->task_queue));
+#if TN_USE_PRIO_WAIT_QUEUES
+   task->pwait_queue_prio = TN_NULL;
+#endif
 
    //-- init timer that is needed to implement task wait timeout
    _tn_timer_create(&task->timer, _task_wait_timeout, task);
@@ -498,6 +830,7 @@ enum TN_RCode tn_task_create(
    //-- init auxiliary lists needed for tasks
    _init_mutex_queue(task);
    _init_deadlock_list(task);
+   _init_rwlock_holds(task);
 
    //-- Set initial task state: `TN_TASK_STATE_DORMANT`
    _tn_task_set_dormant(task);
@@ -674,6 +1007,104 @@ enum TN_RCode tn_task_iwakeup(struct TN_Task *task)
    return _task_job_iperform(task, _task_wakeup);
 }
 
+#if TN_USE_TASK_NOTIFY
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_notify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      )
+{
+   enum TN_RCode rc = _check_param_notify(task, action);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _task_notify(task, action, value);
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_inotify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      )
+{
+   enum TN_RCode rc = _check_param_notify(task, action);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      rc = _task_notify(task, action, value);
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+/*
+ * See comments in the header file (tn_tasks.h)
+ */
+enum TN_RCode tn_task_notify_wait(TN_UWord *p_value, TN_TickCnt timeout)
+{
+   enum TN_RCode rc = TN_RC_OK;
+   TN_BOOL waited = TN_FALSE;
+
+   if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      struct TN_Task *task = _tn_curr_run_task;
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      if (task->notify_pending){
+         //-- notification is already here, take it
+         _task_notify_take(task, p_value);
+      } else if (timeout == 0){
+         //-- in polling mode, just return TN_RC_TIMEOUT
+         rc = TN_RC_TIMEOUT;
+      } else {
+         //-- put task to wait without wait queue: the notifier will
+         //   store the value to `*p_value` (see _task_notify())
+         task->subsys_wait.notify.p_value = p_value;
+         _tn_task_curr_to_wait_action(TN_NULL, TN_WAIT_REASON_NOTIFY, timeout);
+         waited = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+         //-- get wait result
+         rc = task->task_wait_rc;
+      }
+   }
+
+   return rc;
+}
+#endif // TN_USE_TASK_NOTIFY
+
 /*
  * See comments in the header file (tn_tasks.h)
  */
@@ -937,6 +1368,9 @@ void _tn_task_set_runnable(struct TN_Task * task)
    if (priority < _tn_next_task_to_run->priority){
       _tn_next_task_to_run = task;
    }
+
+   //-- manage time slice timer (round-robin)
+   _tn_sys_tslice_update();
 }
 
 /**
@@ -990,11 +1424,14 @@ void _tn_task_clear_runnable(struct TN_Task *task)
    //-- and reset task's queue
    _tn_list_reset(&(task->task_queue));
 
+   //-- manage time slice timer (round-robin)
+   _tn_sys_tslice_update();
 }
 
 void _tn_task_set_waiting(
       struct TN_Task *task,
       struct TN_ListItem *wait_que,
+      struct TN_ListPrioIdx *wait_que_prio,
       enum TN_WaitReason wait_reason,
       TN_TickCnt timeout
       )
@@ -1007,6 +1444,8 @@ void _tn_task_set_waiting(
       _TN_FATAL_ERROR("");
    } else if (_tn_timer_is_active(&task->timer)){
       _TN_FATAL_ERROR("");
+   } else if (wait_que_prio != TN_NULL && wait_que == TN_NULL){
+      _TN_FATAL_ERROR("");
    }
 
 #endif
@@ -1016,10 +1455,24 @@ void _tn_task_set_waiting(
 
    task->waited           = TN_TRUE;
 
-   //--- Add to the wait queue  - FIFO
+   //--- Add to the wait queue: FIFO or by priority
+
+#if TN_USE_PRIO_WAIT_QUEUES
+   task->pwait_queue_prio = wait_que_prio;
+#else
+   _TN_UNUSED(wait_que_prio);
+#endif
 
    if (wait_que != TN_NULL){
+#if TN_USE_PRIO_WAIT_QUEUES
+      if (wait_que_prio != TN_NULL){
+         _prio_wait_queue_add(wait_que, wait_que_prio, task);
+      } else {
+         _tn_list_add_tail(wait_que, &(task->task_queue));
+      }
+#else
       _tn_list_add_tail(wait_que, &(task->task_queue));
+#endif
       task->pwait_queue = wait_que;
    } else {
       //-- NOTE: we don't need to reset task_queue because
@@ -1057,6 +1510,13 @@ void _tn_task_clear_waiting(struct TN_Task *task, enum TN_RCode wait_rc)
    //   in tn_mutex.c checks for all tasks in mutex's wait_queue to
    //   get max blocked priority
 
+#if TN_USE_PRIO_WAIT_QUEUES
+   if (task->pwait_queue_prio != TN_NULL){
+      _prio_wait_queue_unlink(task);
+      task->pwait_queue_prio = TN_NULL;
+   }
+#endif
+
    //-- NOTE: we don't care here whether task is contained in any wait_queue,
    //   because even if it isn't, _tn_list_remove_entry() on empty list
    //   does just nothing.
@@ -1128,11 +1588,28 @@ void _tn_task_set_dormant(struct TN_Task* task)
    }
 #endif // TN_MUTEX_DEADLOCK_DETECT
 #endif // TN_USE_MUTEXES
+#if TN_USE_RWLOCKS
+   {
+      int i;
+      for (i = 0; i < TN_RWLOCK_HOLDS_MAX; i++){
+         if (task->rwlock_holds[i].rwlock != TN_NULL){
+            _TN_FATAL_ERROR("");
+         }
+      }
+   }
+#endif // TN_USE_RWLOCKS
 #endif // TN_DEBUG
 
    task->priority    = task->base_priority;      //-- Task curr priority
    task->task_state  |= TN_TASK_STATE_DORMANT;   //-- Task state
 
+#if TN_USE_TASK_NOTIFY
+   //-- notifications sent before termination should not be seen after
+   //   re-activation
+   task->notify_value   = 0;
+   task->notify_pending = TN_FALSE;
+#endif
+
    task->tslice_count  = 0;
 }
 
@@ -1224,7 +1701,40 @@ void _tn_change_task_priority(struct TN_Task *task, int new_priority)
 {
    if (_tn_task_is_runnable(task)){
       _tn_change_running_task_priority(task, new_priority);
+#if TN_USE_PRIO_WAIT_QUEUES
+   } else if (
+         task->pwait_queue_prio != TN_NULL
+         && task->priority != new_priority
+         )
+   {
+      //-- task waits in the priority-ordered wait queue: move it to the
+      //   right place, it gets after the tasks already waiting with the
+      //   same priority
+      _prio_wait_queue_unlink(task);
+      _tn_list_remove_entry(&(task->task_queue));
+
+      task->priority = new_priority;
+      _prio_wait_queue_add(
+            task->pwait_queue, task->pwait_queue_prio, task
+            );
+#endif
    } else {
+      if (     _tn_task_is_waiting(task)
+            && task->task_wait_reason == TN_WAIT_REASON_MUTEX_I
+         )
+      {
+         //-- mutex with priority inheritance keeps track of priorities of
+         //   waiting tasks
+         _tn_mutex_i_on_waiter_priority_change(task, new_priority);
+      } else if (
+            _tn_task_is_waiting(task)
+            && task->task_wait_reason == TN_WAIT_REASON_RWLOCK
+            )
+      {
+         //-- reader-writer lock keeps track of priorities of waiting tasks
+         _tn_rwlock_on_waiter_priority_change(task, new_priority);
+      }
+
       task->priority = new_priority;
    }
 }
@@ -1247,6 +1757,9 @@ void _tn_change_running_task_priority(struct TN_Task *task, int new_priority)
    _add_entry_to_ready_queue(&(task->task_queue), new_priority);
 
    _find_next_task_to_run();
+
+   //-- manage time slice timer (round-robin)
+   _tn_sys_tslice_update();
 }
 
 #if 0
@@ -107,6 +107,25 @@
  * #TN_CBIdle. It is useful to bring the processor to some kind of real idle
  * state, so that device draws less current.
  *
+ * \section tn_tasks__notify Task notifications
+ *
+ * If `#TN_USE_TASK_NOTIFY` is non-zero, each task has a notification value:
+ * a word which other tasks and ISRs update by `tn_task_notify()` /
+ * `tn_task_inotify()`, and the task itself waits for by
+ * `tn_task_notify_wait()`. It's a lightweight replacement for a \ref
+ * tn_sem.h "semaphore" or an \ref tn_eventgrp.h "event group" which has
+ * exactly one waiting task: there is no separate object, and notifying the
+ * waiting task just makes it runnable, without going through any wait
+ * queue.
+ *
+ * Notification updates the value in one of the ways given by `enum
+ * #TN_TaskNotifyAction`: setting bits (like event group), incrementing (like
+ * counting semaphore) or overwriting (like a mailbox of one word), and marks
+ * it pending. `tn_task_notify_wait()` takes the whole value and clears it.
+ *
+ * Naturally, only one task (the one which owns the notification value) can
+ * wait for it.
+ *
  */
 
 #ifndef _TN_TASKS_H
@@ -120,8 +139,15 @@
 #include "tn_list.h"
 #include "tn_common.h"
 
+#include "tn_sem.h"
 #include "tn_eventgrp.h"
+#include "tn_weventgrp.h"
+#include "tn_wait_any.h"
+#include "tn_rwlock.h"
 #include "tn_dqueue.h"
+#include "tn_msgq.h"
+#include "tn_stream.h"
+#include "tn_tlsf.h"
 #include "tn_fmem.h"
 #include "tn_timer.h"
 
@@ -208,6 +234,56 @@ enum TN_WaitReason {
    /// memory blocks
    /// @see tn_fmem.h
    TN_WAIT_REASON_WFIXMEM,
+   ///
+   /// Task wants to put some message to the message queue, and there's no
+   /// space in the queue.
+   /// @see tn_msgq.h
+   TN_WAIT_REASON_MSGQ_WSEND,
+   ///
+   /// Task wants to receive some message from the message queue, and there's
+   /// no messages in the queue
+   /// @see tn_msgq.h
+   TN_WAIT_REASON_MSGQ_WRECEIVE,
+   ///
+   /// Task wants to read some data from the ring, and the ring is empty
+   /// @see tn_ring.h
+   TN_WAIT_REASON_RING_WRECEIVE,
+   ///
+   /// Task wants to write some data to the stream buffer, and there's not
+   /// enough space in it
+   /// @see tn_stream.h
+   TN_WAIT_REASON_STREAM_WSEND,
+   ///
+   /// Task wants to read some data from the stream buffer, and there's not
+   /// enough data in it
+   /// @see tn_stream.h
+   TN_WAIT_REASON_STREAM_WRECEIVE,
+   ///
+   /// Task wants to allocate memory block from the TLSF heap, and there's no
+   /// free block large enough
+   /// @see tn_tlsf.h
+   TN_WAIT_REASON_TLSF_WALLOC,
+   ///
+   /// Task waits for some event in the wide event group to happen
+   /// @see tn_weventgrp.h
+   TN_WAIT_REASON_WEVENT,
+   ///
+   /// Task waits for any of several objects to get ready
+   /// @see tn_wait_any.h
+   TN_WAIT_REASON_WAIT_ANY,
+   ///
+   /// Task waits for the next update of the seqlock
+   /// @see tn_seqlock.h
+   TN_WAIT_REASON_SEQLOCK,
+   ///
+   /// Task waits for notification
+   /// @see \ref tn_tasks__notify
+   TN_WAIT_REASON_NOTIFY,
+   ///
+   /// Task waits for the reader-writer lock to lock it for reading or for
+   /// writing
+   /// @see tn_rwlock.h
+   TN_WAIT_REASON_RWLOCK,
 
 
    ///
@@ -242,6 +318,24 @@ enum TN_TaskExitOpt {
    TN_TASK_EXIT_OPT_DELETE = (1 << 0),
 };
 
+/**
+ * Actions for `tn_task_notify()`: how the notification value of the task is
+ * updated. See \ref tn_tasks__notify.
+ */
+enum TN_TaskNotifyAction {
+   ///
+   /// Set given bits in the notification value (like event group)
+   TN_TASK_NOTIFY_SET_BITS,
+   ///
+   /// Increment the notification value, given value is ignored (like
+   /// counting semaphore)
+   TN_TASK_NOTIFY_INCREMENT,
+   ///
+   /// Overwrite the notification value with given one, even if the previous
+   /// one isn't taken by the task yet (like a mailbox of one word)
+   TN_TASK_NOTIFY_OVERWRITE,
+};
+
 #if TN_PROFILER || DOXYGEN_ACTIVE
 /**
  * Timing structure that is managed by profiler and can be read by
@@ -324,6 +418,17 @@ struct _TN_TaskProfiler {
 };
 #endif
 
+/**
+ * Task notification-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_TaskNotifyWait {
+   ///
+   /// pointer to store the notification value at, given to
+   /// `tn_task_notify_wait()`; may be `TN_NULL`.
+   TN_UWord *p_value;
+};
+
 /**
  * Task
  */
@@ -349,6 +454,13 @@ struct TN_Task {
    /// pointer to object's (semaphore, mutex, event, etc) wait list in which 
    /// task is included for waiting
    struct TN_ListItem *pwait_queue;
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// if the wait list in which task is included (see `pwait_queue`) is
+   /// ordered by priority, this is the priority index of that list (see
+   /// `#TN_USE_PRIO_WAIT_QUEUES`); otherwise, it's `TN_NULL`.
+   struct TN_ListPrioIdx *pwait_queue_prio;
+#endif
    ///
    /// queue is used to include task in creation list
    /// (currently, this list is used for statistics only)
@@ -369,6 +481,23 @@ struct TN_Task {
 #endif
 #endif
 
+#if TN_USE_RWLOCKS || defined(DOXYGEN_ACTIVE)
+   ///
+   /// records of \ref tn_rwlock.h "reader-writer locks" held by the task;
+   /// unused record has `rwlock` set to `TN_NULL`.
+   struct TN_RWLockHold rwlock_holds[ TN_RWLOCK_HOLDS_MAX ];
+#endif
+
+#if TN_USE_TASK_NOTIFY || defined(DOXYGEN_ACTIVE)
+   ///
+   /// notification value, see \ref tn_tasks__notify
+   TN_UWord notify_value;
+   ///
+   /// whether there is a notification not taken by `tn_task_notify_wait()`
+   /// yet
+   TN_BOOL notify_pending;
+#endif
+
    ///-- lowest address of stack. It is independent of architecture:
    ///   it's always the lowest address (which may be actually origin 
    ///   or end of stack, depending on the architecture)
@@ -404,7 +533,8 @@ struct TN_Task {
    // remaining time until timeout; may be `#TN_WAIT_INFINITE`.
    //TN_TickCnt tick_count;
    ///
-   /// time slice counter
+   /// remaining ticks of the interrupted time slice (see \ref round_robin),
+   /// or 0 if the next time slice should be a full one
    int tslice_count;
 #if 0
    ///
@@ -418,14 +548,38 @@ struct TN_Task {
    /// interfere with each other. It's quite ok here because task can't wait
    /// for different things.
    union {
+      /// fields specific to tn_sem.h
+      struct TN_SemTaskWait sem;
+      ///
       /// fields specific to tn_eventgrp.h
       struct TN_EGrpTaskWait eventgrp;
       ///
+      /// fields specific to tn_weventgrp.h
+      struct TN_WEGrpTaskWait weventgrp;
+      ///
       /// fields specific to tn_dqueue.h
       struct TN_DQueueTaskWait dqueue;
       ///
       /// fields specific to tn_fmem.h
       struct TN_FMemTaskWait fmem;
+      ///
+      /// fields specific to tn_msgq.h
+      struct TN_MsgQueueTaskWait msgq;
+      ///
+      /// fields specific to tn_stream.h
+      struct TN_StreamTaskWait stream;
+      ///
+      /// fields specific to tn_tlsf.h
+      struct TN_TlsfTaskWait tlsf;
+      ///
+      /// fields specific to tn_wait_any.h
+      struct TN_WaitAnyTaskWait wait_any;
+      ///
+      /// fields specific to tn_rwlock.h
+      struct TN_RWLockTaskWait rwlock;
+      ///
+      /// fields specific to task notifications
+      struct TN_TaskNotifyWait notify;
    } subsys_wait;
    ///
    /// Task name for debug purposes, user may want to set it by hand
@@ -682,6 +836,80 @@ enum TN_RCode tn_task_wakeup(struct TN_Task *task);
  */
 enum TN_RCode tn_task_iwakeup(struct TN_Task *task);
 
+#if TN_USE_TASK_NOTIFY || defined(DOXYGEN_ACTIVE)
+/**
+ * Notify the task: update its notification value as specified by `action`,
+ * and mark it pending. If the task waits in `tn_task_notify_wait()`, it is
+ * woken up at once. See \ref tn_tasks__notify.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param task    task to notify
+ * @param action  how to update the notification value, see
+ *                `enum #TN_TaskNotifyAction`
+ * @param value   value to use in the update (ignored for
+ *                `#TN_TASK_NOTIFY_INCREMENT`)
+ *
+ * @return
+ *    * `#TN_RC_OK` if successful
+ *    * `#TN_RC_WSTATE` if task is dormant (it is not activated, or it was
+ *       terminated)
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_task_notify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      );
+
+/**
+ * The same as `tn_task_notify()` but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_task_inotify(
+      struct TN_Task *task,
+      enum TN_TaskNotifyAction action,
+      TN_UWord value
+      );
+
+/**
+ * Wait for notification of the current task. If the notification is
+ * already pending, it is taken at once; otherwise, behavior depends on
+ * `timeout` value: refer to `#TN_TickCnt`.
+ *
+ * When the notification is taken, the notification value is stored to
+ * `*p_value`, and then it is cleared (set to 0, not pending). So, if the
+ * task was notified several times before it took the notification, it gets
+ * the bits set by all of them (or the count of them, or the latest value,
+ * depending on the actions used).
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param p_value    pointer to store the notification value at; may be
+ *                   `TN_NULL`.
+ * @param timeout    refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if notification was taken;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *
+ * @see `#TN_TickCnt`
+ */
+enum TN_RCode tn_task_notify_wait(TN_UWord *p_value, TN_TickCnt timeout);
+#endif
+
 /**
  * Activate task that is in $(TN_TASK_STATE_DORMANT) state, that is, it was
  * either just created by `tn_task_create()` without
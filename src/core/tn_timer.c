@@ -47,6 +47,11 @@
 #include "_tn_timer.h"
 #include "_tn_list.h"
 
+#if TN_TIMER_TASK
+#include "_tn_tasks.h"
+#include "tn_tasks.h"
+#endif
+
 
 
 
@@ -56,6 +61,31 @@
 
 
 
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+#if TN_TIMER_TASK
+///
+/// Timer task, see \ref timers_task
+static struct TN_Task         _timer_task;
+
+/// Stack of the timer task, given to `tn_timer_task_set()`
+static TN_UWord              *_timer_task_stack = TN_NULL;
+
+/// Stack size of the timer task, given to `tn_timer_task_set()`
+static unsigned int           _timer_task_stack_size = 0;
+
+/// Priority of the timer task, given to `tn_timer_task_set()`
+static int                    _timer_task_priority = 0;
+
+/// List of expired timers which callbacks should be called by the timer task
+static struct TN_ListItem     _timer_list__pending;
+#endif
+
+
+
+
 /*******************************************************************************
  *    DEFINITIONS
  ******************************************************************************/
@@ -67,6 +97,57 @@
  *    PRIVATE FUNCTIONS
  ******************************************************************************/
 
+#if TN_TIMER_TASK
+/**
+ * Body of the timer task: take pending timers one by one, and call their
+ * callbacks; if there are no pending timers, sleep until
+ * `_tn_timer_task_defer()` wakes the task up.
+ */
+static void _timer_task_body(void *par)
+{
+   for (;;){
+      struct TN_Timer *timer = TN_NULL;
+      TN_TimerFunc *func = TN_NULL;
+      void *p_user_data = TN_NULL;
+
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      if (_tn_list_is_empty(&_timer_list__pending)){
+         //-- no pending timers: sleep until the next batch
+         _tn_task_curr_to_wait_action(
+               TN_NULL, TN_WAIT_REASON_SLEEP, TN_WAIT_INFINITE
+               );
+      } else {
+         timer = _tn_list_first_entry(
+               &_timer_list__pending, struct TN_Timer, timer_queue
+               );
+
+         //-- remember callback and user data while interrupts are disabled,
+         //   and make the timer inactive, so that the callback could start
+         //   it again if it wants to.
+         func        = timer->func;
+         p_user_data = timer->p_user_data;
+
+         _tn_list_remove_entry(&(timer->timer_queue));
+         _tn_list_reset(&(timer->timer_queue));
+         timer->pending = TN_FALSE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (timer != TN_NULL){
+         //-- call user callback function
+         func(timer, p_user_data);
+      }
+   }
+
+   _TN_UNUSED(par);
+}
+#endif
+
 //-- Additional param checking {{{
 #if TN_CHECK_PARAM
 _TN_STATIC_INLINE enum TN_RCode _check_param_generic(
@@ -129,6 +210,11 @@ enum TN_RCode tn_timer_create(
       //-- just return rc as it is
    } else {
       rc = _tn_timer_create(timer, func, p_user_data);
+
+#if TN_TIMER_TASK
+      //-- callbacks of user's timers are called by the timer task
+      timer->deferred = TN_TRUE;
+#endif
    }
 
    return rc;
@@ -240,7 +326,16 @@ enum TN_RCode tn_timer_time_left(
 
    if (rc == TN_RC_OK){
       sr_saved = tn_arch_sr_save_int_dis();
-      *p_time_left = _tn_timer_time_left(timer);
+#if TN_TIMER_TASK
+      if (timer->pending){
+         //-- timer has expired, but the timer task hasn't yet called
+         //   its callback
+         *p_time_left = 0;
+      } else
+#endif
+      {
+         *p_time_left = _tn_timer_time_left(timer);
+      }
       tn_arch_sr_restore(sr_saved);
    }
 
@@ -251,6 +346,29 @@ enum TN_RCode tn_timer_time_left(
 
 
 
+#if TN_TIMER_TASK
+/*
+ * See comments in the header file (tn_timer.h)
+ */
+void tn_timer_task_set(
+      TN_UWord         *stack,
+      unsigned int      stack_size,
+      int               priority
+      )
+{
+   if (tn_sys_state_flags_get() & TN_STATE_FLAG__SYS_RUNNING){
+      _TN_FATAL_ERROR("tn_timer_task_set() should be called before tn_sys_start()");
+   }
+
+   _timer_task_stack       = stack;
+   _timer_task_stack_size  = stack_size;
+   _timer_task_priority    = priority;
+}
+#endif
+
+
+
+
 /*******************************************************************************
  *    PROTECTED FUNCTIONS
  ******************************************************************************/
@@ -276,8 +394,15 @@ enum TN_RCode _tn_timer_create(
 #if TN_DYNAMIC_TICK
       timer->timeout = 0;
       timer->start_tick_cnt = 0;
+#  if TN_DYNAMIC_TICK_HEAP
+      timer->heap_child = TN_NULL;
+#  endif
 #else
       timer->timeout_cur   = 0;
+#endif
+#if TN_TIMER_TASK
+      timer->deferred      = TN_FALSE;
+      timer->pending       = TN_FALSE;
 #endif
       timer->id_timer      = TN_ID_TIMER;
 
@@ -317,4 +442,61 @@ TN_BOOL _tn_timer_is_active(struct TN_Timer *timer)
    return (!_tn_list_is_empty(&(timer->timer_queue)));
 }
 
+#if TN_TIMER_TASK
+/**
+ * See comments in the _tn_timer.h file.
+ */
+void _tn_timer_task_create(void)
+{
+   enum TN_RCode rc;
+
+   //-- check that the timer task is set.
+   //   (it should be set by tn_timer_task_set() before calling
+   //   tn_sys_start())
+   if (_timer_task_stack == TN_NULL){
+      _TN_FATAL_ERROR("timer task is not set");
+   }
+
+   _tn_list_reset(&_timer_list__pending);
+
+   rc = tn_task_create_wname(
+         &_timer_task,                    //-- task TCB
+         _timer_task_body,                //-- task function
+         _timer_task_priority,            //-- task priority
+         _timer_task_stack,               //-- task stack
+         _timer_task_stack_size,          //-- task stack size
+                                          //   (in int, not bytes)
+         TN_NULL,                         //-- task function parameter
+         TN_TASK_CREATE_OPT_START,        //-- Creation option
+         "Timer"                          //-- Task name
+         );
+
+   if (rc != TN_RC_OK){
+      _TN_FATAL_ERROR("failed to create timer task");
+   }
+}
+
+/**
+ * See comments in the _tn_timer.h file.
+ */
+void _tn_timer_task_defer(struct TN_Timer *timer)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   timer->pending = TN_TRUE;
+   _tn_list_add_tail(&_timer_list__pending, &(timer->timer_queue));
+
+   //-- wake the timer task up, if it is sleeping. Otherwise, it is going
+   //   to handle this timer along with the others from the same batch.
+   if (     _tn_task_is_waiting(&_timer_task)
+         && _timer_task.task_wait_reason == TN_WAIT_REASON_SLEEP
+      )
+   {
+      _tn_task_wait_complete(&_timer_task, TN_RC_OK);
+   }
+}
+#endif
+
+
 
@@ -74,15 +74,47 @@
  * See `#TN_TimerFunc` for the prototype of the function that could be
  * scheduled.
  *
+ * If the option `#TN_TIMER_TASK` is set, callbacks of the timers created by
+ * `tn_timer_create()` are called from the timer task instead, see \ref
+ * timers_task.
+ *
  * TNeo offers two implementations of timers: static and dynamic. Refer
  * to the page \ref time_ticks for details.
  *
+ * \section timers_task Timer task
+ *
+ * A slow timer callback delays all the other timers which expire at the same
+ * tick, as well as all the interrupts of lower priority than
+ * $(TN_SYS_TIMER_LINK). If the option `#TN_TIMER_TASK` is set, the kernel
+ * has one more system task, the timer task, which calls callbacks of all the
+ * timers created by `tn_timer_create()`:
+ *
+ * - When such a timer expires, $(TN_SYS_TIMER_LINK) ISR merely moves it to
+ *   the list of pending timers, and wakes the timer task up (if it is not
+ *   already running). This is done with interrupts disabled, just like any
+ *   other work on timers, and takes constant time per timer.
+ * - The timer task takes pending timers one by one, and calls their
+ *   callbacks, so callbacks are called from the task context, with the
+ *   priority of the timer task. Of course, callbacks still shouldn't block,
+ *   since it delays all the other pending timers.
+ * - Until the callback of the pending timer is called, the timer is
+ *   considered active, and `tn_timer_time_left()` returns 0 for it.
+ *   If the pending timer is cancelled or restarted, its callback is not
+ *   called.
+ *
+ * Kernel's own timers (say, timeouts of waiting tasks) are still handled
+ * right in the ISR.
+ *
+ * The stack and the priority of the timer task should be provided to
+ * `tn_timer_task_set()` before the system is started.
+ *
  * \section timers_static_implementation Implementation of static timers
  *
  * Although you don't have to understand the implementation of timers to use
- * them, it is probably worth knowing, particularly because the kernel have an
- * option `#TN_TICK_LISTS_CNT` to customize the balance between performance of
- * `tn_tick_int_processing()` and memory occupied by timers.
+ * them, it is probably worth knowing, particularly because the kernel have
+ * options `#TN_TICK_LISTS_CNT` and `#TN_TICK_LISTS_LEVELS` to customize the
+ * balance between performance of `tn_tick_int_processing()` and memory
+ * occupied by timers.
  *
  * The easiest implementation of timers could be something like this: we
  * have just a single list with all active timers, and at every system tick
@@ -117,39 +149,47 @@
  *
  * This book is freely available at http://lwn.net/Kernel/LDD3/ .
  *
- * So, TNeo's implementation:
+ * So, TNeo's implementation is a hierarchical "timing wheel":
  *
  * We have configurable value `N` that is a power of two, typical values are
- * `4`, `8` or `16`.
- *
- * If the timer expires in the next `1` to `(N - 1)` system ticks, it is added
- * to one of the `N` lists (the so-called "tick" lists) devoted to short-range
- * timers using the least significant bits of the `timeout` value. If it
- * expires farther in the future, it is added to the "generic" list.
- *
- * Each `N`-th system tick, all the timers from "generic" list are walked
- * through, and the following is performed with each timer:
- *
- * - `timeout` value decremented by `N`
- * - if resulting `timeout` is less than `N`, timer is moved to the appropriate
- *   "tick" list.
- *
- * At *every* system tick, all the timers from current "tick" list are fired
- * unconditionally. This is an efficient and nice solution.
- *
- * The attentive reader may want to ask why do we use `(N - 1)` "tick" lists if
- * we actually have `N` lists. That's because, again, we want to be able to
- * modify timers from the timer function. If we use `N` lists, and user wants
- * to add new timer with `timeout` equal to `N`, then new timer will be added
- * to the same list which is iterated through at the moment, and things will be
- * mixed up.
- *
- * If we use `(N - 1)` lists, we are guaranteed that new timers can't be added
- * to the current "tick" list while we are iterating through it. 
+ * `4`, `8` or `16`, and configurable number of levels `L` (at least `2`).
+ * Each level has `N` lists of timers (the so-called "tick" lists), so there
+ * are `N * L` lists in total.
+ *
+ * When timer is started, the system tick count value at which it expires is
+ * calculated, and the timer is added to the lowest level which covers its
+ * timeout: the level `K` covers timeouts up to `N ^ (K + 1)` ticks. The list
+ * within the level is selected by the appropriate bits of the expiration tick
+ * count, i.e. `(expires / (N ^ K)) % N`. So, the level 0 contains timers which
+ * expire in the next `1` to `(N - 1)` system ticks, one list per tick.
+ *
+ * At *every* system tick, all the timers from current "tick" list of level
+ * 0 are fired unconditionally.
+ *
+ * Each `N`-th system tick (i.e. when the index of the current list of level
+ * 0 wraps around to zero), the next list of level 1 is "cascaded": each timer
+ * from it is added again, and since its timeout is now less than `N` ticks,
+ * it goes to the level 0. Similarly, each `N ^ 2`-th tick the next list of
+ * level 2 is cascaded to the lower levels, and so on.
+ *
+ * So, each timer is moved at most `(L - 1)` times during its lifetime, and
+ * system tick doesn't need to walk through all the active timers: it handles
+ * one list of level 0, and once per `N ^ K` ticks, one list of level `K`.
+ * Timers with timeouts larger than the range of the whole wheel, `N ^ L`
+ * ticks, are added to the farthest list of the top level, and they are just
+ * added again (to the top level or below) when this list is cascaded.
+ *
+ * The attentive reader may want to ask what happens if user starts new timer
+ * from the timer function, while the current "tick" list is being iterated
+ * through. Timeout `0` is disallowed, and timers with larger timeouts can't
+ * be added to the current "tick" list of level 0, since it corresponds to
+ * the current tick. So, new timers can't be added to the current "tick" list
+ * while we are iterating through it.
  * (although timer can be deleted from that list, but it's ok)
  *
  * The `N` in the TNeo is configured by the compile-time option
- * `#TN_TICK_LISTS_CNT`.
+ * `#TN_TICK_LISTS_CNT`, and `L` is configured by the option
+ * `#TN_TICK_LISTS_LEVELS`.
  */
 
 
@@ -190,6 +230,10 @@ struct TN_Timer;
  *   - It's legal to call interrupt services from this function;
  *   - The function should be as fast as possible.
  *
+ * If the option `#TN_TIMER_TASK` is set, the function is called from the
+ * timer task instead (see \ref timers_task), so task services should be used
+ * there; the function still must not block.
+ *
  * @param timer
  *    Timer that caused function to be called
  * @param p_user_data
@@ -230,13 +274,39 @@ struct TN_Timer {
    TN_TickCnt timeout;
 #endif
 
+#if (TN_DYNAMIC_TICK && TN_DYNAMIC_TICK_HEAP) || defined(DOXYGEN_ACTIVE)
+   ///
+   /// <i>Takes effect if only `#TN_DYNAMIC_TICK` and `#TN_DYNAMIC_TICK_HEAP`
+   /// are set</i>.
+   ///
+   /// First child of the timer in the pairing heap of active timers; links
+   /// to the siblings are kept in `timer_queue`.
+   struct TN_Timer *heap_child;
+#endif
+
 #if !TN_DYNAMIC_TICK || defined(DOXYGEN_ACTIVE)
    ///
    /// $(TN_IF_ONLY_DYNAMIC_TICK_NOT_SET)
    ///
-   /// Current (left) timeout value
+   /// System tick count value at which timer expires
    TN_TickCnt timeout_cur;
 #endif
+
+#if TN_TIMER_TASK || defined(DOXYGEN_ACTIVE)
+   ///
+   /// <i>Takes effect if only `#TN_TIMER_TASK` is set</i>.
+   ///
+   /// Whether the callback should be called from the timer task (see \ref
+   /// timers_task) instead of $(TN_SYS_TIMER_LINK) ISR. It is so for all the
+   /// timers created by `tn_timer_create()`.
+   TN_BOOL deferred;
+   ///
+   /// <i>Takes effect if only `#TN_TIMER_TASK` is set</i>.
+   ///
+   /// Whether the timer has expired, but the timer task hasn't yet called
+   /// its callback.
+   TN_BOOL pending;
+#endif
 };
 
 
@@ -451,6 +521,35 @@ enum TN_RCode tn_timer_time_left(
       TN_TickCnt *p_time_left
       );
 
+#if TN_TIMER_TASK || defined(DOXYGEN_ACTIVE)
+/**
+ * <i>Available if only `#TN_TIMER_TASK` is set</i>.
+ *
+ * Set stack and priority of the timer task, see \ref timers_task.
+ *
+ * \attention This function should be called <b>before</b> `tn_sys_start()`,
+ * otherwise, you'll run into run-time error `_TN_FATAL_ERROR()`.
+ *
+ * $(TN_CALL_FROM_MAIN)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param stack
+ *    Pointer to the stack of the timer task, typically defined with
+ *    `#TN_STACK_ARR_DEF()`.
+ * @param stack_size
+ *    Size of the stack array, in words (`#TN_UWord`), not in bytes.
+ * @param priority
+ *    Priority of the timer task: `0` is the highest priority, and
+ *    `(#TN_PRIORITIES_CNT - 2)` is the lowest one (the lowest priority is
+ *    reserved for the idle task).
+ */
+void tn_timer_task_set(
+      TN_UWord         *stack,
+      unsigned int      stack_size,
+      int               priority
+      );
+#endif
+
 #ifdef __cplusplus
 }  /* extern "C" */
 #endif
@@ -76,10 +76,18 @@ TN_CBTickCntGet        *_tn_cb_tick_cnt_get  = TN_NULL;
  *    PRIVATE DATA
  ******************************************************************************/
 
+#if TN_DYNAMIC_TICK_HEAP
+///
+/// Root of the pairing heap of active non-expired timers, ordered by the
+/// time left (see \ref time_ticks__dynamic_tick_heap), or `TN_NULL` if there
+/// are no such timers.
+static struct TN_Timer       *_timer_heap_root;
+#else
 ///
 /// List of active non-expired timers. Timers are sorted in ascending order
 /// by the timeout value.
 static struct TN_ListItem     _timer_list__gen;
+#endif
 
 
 /// List of expired timers; after it is initialized, it is used only inside
@@ -132,6 +140,265 @@ static TN_TickCnt _time_left_get(
    return time_left;
 }
 
+#if TN_DYNAMIC_TICK_HEAP
+
+/**
+ * Get pointer to `struct #TN_Timer` which is the next sibling of the given
+ * timer in the pairing heap (it is stored in `timer_queue.next`), or
+ * `TN_NULL`.
+ */
+#define _heap_next(timer)                                               \
+   _tn_get_timer_by_timer_queue((timer)->timer_queue.next)
+
+/**
+ * Get pointer to `struct #TN_Timer` which is either the previous sibling of
+ * the given timer in the pairing heap, or its parent if the timer is the
+ * first child (it is stored in `timer_queue.prev`), or `TN_NULL` for the root.
+ */
+#define _heap_prev(timer)                                               \
+   _tn_get_timer_by_timer_queue((timer)->timer_queue.prev)
+
+/**
+ * Set next sibling of the timer in the pairing heap (may be `TN_NULL`)
+ */
+_TN_STATIC_INLINE void _heap_next_set(
+      struct TN_Timer *timer,
+      struct TN_Timer *next
+      )
+{
+   timer->timer_queue.next = (next != TN_NULL) ? &(next->timer_queue) : TN_NULL;
+}
+
+/**
+ * Set previous sibling (or parent) of the timer in the pairing heap
+ * (may be `TN_NULL`)
+ */
+_TN_STATIC_INLINE void _heap_prev_set(
+      struct TN_Timer *timer,
+      struct TN_Timer *prev
+      )
+{
+   timer->timer_queue.prev = (prev != TN_NULL) ? &(prev->timer_queue) : TN_NULL;
+}
+
+/**
+ * Meld two heaps: the root with larger time left becomes the first child of
+ * the other one, which is returned. Sibling links of the returned root are
+ * not touched.
+ */
+static struct TN_Timer *_heap_meld(
+      struct TN_Timer *a,
+      struct TN_Timer *b,
+      TN_TickCnt cur_sys_tick_cnt
+      )
+{
+   if (_time_left_get(b, cur_sys_tick_cnt) < _time_left_get(a, cur_sys_tick_cnt)){
+      struct TN_Timer *tmp = a;
+      a = b;
+      b = tmp;
+   }
+
+   //-- make `b` the first child of `a`
+   _heap_next_set(b, a->heap_child);
+   if (a->heap_child != TN_NULL){
+      _heap_prev_set(a->heap_child, b);
+   }
+   _heap_prev_set(b, a);
+   a->heap_child = b;
+
+   return a;
+}
+
+/**
+ * Merge the list of sibling heaps (starting from `first`) into a single heap
+ * by the standard two-pass scheme: meld them by pairs left-to-right, and then
+ * meld the resulting heaps right-to-left. Returns the root of resulting heap,
+ * or `TN_NULL` if `first` is `TN_NULL`.
+ */
+static struct TN_Timer *_heap_merge_pairs(
+      struct TN_Timer *first,
+      TN_TickCnt cur_sys_tick_cnt
+      )
+{
+   struct TN_Timer *pairs = TN_NULL;
+   struct TN_Timer *root  = TN_NULL;
+
+   //-- first pass: meld by pairs; resulting heaps are linked through
+   //   the `next` link in reverse order
+   while (first != TN_NULL){
+      struct TN_Timer *a = first;
+      struct TN_Timer *b = _heap_next(a);
+
+      if (b != TN_NULL){
+         first = _heap_next(b);
+         a = _heap_meld(a, b, cur_sys_tick_cnt);
+      } else {
+         first = TN_NULL;
+      }
+
+      _heap_next_set(a, pairs);
+      pairs = a;
+   }
+
+   //-- second pass: meld resulting heaps from the last one to the first one
+   while (pairs != TN_NULL){
+      struct TN_Timer *next = _heap_next(pairs);
+
+      root = (root == TN_NULL)
+         ? pairs
+         : _heap_meld(root, pairs, cur_sys_tick_cnt);
+
+      pairs = next;
+   }
+
+   if (root != TN_NULL){
+      _heap_next_set(root, TN_NULL);
+      _heap_prev_set(root, TN_NULL);
+   }
+
+   return root;
+}
+
+/**
+ * Add timer (its `timeout` and `start_tick_cnt` should be already set) to the
+ * queue of active timers.
+ */
+static void _timer_queue_add(
+      struct TN_Timer *timer,
+      TN_TickCnt cur_sys_tick_cnt
+      )
+{
+   timer->heap_child = TN_NULL;
+   _heap_next_set(timer, TN_NULL);
+   _heap_prev_set(timer, TN_NULL);
+
+   if (_timer_heap_root == TN_NULL){
+      _timer_heap_root = timer;
+   } else {
+      _timer_heap_root = _heap_meld(_timer_heap_root, timer, cur_sys_tick_cnt);
+   }
+}
+
+/**
+ * Remove timer from the queue of active timers.
+ */
+static void _timer_queue_remove(struct TN_Timer *timer)
+{
+   TN_TickCnt cur_sys_tick_cnt = _tn_timer_sys_time_get();
+
+   //-- merge children of the timer into a single heap
+   struct TN_Timer *subheap
+      = _heap_merge_pairs(timer->heap_child, cur_sys_tick_cnt);
+
+   if (timer == _timer_heap_root){
+      //-- timer is the root: its children become the whole heap
+      _timer_heap_root = subheap;
+   } else {
+      //-- unlink the timer from its siblings (and parent)
+      struct TN_Timer *prev = _heap_prev(timer);
+      struct TN_Timer *next = _heap_next(timer);
+
+      if (prev->heap_child == timer){
+         prev->heap_child = next;
+      } else {
+         _heap_next_set(prev, next);
+      }
+
+      if (next != TN_NULL){
+         _heap_prev_set(next, prev);
+      }
+
+      //-- and meld its children back to the heap
+      if (subheap != TN_NULL){
+         _timer_heap_root = _heap_meld(
+               _timer_heap_root, subheap, cur_sys_tick_cnt
+               );
+      }
+   }
+
+   timer->heap_child = TN_NULL;
+}
+
+/**
+ * Get active timer which expires first, or `TN_NULL` if there are no active
+ * timers.
+ */
+_TN_STATIC_INLINE struct TN_Timer *_timer_queue_first(void)
+{
+   return _timer_heap_root;
+}
+
+#else
+
+/**
+ * Add timer (its `timeout` and `start_tick_cnt` should be already set) to the
+ * queue of active timers.
+ */
+static void _timer_queue_add(
+      struct TN_Timer *timer,
+      TN_TickCnt cur_sys_tick_cnt
+      )
+{
+   //-- walk through active timers list and get the position at which
+   //   new timer should be placed.
+   //
+   //   Since timers list is sorted, we need to find the correct place
+   //   to put new timer at.
+   //
+   //   Initially, we set it to the head of the list, and then walk
+   //   through timers until we found needed place (or until list is over)
+   struct TN_ListItem *list_item = &_timer_list__gen;
+   {
+      struct TN_Timer *cur_timer;
+      struct TN_Timer *tmp_timer;
+
+      _tn_list_for_each_entry_safe(
+            cur_timer, struct TN_Timer, tmp_timer,
+            &_timer_list__gen, timer_queue
+            )
+      {
+         //-- timeout value should never be TN_WAIT_INFINITE.
+         _TN_BUG_ON(cur_timer->timeout == TN_WAIT_INFINITE);
+
+         if (     _time_left_get(cur_timer, cur_sys_tick_cnt)
+               <  timer->timeout
+            )
+         {
+            //-- Probably this is the place for new timer..
+            list_item = &cur_timer->timer_queue;
+         } else {
+            //-- Found timer with larger timeout than that of new timer.
+            //   So, list_item now contains the correct place for new timer.
+            break;
+         }
+      }
+   }
+
+   //-- put timer object at the right position.
+   _tn_list_add_head(list_item, &(timer->timer_queue));
+}
+
+/**
+ * Remove timer from the queue of active timers.
+ */
+_TN_STATIC_INLINE void _timer_queue_remove(struct TN_Timer *timer)
+{
+   _tn_list_remove_entry(&(timer->timer_queue));
+}
+
+/**
+ * Get active timer which expires first, or `TN_NULL` if there are no active
+ * timers.
+ */
+_TN_STATIC_INLINE struct TN_Timer *_timer_queue_first(void)
+{
+   return _tn_list_is_empty(&_timer_list__gen)
+      ? TN_NULL
+      : _tn_list_first_entry(&_timer_list__gen, struct TN_Timer, timer_queue);
+}
+
+#endif // TN_DYNAMIC_TICK_HEAP
+
 /**
  * Find out when the kernel needs `tn_tick_int_processing()` to be called next
  * time, and eventually call application callback `_tn_cb_tick_schedule()` with
@@ -140,15 +407,10 @@ static TN_TickCnt _time_left_get(
 static void _next_tick_schedule(TN_TickCnt cur_sys_tick_cnt)
 {
    TN_TickCnt next_timeout;
+   struct TN_Timer *timer_next = _timer_queue_first();
 
-   if (!_tn_list_is_empty(&_timer_list__gen)){
-      //-- need to get first timer from the list and get its timeout
-      //   (this list is sorted, so, the first timer is the one with 
-      //   minimum timeout value)
-      struct TN_Timer *timer_next = _tn_get_timer_by_timer_queue(
-            _timer_list__gen.next
-            );
-
+   if (timer_next != TN_NULL){
+      //-- need to get first timer from the queue and get its timeout
       next_timeout = _time_left_get(timer_next, cur_sys_tick_cnt);
    } else {
       //-- no timers are active, so, no ticks needed at all
@@ -161,19 +423,30 @@ static void _next_tick_schedule(TN_TickCnt cur_sys_tick_cnt)
 
 
 /**
- * Cancel the timer: the main thing is that timer is removed from the linked
- * list.
+ * Cancel the timer: the main thing is that timer is removed from the queue
+ * of active timers (or from the "fire" list, see
+ * `_tn_timers_tick_proceed()`).
  */
 static void _timer_cancel(struct TN_Timer *timer)
 {
-   //-- reset timeout and start_tick_cnt to zero (but this is actually not
-   //   necessary)
+   if (timer->timeout != 0){
+      //-- timer is in the queue of active timers
+      _timer_queue_remove(timer);
+   } else {
+      //-- timer is either inactive, or it is in the "fire" list (or in the
+      //   list of pending timers, see `_tn_timer_task_defer()`): timeout
+      //   of active timers is never 0
+      _tn_list_remove_entry(&(timer->timer_queue));
+   }
+
+#if TN_TIMER_TASK
+   timer->pending = TN_FALSE;
+#endif
+
+   //-- reset timeout and start_tick_cnt to zero
    timer->timeout = 0;
    timer->start_tick_cnt = 0;
 
-   //-- remove entry from timer queue
-   _tn_list_remove_entry(&(timer->timer_queue));
-
    //-- reset the list
    _tn_list_reset(&(timer->timer_queue));
 }
@@ -215,8 +488,13 @@ void _tn_timers_init(void)
       _TN_FATAL_ERROR("");
    }
 
+#if TN_DYNAMIC_TICK_HEAP
+   //-- reset heap of timers
+   _timer_heap_root = TN_NULL;
+#else
    //-- reset "generic" timers list
    _tn_list_reset(&_timer_list__gen);
+#endif
 
    //-- reset "current" timers list
    _tn_list_reset(&_timer_list__fire);
@@ -239,24 +517,21 @@ void _tn_timers_tick_proceed(TN_UWord TN_INTSAVE_VAR)
    //-- First of all, get current time
    TN_TickCnt cur_sys_tick_cnt = _tn_timer_sys_time_get();
 
-   //-- Now, walk through timers list from start until we get non-expired timer
-   //   (timers list is sorted)
+   //-- Now, take timers which expire first from the queue until we get
+   //   non-expired timer
    {
       struct TN_Timer *timer;
-      struct TN_Timer *tmp_timer;
 
-      _tn_list_for_each_entry_safe(
-            timer, struct TN_Timer, tmp_timer,
-            &_timer_list__gen, timer_queue
-            )
-      {
+      while ((timer = _timer_queue_first()) != TN_NULL){
          //-- timeout value should never be TN_WAIT_INFINITE.
          _TN_BUG_ON(timer->timeout == TN_WAIT_INFINITE);
 
          if (_time_left_get(timer, cur_sys_tick_cnt) == 0){
             //-- it's time to fire the timer, so, move it to the "fire" list
-            //   `_timer_list__fire`
-            _tn_list_remove_entry(&(timer->timer_queue));
+            //   `_timer_list__fire`. Timeout is set to 0, so that
+            //   `_timer_cancel()` knows that timer is in the "fire" list.
+            _timer_queue_remove(timer);
+            timer->timeout = 0;
             _tn_list_add_tail(&_timer_list__fire, &(timer->timer_queue));
          } else {
             //-- We've got non-expired timer, therefore there are no more
@@ -306,48 +581,16 @@ enum TN_RCode _tn_timer_start(struct TN_Timer *timer, TN_TickCnt timeout)
       //-- cancel the timer
       _timer_cancel(timer);
 
-      //-- walk through active timers list and get the position at which
-      //   new timer should be placed.
-
-      //-- First of all, get current time
+      //-- get current time
       TN_TickCnt cur_sys_tick_cnt = _tn_timer_sys_time_get();
 
-      //-- Since timers list is sorted, we need to find the correct place
-      //   to put new timer at.
-      //
-      //   Initially, we set it to the head of the list, and then walk
-      //   through timers until we found needed place (or until list is over)
-      struct TN_ListItem *list_item = &_timer_list__gen;
-      {
-         struct TN_Timer *timer;
-         struct TN_Timer *tmp_timer;
-
-         _tn_list_for_each_entry_safe(
-               timer, struct TN_Timer, tmp_timer,
-               &_timer_list__gen, timer_queue
-               )
-         {
-            //-- timeout value should never be TN_WAIT_INFINITE.
-            _TN_BUG_ON(timer->timeout == TN_WAIT_INFINITE);
-
-            if (_time_left_get(timer, cur_sys_tick_cnt) < timeout){
-               //-- Probably this is the place for new timer..
-               list_item = &timer->timer_queue;
-            } else {
-               //-- Found timer with larger timeout than that of new timer.
-               //   So, list_item now contains the correct place for new timer.
-               break;
-            }
-         }
-      }
-
-      //-- put timer object at the right position.
-      _tn_list_add_head(list_item, &(timer->timer_queue));
-
       //-- initialize timer with given timeout
       timer->timeout = timeout;
       timer->start_tick_cnt = cur_sys_tick_cnt;
 
+      //-- put timer to the queue of active timers
+      _timer_queue_add(timer, cur_sys_tick_cnt);
+
       //-- find out when `tn_tick_int_processing()` should be called next time,
       //   and tell that to application
       _next_tick_schedule(cur_sys_tick_cnt);
@@ -57,17 +57,13 @@
 #if !TN_DYNAMIC_TICK
 
 
-
-
 /*******************************************************************************
  *    PROTECTED DATA
  ******************************************************************************/
 
 //-- see comments in the file _tn_timer_static.h
-struct TN_ListItem _tn_timer_list__gen;
-
-//-- see comments in the file _tn_timer_static.h
-struct TN_ListItem _tn_timer_list__tick[ TN_TICK_LISTS_CNT ];
+struct TN_ListItem _tn_timer_list__tick[ TN_TICK_LISTS_LEVELS ]
+                                       [ TN_TICK_LISTS_CNT ];
 
 //-- see comments in the file _tn_timer_static.h
 volatile TN_TickCnt _tn_sys_time_count;
@@ -99,15 +95,37 @@ volatile TN_TickCnt _tn_sys_time_count;
 #  error TN_TICK_LISTS_CNT must be <= 256
 #endif
 
+/**
+ * Number of bits in the index of "tick" list of a single level, i.e.
+ * `log2(TN_TICK_LISTS_CNT)`.
+ */
+#define _TICK_LISTS_BITS                                             \
+   (0                                                                \
+    + (TN_TICK_LISTS_CNT >=   2) + (TN_TICK_LISTS_CNT >=   4)         \
+    + (TN_TICK_LISTS_CNT >=   8) + (TN_TICK_LISTS_CNT >=  16)         \
+    + (TN_TICK_LISTS_CNT >=  32) + (TN_TICK_LISTS_CNT >=  64)         \
+    + (TN_TICK_LISTS_CNT >= 128) + (TN_TICK_LISTS_CNT >= 256)         \
+   )
+
+//-- Timers in the lists of level 0 are fired unconditionally, so there
+//   should be at least one more level for the timers with large timeouts.
+#if (TN_TICK_LISTS_LEVELS < 2)
+#  error TN_TICK_LISTS_LEVELS must be >= 2
+#endif
 
+//-- `TN_TickCnt` is at least 32-bit, and the whole range of the wheel,
+//   `TN_TICK_LISTS_CNT ^ TN_TICK_LISTS_LEVELS`, should fit in it.
+#if ((_TICK_LISTS_BITS * TN_TICK_LISTS_LEVELS) > 32)
+#  error TN_TICK_LISTS_CNT ^ TN_TICK_LISTS_LEVELS must be <= 2 ^ 32
+#endif
 
 /**
- * Return index in the array `#_tn_timer_list__tick`, based on given timeout.
- *
- * @param timeout    should be < TN_TICK_LISTS_CNT
+ * Return index of the "tick" list of the given level in which the timer
+ * expiring at the given tick count should be.
  */
-#define _TICK_LIST_INDEX(timeout)    \
-   (((TN_TickCnt)_tn_sys_time_count + timeout) & TN_TICK_LISTS_MASK)
+#define _TICK_LIST_INDEX(level, expires)                                 \
+   (((TN_TickCnt)(expires) >> (_TICK_LISTS_BITS * (level)))               \
+    & TN_TICK_LISTS_MASK)
 
 
 
@@ -116,6 +134,73 @@ volatile TN_TickCnt _tn_sys_time_count;
  *    PRIVATE FUNCTIONS
  ******************************************************************************/
 
+/**
+ * Add the timer to the appropriate "tick" list, depending on how far in the
+ * future it expires (see \ref timers_static_implementation). The expiration
+ * tick count should be already stored in the `timeout_cur` field of the
+ * timer.
+ */
+static void _timer_list_add(struct TN_Timer *timer)
+{
+   TN_TickCnt expires = timer->timeout_cur;
+   TN_TickCnt delta = expires - _tn_sys_time_count;
+   int level;
+
+   //-- find the lowest level which range covers the timeout: the range of
+   //   the level `N` is `TN_TICK_LISTS_CNT ^ (N + 1)` ticks.
+   for (level = 0; level < (TN_TICK_LISTS_LEVELS - 1); level++){
+      if ((delta >> (_TICK_LISTS_BITS * (level + 1))) == 0){
+         break;
+      }
+   }
+
+   if ((delta >> (_TICK_LISTS_BITS * level)) > TN_TICK_LISTS_MASK){
+      //-- timeout is beyond the range of the whole wheel: put the timer
+      //   to the list of the top level which is handled last of all (i.e.
+      //   the farthest one). When this list is handled, the timer is just
+      //   added again with its actual expiration tick count.
+      expires = _tn_sys_time_count
+         + ((TN_TickCnt)TN_TICK_LISTS_MASK << (_TICK_LISTS_BITS * level));
+   }
+
+   _tn_list_add_tail(
+         &_tn_timer_list__tick[ level ][ _TICK_LIST_INDEX(level, expires) ],
+         &(timer->timer_queue)
+         );
+}
+
+/**
+ * Move all the timers from the given "tick" list of some upper level to the
+ * lower levels (or, for the timers which are beyond the range of the wheel,
+ * to the top level again).
+ */
+static void _timer_list_cascade(struct TN_ListItem *list)
+{
+   struct TN_ListItem tmp_list;
+
+   //-- first of all, move all the timers to the temporary list, since
+   //   timers could be added back to the same list (see `_timer_list_add()`)
+   if (!_tn_list_is_empty(list)){
+      tmp_list.next = list->next;
+      tmp_list.prev = list->prev;
+      tmp_list.next->prev = &tmp_list;
+      tmp_list.prev->next = &tmp_list;
+
+      _tn_list_reset(list);
+
+      while (!_tn_list_is_empty(&tmp_list)){
+         struct TN_Timer *timer = _tn_list_first_entry(
+               &tmp_list, struct TN_Timer, timer_queue
+               );
+
+         _tn_list_remove_entry(&(timer->timer_queue));
+         _timer_list_add(timer);
+      }
+   }
+}
+
+
+
 
 /*******************************************************************************
  *    PUBLIC FUNCTIONS
@@ -132,17 +217,17 @@ volatile TN_TickCnt _tn_sys_time_count;
  */
 void _tn_timers_init(void)
 {
+   int level;
    int i;
 
    //-- reset system time
    _tn_sys_time_count = 0;
 
-   //-- reset "generic" timers list
-   _tn_list_reset(&_tn_timer_list__gen);
-
-   //-- reset all "tick" timer lists
-   for (i = 0; i < TN_TICK_LISTS_CNT; i++){
-      _tn_list_reset(&_tn_timer_list__tick[i]);
+   //-- reset all "tick" timer lists of all levels
+   for (level = 0; level < TN_TICK_LISTS_LEVELS; level++){
+      for (i = 0; i < TN_TICK_LISTS_CNT; i++){
+         _tn_list_reset(&_tn_timer_list__tick[level][i]);
+      }
    }
 }
 
@@ -152,63 +237,44 @@ void _tn_timers_init(void)
 void _tn_timers_tick_proceed(TN_UWord TN_INTSAVE_VAR)
 {
    //-- first of all, increment system timer
-   _tn_sys_time_count++;
+   TN_TickCnt cur_time = ++_tn_sys_time_count;
 
-   int tick_list_index = _TICK_LIST_INDEX(0);
+   int tick_list_index = _TICK_LIST_INDEX(0, cur_time);
 
    //-- interrupts should be disabled here
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
-   if (tick_list_index == 0){
-      //-- it happens each TN_TICK_LISTS_CNT-th system tick:
-      //   now we should walk through all the timers in the "generic" timer
-      //   list, decrement the timeout of each one by TN_TICK_LISTS_CNT,
-      //   and if resulting timeout is less than TN_TICK_LISTS_CNT,
-      //   then move that timer to the appropriate "tick" timer list.
-
-      //-- handle "generic" timer list {{{
-      {
-         struct TN_Timer *timer;
-         struct TN_Timer *tmp_timer;
-
-         _tn_list_for_each_entry_safe(
-               timer, struct TN_Timer, tmp_timer,
-               &_tn_timer_list__gen, timer_queue
-               )
-         {
-
-            //-- timeout value should always be >= TN_TICK_LISTS_CNT here.
-            //   And it should never be TN_WAIT_INFINITE.
-            _TN_BUG_ON(0
-                  || timer->timeout_cur == TN_WAIT_INFINITE 
-                  || timer->timeout_cur < TN_TICK_LISTS_CNT
-                  );
-
-            timer->timeout_cur -= TN_TICK_LISTS_CNT;
-
-            if (timer->timeout_cur < TN_TICK_LISTS_CNT){
-               //-- it's time to move this timer to the "tick" list
-               _tn_list_remove_entry(&(timer->timer_queue));
-               _tn_list_add_tail(
-                     &_tn_timer_list__tick[_TICK_LIST_INDEX(timer->timeout_cur)],
-                     &(timer->timer_queue)
-                     );
-            }
-         }
+   //-- handle upper levels {{{
+   {
+      //-- each `TN_TICK_LISTS_CNT`-th tick (i.e. when the index of the
+      //   level 0 wraps around), the next list of the level 1 is cascaded to
+      //   the lower level; when the index of the level 1 wraps around, the
+      //   next list of the level 2 is cascaded too, etc.
+      //
+      //   So, the timer is cascaded at most `(TN_TICK_LISTS_LEVELS - 1)`
+      //   times during its lifetime, and the list of the level `N` is
+      //   handled once per `TN_TICK_LISTS_CNT ^ N` ticks.
+      int level = 1;
+      int level_index = tick_list_index;
+
+      while (level_index == 0 && level < TN_TICK_LISTS_LEVELS){
+         level_index = _TICK_LIST_INDEX(level, cur_time);
+         _timer_list_cascade(&_tn_timer_list__tick[ level ][ level_index ]);
+         level++;
       }
-      //}}}
    }
+   //}}}
 
    //-- it happens every system tick:
-   //   we should walk through all the timers in the current "tick" timer list,
-   //   and fire them all, unconditionally.
+   //   we should walk through all the timers in the current "tick" timer list
+   //   of the level 0, and fire them all, unconditionally.
 
    //-- handle current "tick" timer list {{{
    {
       struct TN_Timer *timer;
 
       struct TN_ListItem *p_cur_timer_list = 
-         &_tn_timer_list__tick[ tick_list_index ];
+         &_tn_timer_list__tick[ 0 ][ tick_list_index ];
 
       //-- now, p_cur_timer_list is a list of timers that we should
       //   fire NOW, unconditionally.
@@ -221,8 +287,8 @@ void _tn_timers_tick_proceed(TN_UWord TN_INTSAVE_VAR)
       //
       //   Although timers could be removed from the list, note that
       //   new timer can't be added to it
-      //   (because timeout 0 is disallowed, and timer with timeout
-      //   TN_TICK_LISTS_CNT is added to the "generic" list),
+      //   (because timeout 0 is disallowed, and timer with larger timeout
+      //   is added to the other list of level 0 or to the upper level),
       //   see implementation details in the tn_timer.h file
       while (!_tn_list_is_empty(p_cur_timer_list)){
          timer = _tn_list_first_entry(
@@ -259,22 +325,10 @@ enum TN_RCode _tn_timer_start(struct TN_Timer *timer, TN_TickCnt timeout)
       //-- if timer is active, cancel it first
       if ((rc = _tn_timer_cancel(timer)) == TN_RC_OK){
 
-         if (timeout < TN_TICK_LISTS_CNT){
-            //-- timer should be added to the one of "tick" lists.
-            int tick_list_index = _TICK_LIST_INDEX(timeout);
-            timer->timeout_cur = tick_list_index;
-
-            _tn_list_add_tail(
-                  &_tn_timer_list__tick[ tick_list_index ],
-                  &(timer->timer_queue)
-                  );
-         } else {
-            //-- timer should be added to the "generic" list.
-            //   We should set timeout_cur adding current "tick" index to it.
-            timer->timeout_cur = timeout + _TICK_LIST_INDEX(0);
-
-            _tn_list_add_tail(&_tn_timer_list__gen, &(timer->timer_queue));
-         }
+         //-- remember tick count at which the timer expires, and add it
+         //   to the appropriate "tick" list
+         timer->timeout_cur = _tn_sys_time_count + timeout;
+         _timer_list_add(timer);
       }
    }
 
@@ -300,6 +354,12 @@ enum TN_RCode _tn_timer_cancel(struct TN_Timer *timer)
 
       //-- reset the list
       _tn_list_reset(&(timer->timer_queue));
+
+#if TN_TIMER_TASK
+      //-- if timer was pending (see `_tn_timer_task_defer()`), it is just
+      //   removed from the list of pending timers
+      timer->pending = TN_FALSE;
+#endif
    }
 
    return rc;
@@ -316,19 +376,11 @@ TN_TickCnt _tn_timer_time_left(struct TN_Timer *timer)
    _TN_BUG_ON( !TN_IS_INT_DISABLED() );
 
    if (_tn_timer_is_active(timer)){
-      TN_TickCnt tick_list_index = _TICK_LIST_INDEX(0);
-
-      if (timer->timeout_cur > tick_list_index){
-         time_left = timer->timeout_cur - tick_list_index;
-      } else if (timer->timeout_cur < tick_list_index){
-         time_left = timer->timeout_cur + TN_TICK_LISTS_CNT - tick_list_index;
-      } else {
-#if TN_DEBUG
-         //-- timer->timeout_cur should never be equal to tick_list_index here
-         //   (if it is, timer is inactive, so, we don't get here)
-         _TN_FATAL_ERROR();
-#endif
-      }
+      //-- NOTE: it is 0 if the list of level 0 which contains the timer is
+      //   being handled by `_tn_timers_tick_proceed()` right now (e.g. this
+      //   function is called from the callback of another timer): the timer
+      //   is going to fire in this tick.
+      time_left = timer->timeout_cur - _tn_sys_time_count;
    }
 
    return time_left;
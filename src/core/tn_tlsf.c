@@ -0,0 +1,1117 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+#include "tn_tlsf.h"
+#include "_tn_tlsf.h"
+
+#include "tn_tasks.h"
+
+//-- std header for offsetof()
+#include <stddef.h>
+
+
+
+//-- check TN_TLSF_FL_INDEX_MAX value
+#if TN_TLSF_FL_INDEX_MAX >= TN_INT_WIDTH
+#  error TN_TLSF_FL_INDEX_MAX should be less than TN_INT_WIDTH
+#elif TN_TLSF_FL_INDEX_MAX < 8
+#  error TN_TLSF_FL_INDEX_MAX should be at least 8
+#endif
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/**
+ * Header of the memory block.
+ *
+ * Only the `size` field actually belongs to the header of the block: 
+ *
+ * - `prev_phys` is the last word of the previous (physically) block, and it
+ *   is valid if only the previous block is free;
+ * - `next_free` and `prev_free` are the first words of the block payload,
+ *   and they are valid if only the block itself is free.
+ *
+ * So, the overhead of the used block is just one word.
+ *
+ * Note: the code assumes that pointer takes exactly one `#TN_UWord`.
+ */
+struct _TN_TlsfBlock {
+   ///
+   /// previous physical block, valid if only it is free
+   struct _TN_TlsfBlock *prev_phys;
+   ///
+   /// size of the block payload, in bytes. Since the size is always
+   /// a multiple of 4, two least significant bits are used for flags:
+   /// `_BLOCK_FREE` and `_BLOCK_PREV_FREE`.
+   TN_UWord              size;
+   ///
+   /// next block in the free list, valid if only the block is free
+   struct _TN_TlsfBlock *next_free;
+   ///
+   /// previous block in the free list, valid if only the block is free
+   struct _TN_TlsfBlock *prev_free;
+};
+
+
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- flags stored in the `size` field of the block
+#define _BLOCK_FREE              ((TN_UWord)1 << 0)
+#define _BLOCK_PREV_FREE         ((TN_UWord)1 << 1)
+#define _BLOCK_FLAGS             (_BLOCK_FREE | _BLOCK_PREV_FREE)
+
+//-- overhead of the used block: just the `size` field
+#define _BLOCK_OVERHEAD          (sizeof(TN_UWord))
+
+//-- offset of the payload from the start of the block header
+#define _BLOCK_PAYLOAD_OFFSET    (offsetof(struct _TN_TlsfBlock, next_free))
+
+//-- granularity of block sizes
+#define _ALIGN_SIZE              ((unsigned int)1 << _TN_TLSF_ALIGN_LOG2)
+#define _ALIGN_UP(x)             (((x) + (_ALIGN_SIZE - 1)) & ~(_ALIGN_SIZE - 1))
+
+//-- minimum block size: free block should be able to hold `next_free`,
+//   `prev_free`, and `prev_phys` of the next block
+#define _BLOCK_SIZE_MIN                                                 \
+   _ALIGN_UP(sizeof(struct _TN_TlsfBlock) - sizeof(struct _TN_TlsfBlock *))
+
+//-- block size should be less than this value
+#define _BLOCK_SIZE_MAX          ((unsigned int)1 << TN_TLSF_FL_INDEX_MAX)
+
+//-- blocks smaller than this size are all in the first-level list 0
+#define _SMALL_BLOCK_SIZE        ((unsigned int)1 << _TN_TLSF_FL_SHIFT)
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_Tlsf *tlsf
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (tlsf == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_tlsf_is_valid(tlsf)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_Tlsf *tlsf,
+      const void *start_addr
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (tlsf == TN_NULL || start_addr == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (_tn_tlsf_is_valid(tlsf)){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_alloc(
+      const struct TN_Tlsf *tlsf,
+      void **p_data
+      )
+{
+   enum TN_RCode rc = _check_param_generic(tlsf);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (p_data == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_free(
+      const struct TN_Tlsf *tlsf,
+      void *p_data
+      )
+{
+   enum TN_RCode rc = _check_param_generic(tlsf);
+   unsigned char *p = (unsigned char *)p_data;
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (
+         p < (unsigned char *)tlsf->start_addr + _BLOCK_OVERHEAD
+         || p >= (unsigned char *)tlsf->start_addr + tlsf->size
+         || ((TN_UWord)p & (sizeof(TN_UWord) - 1)) != 0
+         )
+   {
+      //-- the block doesn't belong to the heap
+      rc = TN_RC_WPARAM;
+   } else if (
+         ((struct _TN_TlsfBlock *)(p - _BLOCK_PAYLOAD_OFFSET))->size
+         & _BLOCK_FREE
+         )
+   {
+      //-- the block is already free
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(tlsf)                  (TN_RC_OK)
+#  define _check_param_create(tlsf, start_addr)       (TN_RC_OK)
+#  define _check_param_alloc(tlsf, p_data)            (TN_RC_OK)
+#  define _check_param_free(tlsf, p_data)             (TN_RC_OK)
+#endif
+// }}}
+
+
+//-- Bit operations {{{
+
+/**
+ * Returns index of the least significant bit set in the given word (which
+ * must be non-zero). So, for `0xa8` it returns `3`.
+ */
+_TN_STATIC_INLINE int _find_first_set(unsigned int word)
+{
+#ifdef _TN_FFS
+   return _TN_FFS(word) - 1;
+#else
+   int ret = 0;
+
+   while (!(word & 1)){
+      word >>= 1;
+      ret++;
+   }
+
+   return ret;
+#endif
+}
+
+/**
+ * Returns index of the most significant bit set in the given word (which
+ * must be non-zero). So, for `0xa8` it returns `7`.
+ */
+_TN_STATIC_INLINE int _find_last_set(unsigned int word)
+{
+#ifdef _TN_FLS
+   return _TN_FLS(word) - 1;
+#else
+   int ret = 0;
+
+   while (word >>= 1){
+      ret++;
+   }
+
+   return ret;
+#endif
+}
+
+// }}}
+
+
+//-- Block header access {{{
+
+_TN_STATIC_INLINE unsigned int _block_size(const struct _TN_TlsfBlock *block)
+{
+   return (unsigned int)(block->size & ~_BLOCK_FLAGS);
+}
+
+_TN_STATIC_INLINE void _block_size_set(
+      struct _TN_TlsfBlock *block,
+      unsigned int size
+      )
+{
+   block->size = (TN_UWord)size | (block->size & _BLOCK_FLAGS);
+}
+
+_TN_STATIC_INLINE void *_block_to_ptr(struct _TN_TlsfBlock *block)
+{
+   return (unsigned char *)block + _BLOCK_PAYLOAD_OFFSET;
+}
+
+_TN_STATIC_INLINE struct _TN_TlsfBlock *_block_from_ptr(void *ptr)
+{
+   return (struct _TN_TlsfBlock *)((unsigned char *)ptr - _BLOCK_PAYLOAD_OFFSET);
+}
+
+/**
+ * Returns the block which follows the given one physically. The header of
+ * the next block starts at the last word of the given block payload (since
+ * `prev_phys` of the next block is stored there).
+ */
+_TN_STATIC_INLINE struct _TN_TlsfBlock *_block_next(
+      struct _TN_TlsfBlock *block
+      )
+{
+   return (struct _TN_TlsfBlock *)(
+         (unsigned char *)_block_to_ptr(block)
+         + _block_size(block) - _BLOCK_OVERHEAD
+         );
+}
+
+/**
+ * Make the next block point to the given one as to its physical
+ * predecessor, and return the next block.
+ */
+_TN_STATIC_INLINE struct _TN_TlsfBlock *_block_link_next(
+      struct _TN_TlsfBlock *block
+      )
+{
+   struct _TN_TlsfBlock *next = _block_next(block);
+   next->prev_phys = block;
+   return next;
+}
+
+_TN_STATIC_INLINE void _block_mark_as_free(struct _TN_TlsfBlock *block)
+{
+   struct _TN_TlsfBlock *next = _block_link_next(block);
+
+   next->size  |= _BLOCK_PREV_FREE;
+   block->size |= _BLOCK_FREE;
+}
+
+_TN_STATIC_INLINE void _block_mark_as_used(struct _TN_TlsfBlock *block)
+{
+   struct _TN_TlsfBlock *next = _block_next(block);
+
+   next->size  &= ~_BLOCK_PREV_FREE;
+   block->size &= ~_BLOCK_FREE;
+}
+
+// }}}
+
+
+//-- Size mapping {{{
+
+/**
+ * Compute indexes of the free list to which the block of the given size
+ * belongs.
+ */
+_TN_STATIC_INLINE void _mapping_insert(unsigned int size, int *p_fl, int *p_sl)
+{
+   int fl;
+   int sl;
+
+   if (size < _SMALL_BLOCK_SIZE){
+      //-- small blocks are split linearly in the first-level list 0
+      fl = 0;
+      sl = (int)(size >> _TN_TLSF_ALIGN_LOG2);
+   } else {
+      fl = _find_last_set(size);
+      sl = (int)(size >> (fl - _TN_TLSF_SL_CNT_LOG2))
+         ^ (1 << _TN_TLSF_SL_CNT_LOG2);
+      fl -= (_TN_TLSF_FL_SHIFT - 1);
+   }
+
+   *p_fl = fl;
+   *p_sl = sl;
+}
+
+/**
+ * Compute indexes of the first free list whose blocks are all large enough
+ * to hold the given size: that is, the size is rounded up to the next
+ * second-level range. This way, the first block of the list fits for sure,
+ * and we never need to walk the list.
+ */
+_TN_STATIC_INLINE void _mapping_search(unsigned int size, int *p_fl, int *p_sl)
+{
+   if (size >= _SMALL_BLOCK_SIZE){
+      size += (1u << (_find_last_set(size) - _TN_TLSF_SL_CNT_LOG2)) - 1;
+   }
+
+   _mapping_insert(size, p_fl, p_sl);
+}
+
+/**
+ * Round the requested size up to the granularity and to the minimum block
+ * size; returns 0 if the size is 0 or too large.
+ */
+_TN_STATIC_INLINE unsigned int _size_adjust(unsigned int size)
+{
+   unsigned int ret = 0;
+
+   if (size > 0 && size < _BLOCK_SIZE_MAX){
+      ret = _ALIGN_UP(size);
+
+      if (ret < _BLOCK_SIZE_MIN){
+         ret = _BLOCK_SIZE_MIN;
+      } else if (ret >= _BLOCK_SIZE_MAX){
+         ret = 0;
+      }
+   }
+
+   return ret;
+}
+
+// }}}
+
+
+//-- Free lists {{{
+
+static void _free_list_remove(
+      struct TN_Tlsf *tlsf,
+      struct _TN_TlsfBlock *block,
+      int fl,
+      int sl
+      )
+{
+   struct _TN_TlsfBlock *prev = block->prev_free;
+   struct _TN_TlsfBlock *next = block->next_free;
+
+   if (next != TN_NULL){
+      next->prev_free = prev;
+   }
+
+   if (prev != TN_NULL){
+      prev->next_free = next;
+   } else {
+      //-- the block is the head of the list
+      tlsf->free_lists[fl][sl] = next;
+
+      if (next == TN_NULL){
+         //-- the list became empty, so, clear bitmaps
+         tlsf->sl_bitmap[fl] &= (unsigned char)~(1u << sl);
+         if (tlsf->sl_bitmap[fl] == 0){
+            tlsf->fl_bitmap &= ~(1u << fl);
+         }
+      }
+   }
+
+   tlsf->free_size -= _block_size(block);
+}
+
+static void _free_list_insert(
+      struct TN_Tlsf *tlsf,
+      struct _TN_TlsfBlock *block,
+      int fl,
+      int sl
+      )
+{
+   struct _TN_TlsfBlock *head = tlsf->free_lists[fl][sl];
+
+   block->next_free = head;
+   block->prev_free = TN_NULL;
+   if (head != TN_NULL){
+      head->prev_free = block;
+   }
+
+   tlsf->free_lists[fl][sl] = block;
+   tlsf->sl_bitmap[fl] |= (unsigned char)(1u << sl);
+   tlsf->fl_bitmap |= (1u << fl);
+
+   tlsf->free_size += _block_size(block);
+}
+
+/**
+ * Remove free block from the free list it belongs to
+ */
+static void _block_remove(struct TN_Tlsf *tlsf, struct _TN_TlsfBlock *block)
+{
+   int fl;
+   int sl;
+
+   _mapping_insert(_block_size(block), &fl, &sl);
+   _free_list_remove(tlsf, block, fl, sl);
+}
+
+/**
+ * Insert free block to the free list it belongs to
+ */
+static void _block_insert(struct TN_Tlsf *tlsf, struct _TN_TlsfBlock *block)
+{
+   int fl;
+   int sl;
+
+   _mapping_insert(_block_size(block), &fl, &sl);
+   _free_list_insert(tlsf, block, fl, sl);
+}
+
+/**
+ * Find free block that can hold `size` bytes (which should be already
+ * adjusted by `_size_adjust()`). The block isn't removed from the free list.
+ *
+ * @return
+ *    The block, or `TN_NULL` if there's no suitable block. If the block is
+ *    found, its free list indexes are stored at `p_fl` and `p_sl`.
+ */
+static struct _TN_TlsfBlock *_suitable_block_find(
+      struct TN_Tlsf *tlsf,
+      unsigned int size,
+      int *p_fl,
+      int *p_sl
+      )
+{
+   struct _TN_TlsfBlock *block = TN_NULL;
+   unsigned int sl_map = 0;
+   int fl;
+   int sl;
+
+   _mapping_search(size, &fl, &sl);
+
+   if (fl < _TN_TLSF_FL_CNT){
+      //-- first, look for the non-empty list in the same first-level range
+      sl_map = tlsf->sl_bitmap[fl] & (~0u << sl);
+
+      if (sl_map == 0){
+         //-- there are no suitable blocks in this first-level range,
+         //   so, look for the next non-empty one
+         unsigned int fl_map = tlsf->fl_bitmap & (~0u << (fl + 1));
+
+         if (fl_map != 0){
+            fl = _find_first_set(fl_map);
+            sl_map = tlsf->sl_bitmap[fl];
+         }
+      }
+   }
+
+   if (sl_map != 0){
+      sl = _find_first_set(sl_map);
+      block = tlsf->free_lists[fl][sl];
+   } else {
+      //-- there are no lists whose blocks are all large enough; but the
+      //   list to which the requested size itself belongs might still have
+      //   a large enough block. We check the head of that list only, so
+      //   that the time is still bounded. (Without this, say, the whole
+      //   heap can never be allocated at once)
+      _mapping_insert(size, &fl, &sl);
+
+      if (
+            fl < _TN_TLSF_FL_CNT
+            && tlsf->free_lists[fl][sl] != TN_NULL
+            && _block_size(tlsf->free_lists[fl][sl]) >= size
+         )
+      {
+         block = tlsf->free_lists[fl][sl];
+      }
+   }
+
+   if (block != TN_NULL){
+      *p_fl = fl;
+      *p_sl = sl;
+   }
+
+   return block;
+}
+
+// }}}
+
+
+//-- Split and merge {{{
+
+/**
+ * Split the block into two: the first one of size `size`, and the rest.
+ * The rest is marked as free and returned.
+ */
+static struct _TN_TlsfBlock *_block_split(
+      struct _TN_TlsfBlock *block,
+      unsigned int size
+      )
+{
+   struct _TN_TlsfBlock *rest = (struct _TN_TlsfBlock *)(
+         (unsigned char *)_block_to_ptr(block) + size - _BLOCK_OVERHEAD
+         );
+
+   rest->size = (TN_UWord)(_block_size(block) - (size + _BLOCK_OVERHEAD));
+   _block_size_set(block, size);
+   _block_mark_as_free(rest);
+
+   return rest;
+}
+
+/**
+ * Absorb the block into its physical predecessor, return the predecessor
+ */
+static struct _TN_TlsfBlock *_block_absorb(
+      struct _TN_TlsfBlock *prev,
+      struct _TN_TlsfBlock *block
+      )
+{
+   prev->size += _block_size(block) + _BLOCK_OVERHEAD;
+   _block_link_next(prev);
+
+   return prev;
+}
+
+/**
+ * Merge the free block with adjacent free blocks (if any); merged blocks are
+ * removed from their free lists. Returns the resulting block.
+ */
+static struct _TN_TlsfBlock *_block_merge(
+      struct TN_Tlsf *tlsf,
+      struct _TN_TlsfBlock *block
+      )
+{
+   struct _TN_TlsfBlock *next;
+
+   if (block->size & _BLOCK_PREV_FREE){
+      struct _TN_TlsfBlock *prev = block->prev_phys;
+
+      _block_remove(tlsf, prev);
+      block = _block_absorb(prev, block);
+   }
+
+   //-- note: the last block in the heap is a zero-size sentinel which is
+   //   never free, so we never go beyond the heap
+   next = _block_next(block);
+   if (next->size & _BLOCK_FREE){
+      _block_remove(tlsf, next);
+      block = _block_absorb(block, next);
+   }
+
+   return block;
+}
+
+// }}}
+
+
+/**
+ * Allocate block of the given size (which should be already adjusted by
+ * `_size_adjust()`).
+ *
+ * @return
+ *    Pointer to the payload of allocated block, or `TN_NULL` if there is no
+ *    suitable free block.
+ */
+static void *_tlsf_alloc(struct TN_Tlsf *tlsf, unsigned int size)
+{
+   void *ptr = TN_NULL;
+   int fl;
+   int sl;
+   struct _TN_TlsfBlock *block = _suitable_block_find(tlsf, size, &fl, &sl);
+
+   if (block != TN_NULL){
+      _free_list_remove(tlsf, block, fl, sl);
+
+      //-- if the block is large enough, split it and return the rest
+      //   to the free lists
+      if (_block_size(block) >= size + _BLOCK_OVERHEAD + _BLOCK_SIZE_MIN){
+         struct _TN_TlsfBlock *rest = _block_split(block, size);
+
+         //-- _block_split() has marked the rest as free, and at the moment,
+         //   the block is still free as well; then, _block_mark_as_used()
+         //   below clears the _BLOCK_PREV_FREE flag of the rest.
+         _block_insert(tlsf, rest);
+      }
+
+      _block_mark_as_used(block);
+      ptr = _block_to_ptr(block);
+   }
+
+   return ptr;
+}
+
+/**
+ * Release the block: merge it with adjacent free blocks, and insert the
+ * result to the free list.
+ */
+static void _tlsf_free(struct TN_Tlsf *tlsf, void *ptr)
+{
+   struct _TN_TlsfBlock *block = _block_from_ptr(ptr);
+
+   _block_mark_as_free(block);
+   block = _block_merge(tlsf, block);
+   _block_insert(tlsf, block);
+}
+
+/**
+ * Returns index of the wait queue for the given size (which should be
+ * already adjusted by `_size_adjust()`): the first-level index of the free
+ * lists at which the search for such a block starts.
+ */
+_TN_STATIC_INLINE int _wait_queue_idx_get(unsigned int size)
+{
+   int fl;
+   int sl;
+
+   _mapping_search(size, &fl, &sl);
+
+   //-- the size rounded up might get beyond the last first-level range
+   return (fl < _TN_TLSF_FL_CNT) ? fl : (_TN_TLSF_FL_CNT - 1);
+}
+
+/**
+ * Returns priority index of the wait queue with the given index if tasks
+ * wait in priority order (see `#TN_USE_PRIO_WAIT_QUEUES`), or `TN_NULL`
+ * otherwise.
+ */
+_TN_STATIC_INLINE struct TN_ListPrioIdx *_wait_queue_prio(
+      struct TN_Tlsf *tlsf,
+      int idx
+      )
+{
+#if TN_USE_PRIO_WAIT_QUEUES
+   return &(tlsf->wait_queues_prio[idx]);
+#else
+   _TN_UNUSED(tlsf);
+   _TN_UNUSED(idx);
+   return TN_NULL;
+#endif
+}
+
+/**
+ * Serve the tasks waiting for memory: look at the first task of each
+ * non-empty wait queue, and among those whose request fits, the task with
+ * the highest priority (on equal priorities: the one from the queue of
+ * smaller requests) gets its block and is woken up. Repeat until none of
+ * them fits.
+ *
+ * Only the first task of each queue is examined (it has the highest
+ * priority in its queue, if only queues are ordered by priority), so, each
+ * woken up task costs one pass over at most `_TN_TLSF_FL_CNT` queues, and
+ * the last pass finds no task to wake up.
+ */
+static void _waiters_serve(struct TN_Tlsf *tlsf)
+{
+   struct TN_Task *task;
+
+   do {
+      unsigned int bitmap = tlsf->wait_bitmap;
+
+      task = TN_NULL;
+
+      while (bitmap != 0){
+         int idx = _find_first_set(bitmap);
+         struct TN_ListItem *wait_queue = &(tlsf->wait_queues[idx]);
+
+         bitmap &= ~(1u << idx);
+
+         if (_tn_list_is_empty(wait_queue)){
+            //-- all the tasks have left this queue (because of timeout, say)
+            tlsf->wait_bitmap &= ~(1u << idx);
+         } else {
+            struct TN_Task *head = _tn_list_first_entry(
+                  wait_queue, struct TN_Task, task_queue
+                  );
+            int fl;
+            int sl;
+
+            //-- queues are examined from the smaller requests, so, the
+            //   task of the later queue wins on strictly higher priority only
+            if (     (task == TN_NULL || head->priority < task->priority)
+                  && _suitable_block_find(
+                     tlsf, head->subsys_wait.tlsf.size, &fl, &sl
+                     ) != TN_NULL
+               )
+            {
+               task = head;
+            }
+         }
+      }
+
+      if (task != TN_NULL){
+         //-- the block was just found by _suitable_block_find(), so
+         //   the allocation succeeds
+         task->subsys_wait.tlsf.data_elem
+            = _tlsf_alloc(tlsf, task->subsys_wait.tlsf.size);
+         _tn_task_wait_complete(task, TN_RC_OK);
+      }
+   } while (task != TN_NULL);
+}
+
+/**
+ * Allocate block without waiting, common for `tn_tlsf_alloc_polling()` and
+ * `tn_tlsf_ialloc_polling()`. Interrupts should be disabled.
+ */
+static enum TN_RCode _alloc_polling(
+      struct TN_Tlsf *tlsf,
+      unsigned int size,
+      void **p_data
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+   void *ptr = _tlsf_alloc(tlsf, size);
+
+   if (ptr != TN_NULL){
+      *p_data = ptr;
+   } else {
+      rc = TN_RC_TIMEOUT;
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+enum TN_RCode tn_tlsf_create(
+      struct TN_Tlsf         *tlsf,
+      void                   *start_addr,
+      unsigned int            size
+      )
+{
+   enum TN_RCode rc = _check_param_create(tlsf, start_addr);
+
+   if (rc == TN_RC_OK){
+      //-- align start address to the word boundary
+      TN_UWord addr = ((TN_UWord)start_addr + (sizeof(TN_UWord) - 1))
+         & ~(TN_UWord)(sizeof(TN_UWord) - 1);
+      unsigned int align_loss = (unsigned int)(addr - (TN_UWord)start_addr);
+      unsigned int block_size = 0;
+
+      //-- two words are taken by the `size` fields of the first block and
+      //   of the sentinel
+      if (size >= align_loss + 2 * _BLOCK_OVERHEAD){
+         block_size = (size - align_loss - 2 * _BLOCK_OVERHEAD)
+            & ~(_ALIGN_SIZE - 1);
+      }
+
+      if (block_size < _BLOCK_SIZE_MIN || block_size >= _BLOCK_SIZE_MAX){
+         rc = TN_RC_WPARAM;
+      }
+
+      if (rc == TN_RC_OK){
+         struct _TN_TlsfBlock *block;
+         struct _TN_TlsfBlock *sentinel;
+         int fl;
+         int sl;
+
+         tlsf->start_addr  = (void *)addr;
+         tlsf->size        = block_size + 2 * _BLOCK_OVERHEAD;
+         tlsf->free_size   = 0;
+         tlsf->fl_bitmap   = 0;
+
+         for (fl = 0; fl < _TN_TLSF_FL_CNT; fl++){
+            tlsf->sl_bitmap[fl] = 0;
+            for (sl = 0; sl < _TN_TLSF_SL_CNT; sl++){
+               tlsf->free_lists[fl][sl] = TN_NULL;
+            }
+         }
+
+         //-- the whole area is one free block. Its header starts one word
+         //   before the area (since `prev_phys` is never accessed for the
+         //   first block), and the last word of the area is the `size` of
+         //   the zero-size used sentinel block.
+         block = (struct _TN_TlsfBlock *)(addr - _BLOCK_OVERHEAD);
+         block->size = (TN_UWord)block_size | _BLOCK_FREE;
+
+         sentinel = _block_link_next(block);
+         sentinel->size = _BLOCK_PREV_FREE;
+
+         _block_insert(tlsf, block);
+
+         for (fl = 0; fl < _TN_TLSF_FL_CNT; fl++){
+            _tn_list_reset(&(tlsf->wait_queues[fl]));
+#if TN_USE_PRIO_WAIT_QUEUES
+            _tn_list_prio_idx_reset(&(tlsf->wait_queues_prio[fl]));
+#endif
+         }
+         tlsf->wait_bitmap = 0;
+
+         tlsf->id_tlsf = TN_ID_TLSF;
+      }
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+enum TN_RCode tn_tlsf_delete(struct TN_Tlsf *tlsf)
+{
+   enum TN_RCode rc = _check_param_generic(tlsf);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      int idx;
+
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- remove all tasks (if any) from the wait queues
+      for (idx = 0; idx < _TN_TLSF_FL_CNT; idx++){
+         _tn_wait_queue_notify_deleted(&(tlsf->wait_queues[idx]));
+      }
+
+      tlsf->id_tlsf = TN_ID_NONE; //-- heap does not exist now
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+enum TN_RCode tn_tlsf_alloc(
+      struct TN_Tlsf         *tlsf,
+      unsigned int            size,
+      void                  **p_data,
+      TN_TickCnt              timeout
+      )
+{
+   TN_BOOL waited_for_data = TN_FALSE;
+   enum TN_RCode rc = _check_param_alloc(tlsf, p_data);
+
+   size = _size_adjust(size);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else if (size == 0){
+      rc = TN_RC_WPARAM;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      rc = _alloc_polling(tlsf, size, p_data);
+
+      if (rc == TN_RC_TIMEOUT && timeout > 0){
+         int idx = _wait_queue_idx_get(size);
+
+         _tn_curr_run_task->subsys_wait.tlsf.size = size;
+         _tn_task_curr_to_wait_action_wprio(
+               &(tlsf->wait_queues[idx]),
+               _wait_queue_prio(tlsf, idx),
+               TN_WAIT_REASON_TLSF_WALLOC,
+               timeout
+               );
+         tlsf->wait_bitmap |= (1u << idx);
+         waited_for_data = TN_TRUE;
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+      if (waited_for_data){
+
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+
+         //-- if wait result is TN_RC_OK, copy memory block pointer to the
+         //   user's location
+         if (rc == TN_RC_OK){
+            *p_data = _tn_curr_run_task->subsys_wait.tlsf.data_elem;
+         }
+
+      }
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+enum TN_RCode tn_tlsf_alloc_polling(
+      struct TN_Tlsf         *tlsf,
+      unsigned int            size,
+      void                  **p_data
+      )
+{
+   enum TN_RCode rc = _check_param_alloc(tlsf, p_data);
+
+   size = _size_adjust(size);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else if (size == 0){
+      rc = TN_RC_WPARAM;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+      rc = _alloc_polling(tlsf, size, p_data);
+      TN_INT_RESTORE();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+enum TN_RCode tn_tlsf_ialloc_polling(
+      struct TN_Tlsf         *tlsf,
+      unsigned int            size,
+      void                  **p_data
+      )
+{
+   enum TN_RCode rc = _check_param_alloc(tlsf, p_data);
+
+   size = _size_adjust(size);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else if (size == 0){
+      rc = TN_RC_WPARAM;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+      rc = _alloc_polling(tlsf, size, p_data);
+      TN_INT_IRESTORE();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+enum TN_RCode tn_tlsf_free(struct TN_Tlsf *tlsf, void *p_data)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- check params with interrupts disabled, since the header of
+      //   the block is checked as well
+      rc = _check_param_free(tlsf, p_data);
+
+      if (rc == TN_RC_OK){
+         _tlsf_free(tlsf, p_data);
+         _waiters_serve(tlsf);
+      }
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+enum TN_RCode tn_tlsf_ifree(struct TN_Tlsf *tlsf, void *p_data)
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      //-- check params with interrupts disabled, since the header of
+      //   the block is checked as well
+      rc = _check_param_free(tlsf, p_data);
+
+      if (rc == TN_RC_OK){
+         _tlsf_free(tlsf, p_data);
+         _waiters_serve(tlsf);
+      }
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_tlsf.h)
+ */
+int tn_tlsf_free_size_get(struct TN_Tlsf *tlsf)
+{
+   int ret = -1;
+
+   enum TN_RCode rc = _check_param_generic(tlsf);
+   if (rc == TN_RC_OK){
+      //-- It's not needed to disable interrupts here, since `free_size`
+      //   is read by just one assembler instruction
+      ret = (int)tlsf->free_size;
+   }
+
+   return ret;
+}
+
+
@@ -0,0 +1,366 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * TLSF (two-level segregated fit) heap: general-purpose allocator of
+ * variable-size blocks, for buffers with no fixed size (say, network records
+ * or file chunks), where \ref tn_fmem.h "fixed memory pool" or even
+ * \ref tn_heap.h "size-class heap" would waste too much RAM.
+ *
+ * Both allocation and release take bounded time, independently of the number
+ * of blocks and the heap size: free blocks are kept in the segregated lists
+ * indexed by two levels of size ranges (first level: power of two; second
+ * level: 8 linear subranges of it), and two-level bitmap of non-empty lists
+ * allows to find a suitable free block with just two find-first-set
+ * operations. Adjacent free blocks are merged immediately on release.
+ *
+ * Each allocated block takes one extra word for the header, and the block
+ * size is rounded up to 4 bytes (8 bytes on 64-bit systems), and to three
+ * words at least. The maximum size of the heap is given by
+ * `#TN_TLSF_FL_INDEX_MAX`.
+ *
+ * The heap is kernel-aware: if there's no free block large enough, the task
+ * may wait for it, with timeout. Waiting tasks are kept in separate queues
+ * by the first-level size range of their requests. When the memory is
+ * released, the kernel looks at the first task of each non-empty queue, and
+ * among those whose request fits, the task with the highest priority gets
+ * its block and is woken up (on equal priorities, the smaller request wins);
+ * this repeats until none of them fits. So, a large request doesn't block
+ * the smaller requests of other tasks, and release takes bounded time: each
+ * woken up task costs one pass over at most `_TN_TLSF_FL_CNT` queues.
+ *
+ * Within each queue, tasks are ordered by priority if only
+ * `#TN_USE_PRIO_WAIT_QUEUES` option is non-zero (then, each queue has its
+ * own priority index, which takes `_TN_TLSF_FL_CNT` times
+ * `struct #TN_ListPrioIdx` of RAM per heap); otherwise, queues are FIFO, and
+ * priority decides between the first tasks of different queues only.
+ */
+
+#ifndef _TN_TLSF_H
+#define _TN_TLSF_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_sys.h"
+
+
+
+/*******************************************************************************
+ *    EXTERN TYPES
+ ******************************************************************************/
+
+/*
+ * Header of the memory block; defined in tn_tlsf.c
+ */
+struct _TN_TlsfBlock;
+
+
+
+#ifdef __cplusplus
+extern "C"  {  /*}*/
+#endif
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+//-- log2 of number of second-level lists per each first-level one
+#define _TN_TLSF_SL_CNT_LOG2   3
+#define _TN_TLSF_SL_CNT        (1 << _TN_TLSF_SL_CNT_LOG2)
+
+//-- log2 of the allocation granularity: 4 bytes, or 8 bytes on 64-bit systems
+#define _TN_TLSF_ALIGN_LOG2    (sizeof(TN_UWord) > 4 ? 3 : 2)
+
+//-- blocks smaller than (1 << _TN_TLSF_FL_SHIFT) bytes are all kept in the
+//   first-level list 0, which is split linearly
+#define _TN_TLSF_FL_SHIFT      (_TN_TLSF_SL_CNT_LOG2 + _TN_TLSF_ALIGN_LOG2)
+
+//-- number of first-level lists
+#define _TN_TLSF_FL_CNT        (TN_TLSF_FL_INDEX_MAX - _TN_TLSF_FL_SHIFT + 1)
+
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * TLSF heap
+ */
+struct TN_Tlsf {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId           id_tlsf;
+   ///
+   /// lists of tasks waiting for memory: task is put to the list with index
+   /// equal to the first-level index of the requested size
+   struct TN_ListItem      wait_queues[ _TN_TLSF_FL_CNT ];
+   ///
+   /// bitmap of wait queues: bit is set when the task is put to the queue,
+   /// and it is cleared when the queue is found to be empty
+   unsigned int            wait_bitmap;
+#if TN_USE_PRIO_WAIT_QUEUES || defined(DOXYGEN_ACTIVE)
+   ///
+   /// priority indexes of the wait queues: tasks in each queue are ordered
+   /// by priority. Available if only `#TN_USE_PRIO_WAIT_QUEUES` option is
+   /// non-zero.
+   struct TN_ListPrioIdx   wait_queues_prio[ _TN_TLSF_FL_CNT ];
+#endif
+   ///
+   /// start address of the memory area managed by the heap
+   void                   *start_addr;
+   ///
+   /// size of the memory area managed by the heap, in bytes
+   unsigned int            size;
+   ///
+   /// total size of free blocks, in bytes
+   unsigned int            free_size;
+   ///
+   /// bitmap of non-empty first-level lists
+   unsigned int            fl_bitmap;
+   ///
+   /// bitmaps of non-empty second-level lists
+   unsigned char           sl_bitmap[ _TN_TLSF_FL_CNT ];
+   ///
+   /// heads of free lists
+   struct _TN_TlsfBlock   *free_lists[ _TN_TLSF_FL_CNT ][ _TN_TLSF_SL_CNT ];
+};
+
+/**
+ * TLSF-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_TlsfTaskWait {
+   ///
+   /// requested size of the memory block (already adjusted)
+   unsigned int size;
+   ///
+   /// if task waits for memory block, this field will be filled with
+   /// the address of the block when it's allocated
+   void *data_elem;
+};
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct the TLSF heap on the given memory area. `id_tlsf` field should
+ * not contain `#TN_ID_TLSF`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * If `start_addr` isn't aligned properly, the heap uses the memory from the
+ * first aligned address.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param tlsf
+ *    Pointer to already allocated `struct TN_Tlsf`
+ * @param start_addr
+ *    Start address of the memory area
+ * @param size
+ *    Size of the memory area, in bytes. Two words are taken by the
+ *    internal headers; the rest should be less than
+ *    `(2 ^ #TN_TLSF_FL_INDEX_MAX)` bytes.
+ *
+ * @return
+ *    * `#TN_RC_OK` if heap was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_tlsf_create(
+      struct TN_Tlsf         *tlsf,
+      void                   *start_addr,
+      unsigned int            size
+      );
+
+/**
+ * Destruct the TLSF heap.
+ *
+ * All tasks that wait for memory are released from waiting with
+ * `#TN_RC_DELETED` code.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param tlsf
+ *    Pointer to heap to be deleted
+ *
+ * @return
+ *    * `#TN_RC_OK` if heap was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_tlsf_delete(struct TN_Tlsf *tlsf);
+
+/**
+ * Allocate memory block of at least `size` bytes from the heap.
+ *
+ * If there's no free block large enough, behavior depends on `timeout` value
+ * (refer to `#TN_TickCnt`).
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param tlsf
+ *    Pointer to heap
+ * @param size
+ *    Requested size, in bytes
+ * @param p_data
+ *    Address of the `(void *)` to which allocated block address
+ *    will be saved
+ * @param timeout
+ *    Refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if block was successfully allocated;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * `#TN_RC_WPARAM` if `size` is 0 or too large for the heap;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_tlsf_alloc(
+      struct TN_Tlsf         *tlsf,
+      unsigned int            size,
+      void                  **p_data,
+      TN_TickCnt              timeout
+      );
+
+/**
+ * The same as `tn_tlsf_alloc()` with zero timeout
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_tlsf_alloc_polling(
+      struct TN_Tlsf         *tlsf,
+      unsigned int            size,
+      void                  **p_data
+      );
+
+/**
+ * The same as `tn_tlsf_alloc()` with zero timeout, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_tlsf_ialloc_polling(
+      struct TN_Tlsf         *tlsf,
+      unsigned int            size,
+      void                  **p_data
+      );
+
+/**
+ * Release memory block back to the heap. After that, waiting tasks whose
+ * requests fit are woken up, smallest requests first.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param tlsf
+ *    Pointer to heap
+ * @param p_data
+ *    Address of the memory block to release, previously allocated
+ *    from the same heap
+ *
+ * @return
+ *    * `#TN_RC_OK` on success
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` (in particular, if the block doesn't
+ *      belong to the heap or is already free) and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_tlsf_free(struct TN_Tlsf *tlsf, void *p_data);
+
+/**
+ * The same as `tn_tlsf_free()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_tlsf_ifree(struct TN_Tlsf *tlsf, void *p_data);
+
+/**
+ * Returns total size of free blocks in the heap, in bytes. Because of
+ * fragmentation, it's not necessarily possible to allocate a block of that
+ * size.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param tlsf
+ *    Pointer to heap
+ *
+ * @return
+ *    Total size of free blocks, or `-1` if wrong params were given
+ *    (the check is performed if only `#TN_CHECK_PARAM` is non-zero)
+ */
+int tn_tlsf_free_size_get(struct TN_Tlsf *tlsf);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_TLSF_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
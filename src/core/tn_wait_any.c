@@ -0,0 +1,348 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+//-- common tnkernel headers
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_wait_any.h"
+#include "_tn_sem.h"
+#include "_tn_dqueue.h"
+#include "_tn_eventgrp.h"
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+//-- header of current module
+#include "tn_wait_any.h"
+
+//-- header of other needed modules
+#include "tn_tasks.h"
+
+
+#if TN_USE_WAIT_ANY
+
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+
+/**
+ * Check the object referred to by the item
+ */
+_TN_STATIC_INLINE enum TN_RCode _check_param_item(
+      const struct TN_WaitAnyItem *item
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   switch (item->type){
+      case TN_WAIT_ANY_TYPE_SEM:
+         if (item->obj.sem == TN_NULL){
+            rc = TN_RC_WPARAM;
+         } else if (!_tn_sem_is_valid(item->obj.sem)){
+            rc = TN_RC_INVALID_OBJ;
+         }
+         break;
+
+      case TN_WAIT_ANY_TYPE_QUEUE:
+         if (item->obj.dqueue == TN_NULL){
+            rc = TN_RC_WPARAM;
+         } else if (!_tn_dqueue_is_valid(item->obj.dqueue)){
+            rc = TN_RC_INVALID_OBJ;
+         }
+         break;
+
+      case TN_WAIT_ANY_TYPE_EVENTGRP:
+         if (item->obj.eventgrp == TN_NULL){
+            rc = TN_RC_WPARAM;
+         } else if (!_tn_eventgrp_is_valid(item->obj.eventgrp)){
+            rc = TN_RC_INVALID_OBJ;
+         }
+         break;
+
+      default:
+         rc = TN_RC_WPARAM;
+         break;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_wait(
+      const struct TN_WaitAnyItem  *items,
+      int                           items_cnt,
+      const int                    *p_ready_idx
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (items == TN_NULL || items_cnt < 1 || p_ready_idx == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else {
+      int i;
+
+      for (i = 0; i < items_cnt && rc == TN_RC_OK; i++){
+         rc = _check_param_item(&items[i]);
+      }
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_wait(items, items_cnt, p_ready_idx)     (TN_RC_OK)
+#endif
+// }}}
+
+
+/**
+ * Returns the object's list of items of the tasks waiting in `tn_wait_any()`
+ */
+static struct TN_ListItem *_wait_any_list_get(struct TN_WaitAnyItem *item)
+{
+   struct TN_ListItem *wait_any_list = TN_NULL;
+
+   switch (item->type){
+      case TN_WAIT_ANY_TYPE_SEM:
+         wait_any_list = &(item->obj.sem->wait_any_list);
+         break;
+      case TN_WAIT_ANY_TYPE_QUEUE:
+         wait_any_list = &(item->obj.dqueue->wait_any_list);
+         break;
+      case TN_WAIT_ANY_TYPE_EVENTGRP:
+         wait_any_list = &(item->obj.eventgrp->wait_any_list);
+         break;
+   }
+
+   return wait_any_list;
+}
+
+/**
+ * Try to acquire the object referred to by the item, without waiting.
+ *
+ * @return
+ *    * `#TN_RC_OK` if object is acquired (and the result, if any, is stored
+ *      in `item->result`);
+ *    * `#TN_RC_TIMEOUT` if object isn't ready;
+ *    * `#TN_RC_WPARAM` if item parameters are wrong.
+ */
+static enum TN_RCode _item_acquire(struct TN_WaitAnyItem *item)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   enum TN_RCode rc = TN_RC_WPARAM;
+
+   switch (item->type){
+      case TN_WAIT_ANY_TYPE_SEM:
+         rc = _tn_sem_wait_polling(item->obj.sem);
+         break;
+      case TN_WAIT_ANY_TYPE_QUEUE:
+         rc = _tn_queue_receive_polling(
+               item->obj.dqueue, &(item->result.data)
+               );
+         break;
+      case TN_WAIT_ANY_TYPE_EVENTGRP:
+         rc = _tn_eventgrp_wait_polling(
+               item->obj.eventgrp, item->pattern, item->wait_mode,
+               &(item->result.flags_pattern)
+               );
+         break;
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (tn_wait_any.h)
+ */
+enum TN_RCode tn_wait_any(
+      struct TN_WaitAnyItem  *items,
+      int                     items_cnt,
+      int                    *p_ready_idx,
+      TN_TickCnt              timeout
+      )
+{
+   TN_BOOL waited = TN_FALSE;
+   enum TN_RCode rc = _check_param_wait(items, items_cnt, p_ready_idx);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      int ready_idx = 0;
+      int i;
+
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- try to acquire the objects one by one, until some of them is
+      //   acquired (or an error occurs)
+      rc = TN_RC_TIMEOUT;
+      for (i = 0; i < items_cnt && rc == TN_RC_TIMEOUT; i++){
+         rc = _item_acquire(&items[i]);
+         ready_idx = i;
+      }
+
+      if (rc == TN_RC_TIMEOUT && timeout != 0){
+         //-- none of the objects is ready, and user wants to wait in this
+         //   case. So, put the items to the lists of the objects, and
+         //   put current task to wait: the task is not included in any
+         //   object's wait queue.
+         struct TN_WaitAnyTaskWait *wait =
+            &_tn_curr_run_task->subsys_wait.wait_any;
+
+         for (i = 0; i < items_cnt; i++){
+            items[i].task = _tn_curr_run_task;
+            _tn_list_add_tail(
+                  _wait_any_list_get(&items[i]), &(items[i].obj_queue)
+                  );
+         }
+
+         wait->items       = items;
+         wait->items_cnt   = items_cnt;
+         wait->ready_idx   = -1;
+
+         _tn_task_curr_to_wait_action(
+               TN_NULL, TN_WAIT_REASON_WAIT_ANY, timeout
+               );
+         waited = TN_TRUE;
+      }
+
+      _TN_BUG_ON(!_tn_need_context_switch() && waited);
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited){
+         //-- task was waiting, and now it has just woke up.
+         //-- get wait result and index of the item that got ready
+         //   (if any)
+         rc = _tn_curr_run_task->task_wait_rc;
+         ready_idx = _tn_curr_run_task->subsys_wait.wait_any.ready_idx;
+      }
+
+      if (rc == TN_RC_OK || rc == TN_RC_DELETED){
+         *p_ready_idx = ready_idx;
+      }
+   }
+
+   return rc;
+}
+
+
+
+
+/*******************************************************************************
+ *    PROTECTED FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * See comments in the header file (_tn_wait_any.h)
+ */
+void _tn_wait_any_item_complete(
+      struct TN_WaitAnyItem  *item,
+      enum TN_RCode           rc
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   struct TN_Task *task = item->task;
+
+   task->subsys_wait.wait_any.ready_idx =
+      (int)(item - task->subsys_wait.wait_any.items);
+
+   //-- wake the task up: all its items are removed from the lists
+   //   in _tn_wait_any_on_task_wait_complete()
+   _tn_task_wait_complete(task, rc);
+}
+
+/*
+ * See comments in the header file (_tn_wait_any.h)
+ */
+void _tn_wait_any_notify_deleted(struct TN_ListItem *wait_any_list)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   //-- each completion removes the item (and other items of the same task)
+   //   from the list, so, just take the first one until the list is empty
+   while (!_tn_list_is_empty(wait_any_list)){
+      _tn_wait_any_item_complete(
+            _tn_wait_any_first_get(wait_any_list), TN_RC_DELETED
+            );
+   }
+}
+
+/*
+ * See comments in the header file (_tn_wait_any.h)
+ */
+void _tn_wait_any_on_task_wait_complete(struct TN_Task *task)
+{
+   struct TN_WaitAnyTaskWait *wait = &task->subsys_wait.wait_any;
+   int i;
+
+   for (i = 0; i < wait->items_cnt; i++){
+      _tn_list_remove_entry(&(wait->items[i].obj_queue));
+      _tn_list_reset(&(wait->items[i].obj_queue));
+   }
+}
+
+
+
+#endif // TN_USE_WAIT_ANY
+
+
@@ -0,0 +1,350 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Waiting for any of several objects.
+ *
+ * `tn_wait_any()` puts the task to wait for several kernel objects at once,
+ * and the task is woken up as soon as any of them becomes ready. Objects that
+ * can be waited for are:
+ *
+ * - \ref tn_sem.h "semaphore": ready when it can be acquired;
+ * - \ref tn_dqueue.h "data queue": ready when an item can be received;
+ * - \ref tn_eventgrp.h "event group": ready when the wait condition (pattern
+ *   and mode, just like for `tn_eventgrp_wait()`) is met.
+ *
+ * The object is not just reported as ready: it is **acquired** atomically,
+ * exactly like the ordinary wait service does it (semaphore is taken, item is
+ * received from the queue, event group flags are cleared if
+ * `#TN_EVENTGRP_WMODE_AUTOCLR` is given). So, there are no races with other
+ * tasks, and there's no need to call another service afterwards: just check
+ * which item is ready, and handle it. Only one object is acquired per call.
+ *
+ * Each object to wait for is described by `struct #TN_WaitAnyItem`; fill it
+ * with `tn_wait_any_item_sem()`, `tn_wait_any_item_queue()` or
+ * `tn_wait_any_item_eventgrp()`. The array of items should stay valid while
+ * the task is waiting (it is perfectly fine to allocate it on the task's
+ * stack). The same object should not be given more than once.
+ *
+ * Unlike \ref eventgrp_connect "connecting an event group" to the queues, it
+ * doesn't need any extra object, and services of the objects don't maintain
+ * any flags: if nobody waits in `tn_wait_any()`, the only overhead is the
+ * check that the object's list of such tasks is empty.
+ *
+ * When the object becomes ready, tasks waiting for it in the ordinary way
+ * (say, in `tn_sem_wait()`) are served first; tasks waiting in
+ * `tn_wait_any()` are served after them, in the order they started waiting.
+ *
+ * Available if only `#TN_USE_WAIT_ANY` option is non-zero.
+ *
+ * Example:
+ *
+ * \code{.c}
+ * #include "tn.h"
+ *
+ * extern struct TN_DQueue    rx_queue;
+ * extern struct TN_Sem       tx_done_sem;
+ * extern struct TN_EventGrp  ctrl_events;
+ *
+ * #define CTRL_EVENT_STOP    (1 << 0)
+ *
+ * void my_task_body(void *param)
+ * {
+ *    struct TN_WaitAnyItem items[3];
+ *    int ready_idx;
+ *
+ *    tn_wait_any_item_queue(&items[0], &rx_queue);
+ *    tn_wait_any_item_sem(&items[1], &tx_done_sem);
+ *    tn_wait_any_item_eventgrp(
+ *          &items[2], &ctrl_events, CTRL_EVENT_STOP,
+ *          TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AUTOCLR
+ *          );
+ *
+ *    for (;;){
+ *       if (tn_wait_any(items, 3, &ready_idx, TN_WAIT_INFINITE) == TN_RC_OK){
+ *          switch (ready_idx){
+ *             case 0:
+ *                //-- item received from the queue: items[0].data
+ *                break;
+ *             case 1:
+ *                //-- semaphore is acquired
+ *                break;
+ *             case 2:
+ *                //-- stop flag is set (and cleared automatically)
+ *                break;
+ *          }
+ *       }
+ *    }
+ * }
+ * \endcode
+ *
+ */
+
+#ifndef _TN_WAIT_ANY_H
+#define _TN_WAIT_ANY_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_eventgrp.h"
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    EXTERNAL TYPES
+ ******************************************************************************/
+
+struct TN_Task;
+struct TN_Sem;
+struct TN_DQueue;
+
+
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Type of the object to wait for in `tn_wait_any()`.
+ */
+enum TN_WaitAnyType {
+   ///
+   /// Semaphore: wait until it can be acquired
+   TN_WAIT_ANY_TYPE_SEM,
+   ///
+   /// Data queue: wait until an item can be received
+   TN_WAIT_ANY_TYPE_QUEUE,
+   ///
+   /// Event group: wait until the condition is met
+   TN_WAIT_ANY_TYPE_EVENTGRP,
+};
+
+/**
+ * Object to wait for in `tn_wait_any()`. Fill it with
+ * `tn_wait_any_item_sem()`, `tn_wait_any_item_queue()` or
+ * `tn_wait_any_item_eventgrp()`.
+ */
+struct TN_WaitAnyItem {
+   ///
+   /// type of the object
+   enum TN_WaitAnyType     type;
+   ///
+   /// the object to wait for, depending on `type`
+   union {
+      struct TN_Sem       *sem;
+      struct TN_DQueue    *dqueue;
+      struct TN_EventGrp  *eventgrp;
+   } obj;
+   ///
+   /// for event group: wait pattern
+   TN_UWord                pattern;
+   ///
+   /// for event group: wait mode, see `enum #TN_EGrpWaitMode`
+   enum TN_EGrpWaitMode    wait_mode;
+   ///
+   /// result, valid if only this item got ready:
+   union {
+      ///
+      /// for data queue: received item
+      void                *data;
+      ///
+      /// for event group: pattern that caused the task to finish waiting
+      TN_UWord             flags_pattern;
+   } result;
+
+   ///
+   /// for internal kernel usage: links the item into the object's list of
+   /// tasks waiting in `tn_wait_any()`
+   struct TN_ListItem      obj_queue;
+   ///
+   /// for internal kernel usage: task that waits for the item
+   struct TN_Task         *task;
+};
+
+/**
+ * `tn_wait_any()`-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_WaitAnyTaskWait {
+   ///
+   /// array of items given to `tn_wait_any()`
+   struct TN_WaitAnyItem  *items;
+   ///
+   /// number of items in `items`
+   int                     items_cnt;
+   ///
+   /// index of the item which got ready
+   int                     ready_idx;
+};
+
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Fill the item so that it refers to the semaphore.
+ *
+ * @param item
+ *    Item to fill
+ * @param sem
+ *    Semaphore to wait for
+ */
+_TN_STATIC_INLINE void tn_wait_any_item_sem(
+      struct TN_WaitAnyItem  *item,
+      struct TN_Sem          *sem
+      )
+{
+   item->type     = TN_WAIT_ANY_TYPE_SEM;
+   item->obj.sem  = sem;
+}
+
+/**
+ * Fill the item so that it refers to the data queue. When the item gets
+ * ready, received data is stored in `item->result.data`.
+ *
+ * @param item
+ *    Item to fill
+ * @param dqueue
+ *    Data queue to receive data from
+ */
+_TN_STATIC_INLINE void tn_wait_any_item_queue(
+      struct TN_WaitAnyItem  *item,
+      struct TN_DQueue       *dqueue
+      )
+{
+   item->type        = TN_WAIT_ANY_TYPE_QUEUE;
+   item->obj.dqueue  = dqueue;
+}
+
+/**
+ * Fill the item so that it refers to the event group. When the item gets
+ * ready, actual pattern of the event group is stored in
+ * `item->result.flags_pattern`.
+ *
+ * @param item
+ *    Item to fill
+ * @param eventgrp
+ *    Event group to wait events from
+ * @param pattern
+ *    Events bit pattern for which task should wait
+ * @param wait_mode
+ *    Wait mode, see `enum #TN_EGrpWaitMode`
+ */
+_TN_STATIC_INLINE void tn_wait_any_item_eventgrp(
+      struct TN_WaitAnyItem  *item,
+      struct TN_EventGrp     *eventgrp,
+      TN_UWord                pattern,
+      enum TN_EGrpWaitMode    wait_mode
+      )
+{
+   item->type           = TN_WAIT_ANY_TYPE_EVENTGRP;
+   item->obj.eventgrp   = eventgrp;
+   item->pattern        = pattern;
+   item->wait_mode      = wait_mode;
+}
+
+/**
+ * Wait for any of the given objects to get ready, and acquire it. If some of
+ * the objects is already ready, the first of them is acquired, and the
+ * function returns `#TN_RC_OK` immediately. Otherwise, behavior depends on
+ * `timeout` value: refer to `#TN_TickCnt`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param items
+ *    Array of objects to wait for, see `struct #TN_WaitAnyItem`.
+ * @param items_cnt
+ *    Number of items in the array, at least 1.
+ * @param p_ready_idx
+ *    Pointer to the variable in which the index of the item which got ready
+ *    will be stored (if `#TN_RC_OK` or `#TN_RC_DELETED` is returned).
+ * @param timeout
+ *    refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if the object `items[*p_ready_idx]` got ready and it is
+ *      acquired;
+ *    * `#TN_RC_DELETED` if the object `items[*p_ready_idx]` was deleted
+ *      while the task was waiting;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_wait_any(
+      struct TN_WaitAnyItem  *items,
+      int                     items_cnt,
+      int                    *p_ready_idx,
+      TN_TickCnt              timeout
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_WAIT_ANY_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
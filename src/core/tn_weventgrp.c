@@ -0,0 +1,753 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+//-- common tnkernel headers
+#include "tn_common.h"
+#include "tn_sys.h"
+
+//-- internal tnkernel headers
+#include "_tn_weventgrp.h"
+#include "_tn_tasks.h"
+#include "_tn_list.h"
+
+
+//-- header of current module
+#include "tn_weventgrp.h"
+
+//-- header of other needed modules
+#include "tn_tasks.h"
+
+
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+//-- Additional param checking {{{
+#if TN_CHECK_PARAM
+_TN_STATIC_INLINE enum TN_RCode _check_param_generic(
+      const struct TN_WEventGrp *wegrp
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (wegrp == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else if (!_tn_weventgrp_is_valid(wegrp)){
+      rc = TN_RC_INVALID_OBJ;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_job_perform(
+      const struct TN_WEventGrp *wegrp,
+      enum TN_EGrpWaitMode       wait_mode,
+      const TN_UWord            *pattern
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (pattern == TN_NULL){
+      rc = TN_RC_WPARAM;
+   } else {
+      TN_UWord any = 0;
+      int i;
+
+      for (i = 0; i < wegrp->words_cnt; i++){
+         any |= pattern[i];
+      }
+
+      wait_mode &= (TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AND);
+
+      if (any == 0){
+         rc = TN_RC_WPARAM;
+      } else if (  wait_mode != TN_EVENTGRP_WMODE_OR
+                && wait_mode != TN_EVENTGRP_WMODE_AND)
+      {
+         rc = TN_RC_WPARAM;
+      }
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_modify(
+      const struct TN_WEventGrp *wegrp,
+      const TN_UWord            *pattern
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (pattern == TN_NULL){
+      rc = TN_RC_WPARAM;
+   }
+
+   _TN_UNUSED(wegrp);
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_flag_modify(
+      const struct TN_WEventGrp *wegrp,
+      int                        flag
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (flag < 0 || flag >= wegrp->words_cnt * TN_INT_WIDTH){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+_TN_STATIC_INLINE enum TN_RCode _check_param_create(
+      const struct TN_WEventGrp *wegrp,
+      TN_UWord                  *pattern,
+      int                        words_cnt
+      )
+{
+   enum TN_RCode rc = TN_RC_OK;
+
+   if (wegrp == TN_NULL || _tn_weventgrp_is_valid(wegrp)){
+      rc = TN_RC_WPARAM;
+   } else if (pattern == TN_NULL || words_cnt < 1){
+      rc = TN_RC_WPARAM;
+   }
+
+   return rc;
+}
+
+#else
+#  define _check_param_generic(wegrp)                          (TN_RC_OK)
+#  define _check_param_job_perform(wegrp, wait_mode, pattern)  (TN_RC_OK)
+#  define _check_param_modify(wegrp, pattern)                  (TN_RC_OK)
+#  define _check_param_flag_modify(wegrp, flag)                (TN_RC_OK)
+#  define _check_param_create(wegrp, pattern, words_cnt)       (TN_RC_OK)
+#endif
+// }}}
+
+
+/**
+ * Check if condition is satisfied: check events pattern against given wait
+ * pattern.
+ *
+ * @param wegrp
+ *    Event group to check for condition
+ * @param wait_mode
+ *    Waiting mode: all specified flags or just any of them; see `enum
+ *    #TN_EGrpWaitMode`
+ * @param wait_pattern
+ *    Pattern to check against
+ */
+static TN_BOOL _cond_check(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpWaitMode wait_mode,
+      const TN_UWord      *wait_pattern
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   TN_BOOL cond = TN_FALSE;
+   int i;
+
+   switch (wait_mode & (TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AND)){
+      case TN_EVENTGRP_WMODE_OR:
+         //-- any bit set is enough for release condition
+         for (i = 0; i < wegrp->words_cnt && !cond; i++){
+            cond = ((wegrp->pattern[i] & wait_pattern[i]) != 0);
+         }
+         break;
+      case TN_EVENTGRP_WMODE_AND:
+         //-- all bits should be set for release condition
+         cond = TN_TRUE;
+         for (i = 0; i < wegrp->words_cnt && cond; i++){
+            cond = ((wegrp->pattern[i] & wait_pattern[i]) == wait_pattern[i]);
+         }
+         break;
+#if TN_DEBUG
+      default:
+         _TN_FATAL_ERROR("invalid wait_mode");
+         break;
+#endif
+   }
+
+   return cond;
+}
+
+/**
+ * Successful end of waiting: store current pattern to `p_flags_pattern` (if
+ * it isn't `TN_NULL`), and clear waited flags if `#TN_EVENTGRP_WMODE_AUTOCLR`
+ * is specified.
+ *
+ * @param wegrp
+ *    Event group object
+ * @param wait_mode
+ *    Wait mode, see `enum #TN_EGrpWaitMode`
+ * @param wait_pattern
+ *    Pattern that was waited for
+ * @param p_flags_pattern
+ *    Where to store current pattern, may be `TN_NULL`
+ */
+static void _wait_success(
+      struct TN_WEventGrp    *wegrp,
+      enum TN_EGrpWaitMode    wait_mode,
+      const TN_UWord         *wait_pattern,
+      TN_UWord               *p_flags_pattern
+      )
+{
+   int i;
+
+   for (i = 0; i < wegrp->words_cnt; i++){
+      if (p_flags_pattern != TN_NULL){
+         p_flags_pattern[i] = wegrp->pattern[i];
+      }
+
+      if (wait_mode & TN_EVENTGRP_WMODE_AUTOCLR){
+         wegrp->pattern[i] &= ~wait_pattern[i];
+      }
+   }
+}
+
+/**
+ * Walk through all tasks waiting for some event, wake up tasks whose waiting
+ * condition is already satisfied.
+ *
+ * @param wegrp
+ *    Event group to handle.
+ */
+static void _scan_event_waitqueue(struct TN_WEventGrp *wegrp)
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   struct TN_Task *task;
+   struct TN_Task *tmp_task;
+
+   //-- Walk through all tasks waiting for some event, checking
+   //   if each particular condition is satisfied
+   _tn_list_for_each_entry_safe(
+         task, struct TN_Task, tmp_task, &(wegrp->wait_queue), task_queue
+         )
+   {
+      struct TN_WEGrpTaskWait *wait = &task->subsys_wait.weventgrp;
+
+      if (_cond_check(wegrp, wait->wait_mode, wait->wait_pattern)){
+         //-- Condition is satisfied: give the actual pattern to the task,
+         //   clear flag(s) if we need to, and wake the task up.
+         //   (the waiting task's arrays are valid until it wakes up)
+         _wait_success(
+               wegrp, wait->wait_mode, wait->wait_pattern,
+               wait->p_flags_pattern
+               );
+         _tn_task_wait_complete(task, TN_RC_OK);
+      }
+   }
+}
+
+/**
+ * Modify a single word of the pattern.
+ *
+ * @return
+ *    Flags of the word that were just set (they were 0, and now they're 1).
+ */
+static TN_UWord _word_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      int                  idx,
+      TN_UWord             pattern
+      )
+{
+   TN_UWord set_pattern = 0;
+
+   switch (operation){
+      case TN_EVENTGRP_OP_CLEAR:
+         wegrp->pattern[idx] &= ~pattern;
+         break;
+
+      case TN_EVENTGRP_OP_SET:
+         set_pattern = pattern & ~wegrp->pattern[idx];
+         wegrp->pattern[idx] |= pattern;
+         break;
+
+      case TN_EVENTGRP_OP_TOGGLE:
+         wegrp->pattern[idx] ^= pattern;
+         set_pattern = pattern & wegrp->pattern[idx];
+         break;
+   }
+
+   return set_pattern;
+}
+
+/**
+ * Actual worker function that is eventually called when user calls
+ * `tn_weventgrp_wait()` and friends. It never sleeps; if condition isn't met,
+ * then `#TN_RC_TIMEOUT` is returned, and the caller may sleep then (it
+ * depends).
+ *
+ * If condition is met, `#TN_RC_OK` is returned, and the caller will not sleep.
+ *
+ * For params documentation, refer to the `tn_weventgrp_wait()`.
+ */
+static enum TN_RCode _weventgrp_wait(
+      struct TN_WEventGrp *wegrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   enum TN_RCode rc = _check_param_job_perform(
+         wegrp, wait_mode, wait_pattern
+         );
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (_cond_check(wegrp, wait_mode, wait_pattern)){
+      //-- condition is met, so, return `#TN_RC_OK`, and we don't need to
+      //   wait.
+      _wait_success(wegrp, wait_mode, wait_pattern, p_flags_pattern);
+   } else {
+      //-- The condition isn't met, so, return appropriate code,
+      //   and the caller may sleep if it is needed.
+      rc = TN_RC_TIMEOUT;
+   }
+
+   return rc;
+}
+
+/**
+ * Actual worker function that is eventually called when user calls
+ * `tn_weventgrp_modify()` or `tn_weventgrp_imodify()`.
+ *
+ * Modify current events pattern: set, clear or toggle flags. If some flags
+ * got set, then all the tasks waiting for some particular event are checked
+ * whether the condition is met now.
+ *
+ * For params documentation, refer to `tn_weventgrp_modify()`.
+ */
+static enum TN_RCode _weventgrp_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   enum TN_RCode rc = _check_param_modify(wegrp, pattern);
+
+   if (rc == TN_RC_OK){
+      TN_UWord set_pattern = 0;
+      int i;
+
+      for (i = 0; i < wegrp->words_cnt; i++){
+         set_pattern |= _word_modify(wegrp, operation, i, pattern[i]);
+      }
+
+      if (set_pattern != 0){
+         _scan_event_waitqueue(wegrp);
+      }
+   }
+
+   return rc;
+}
+
+/**
+ * Actual worker function that is eventually called when user calls
+ * `tn_weventgrp_flag_modify()` or `tn_weventgrp_iflag_modify()`.
+ *
+ * For params documentation, refer to `tn_weventgrp_flag_modify()`.
+ */
+static enum TN_RCode _weventgrp_flag_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      int                  flag
+      )
+{
+   //-- interrupts should be disabled here
+   _TN_BUG_ON( !TN_IS_INT_DISABLED() );
+
+   enum TN_RCode rc = _check_param_flag_modify(wegrp, flag);
+
+   if (rc == TN_RC_OK){
+      if (_word_modify(
+               wegrp, operation,
+               TN_WEVENTGRP_FLAG_WORD(flag), TN_WEVENTGRP_FLAG_MASK(flag)
+               ) != 0)
+      {
+         _scan_event_waitqueue(wegrp);
+      }
+   }
+
+   return rc;
+}
+
+
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_create(
+      struct TN_WEventGrp *wegrp,
+      TN_UWord            *pattern,
+      int                  words_cnt,
+      const TN_UWord      *initial_pattern
+      )  
+{
+   enum TN_RCode rc = _check_param_create(wegrp, pattern, words_cnt);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else {
+      int i;
+
+      for (i = 0; i < words_cnt; i++){
+         pattern[i] = (initial_pattern != TN_NULL) ? initial_pattern[i] : 0;
+      }
+
+      _tn_list_reset(&(wegrp->wait_queue));
+
+      wegrp->pattern    = pattern;
+      wegrp->words_cnt  = words_cnt;
+      wegrp->id_wevent  = TN_ID_WEVENTGRP;
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_delete(struct TN_WEventGrp *wegrp)
+{
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      // remove all waiting tasks from wait list (if any), returning the
+      // TN_RC_DELETED code.
+      _tn_wait_queue_notify_deleted(&(wegrp->wait_queue));
+
+      wegrp->id_wevent = TN_ID_NONE; //-- event group does not exist now
+
+      TN_INT_RESTORE();
+
+      //-- we might need to switch context if _tn_wait_queue_notify_deleted()
+      //   has woken up some high-priority task
+      _tn_context_switch_pend_if_needed();
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_wait(
+      struct TN_WEventGrp *wegrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern,
+      TN_TickCnt           timeout
+      )
+{
+   TN_BOOL waited_for_event = TN_FALSE;
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- call worker function that actually performs needed check
+      //   and return result
+      rc = _weventgrp_wait(wegrp, wait_pattern, wait_mode, p_flags_pattern);
+
+      if (rc == TN_RC_TIMEOUT && timeout != 0){
+         //-- condition isn't met, and user wants to wait in this case.
+         //   So, remember waiting parameters, and put current task to wait.
+         //   The task that wakes us up will store the actual pattern
+         //   to `p_flags_pattern` by itself.
+         struct TN_WEGrpTaskWait *wait =
+            &_tn_curr_run_task->subsys_wait.weventgrp;
+
+         wait->wait_mode         = wait_mode;
+         wait->wait_pattern      = wait_pattern;
+         wait->p_flags_pattern   = p_flags_pattern;
+
+         _tn_task_curr_to_wait_action(
+               &(wegrp->wait_queue),
+               TN_WAIT_REASON_WEVENT,
+               timeout
+               );
+         waited_for_event = TN_TRUE;
+      }
+
+      _TN_BUG_ON(!_tn_need_context_switch() && waited_for_event);
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+      if (waited_for_event){
+         //-- task was waiting for event, and now it has just woke up.
+         //-- get wait result
+         rc = _tn_curr_run_task->task_wait_rc;
+      }
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_wait_polling(
+      struct TN_WEventGrp *wegrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      )
+{
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- call worker function that actually performs needed check
+      //   and return result
+      rc = _weventgrp_wait(wegrp, wait_pattern, wait_mode, p_flags_pattern);
+
+      TN_INT_RESTORE();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_iwait_polling(
+      struct TN_WEventGrp *wegrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      )
+{
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      //-- call worker function that actually performs needed check
+      //   and return result
+      rc = _weventgrp_wait(wegrp, wait_pattern, wait_mode, p_flags_pattern);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      )
+{
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- call worker function that actually modifies the events pattern
+      rc = _weventgrp_modify(wegrp, operation, pattern);
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_imodify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      )
+{
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      //-- call worker function that actually modifies the events pattern
+      rc = _weventgrp_modify(wegrp, operation, pattern);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_flag_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      int                  flag
+      )
+{
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_task_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA;
+
+      TN_INT_DIS_SAVE();
+
+      //-- call worker function that actually modifies the events pattern
+      rc = _weventgrp_flag_modify(wegrp, operation, flag);
+
+      TN_INT_RESTORE();
+      _tn_context_switch_pend_if_needed();
+
+   }
+   return rc;
+}
+
+
+/*
+ * See comments in the header file (tn_weventgrp.h)
+ */
+enum TN_RCode tn_weventgrp_iflag_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      int                  flag
+      )
+{
+   enum TN_RCode rc = _check_param_generic(wegrp);
+
+   if (rc != TN_RC_OK){
+      //-- just return rc as it is
+   } else if (!tn_is_isr_context()){
+      rc = TN_RC_WCONTEXT;
+   } else {
+      TN_INTSAVE_DATA_INT;
+
+      TN_INT_IDIS_SAVE();
+
+      //-- call worker function that actually modifies the events pattern
+      rc = _weventgrp_flag_modify(wegrp, operation, flag);
+
+      TN_INT_IRESTORE();
+      _TN_CONTEXT_SWITCH_IPEND_IF_NEEDED();
+   }
+   return rc;
+}
+
+
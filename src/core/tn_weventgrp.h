@@ -0,0 +1,436 @@
+/*******************************************************************************
+ *
+ * TNeo: real-time kernel initially based on TNKernel
+ *
+ *    TNKernel:                  copyright 2004, 2013 Yuri Tiomkin.
+ *    PIC32-specific routines:   copyright 2013, 2014 Anders Montonen.
+ *    TNeo:                      copyright 2014       Dmitry Frank.
+ *
+ *    TNeo was born as a thorough review and re-implementation of
+ *    TNKernel. The new kernel has well-formed code, inherited bugs are fixed
+ *    as well as new features being added, and it is tested carefully with
+ *    unit-tests.
+ *
+ *    API is changed somewhat, so it's not 100% compatible with TNKernel,
+ *    hence the new name: TNeo.
+ *
+ *    Permission to use, copy, modify, and distribute this software in source
+ *    and binary forms and its documentation for any purpose and without fee
+ *    is hereby granted, provided that the above copyright notice appear
+ *    in all copies and that both that copyright notice and this permission
+ *    notice appear in supporting documentation.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE DMITRY FRANK AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DMITRY FRANK OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+/**
+ * \file
+ *
+ * Wide event group.
+ *
+ * Wide event group is the same as \ref tn_eventgrp.h "event group", but its
+ * pattern consists of any number of words, not of a single `#TN_UWord`. It is
+ * useful when the application needs more flags than there are bits in the
+ * word (on 16-bit PIC24/dsPIC, there are only 16 of them): instead of
+ * chaining several event groups (and having extra tasks which wait for one
+ * group and set flags in another one), all the flags can be kept in a single
+ * wide event group, and a single wait may cover any of them.
+ *
+ * The pattern of wide event group is an array of `#TN_UWord`, which is
+ * provided by the application, as well as the number of its words: see
+ * `tn_weventgrp_create()`. Flag `N` is the bit `(N % #TN_INT_WIDTH)` of the
+ * word `(N / #TN_INT_WIDTH)`; use `TN_WEVENTGRP_FLAG_WORD()` and
+ * `TN_WEVENTGRP_FLAG_MASK()` to address it. Patterns given to
+ * `tn_weventgrp_wait()` and `tn_weventgrp_modify()` should consist of the same
+ * number of words.
+ *
+ * Wait modes (`enum #TN_EGrpWaitMode`) and modify operations (`enum
+ * #TN_EGrpOp`) are the same as for the ordinary event group, including
+ * `#TN_EVENTGRP_WMODE_AUTOCLR`. The pattern is modified word by word with
+ * interrupts disabled, so, for waiting tasks, the whole wide pattern is
+ * modified atomically.
+ *
+ * Wide event group can't be connected to other kernel objects (see \ref
+ * eventgrp_connect), use ordinary event group for that.
+ *
+ * Example:
+ *
+ * \code{.c}
+ * #include "tn.h"
+ *
+ * #define FLAGS_CNT    64
+ *
+ * //-- pattern of the wide event group
+ * TN_WEVENTGRP_BUF_DEF(my_egrp_buf, FLAGS_CNT);
+ *
+ * struct TN_WEventGrp my_egrp;
+ *
+ * void my_init(void)
+ * {
+ *    tn_weventgrp_create(
+ *          &my_egrp, my_egrp_buf, TN_WEVENTGRP_WORDS_CNT(FLAGS_CNT), TN_NULL
+ *          );
+ * }
+ *
+ * void my_task_body(void *param)
+ * {
+ *    TN_UWord wait_pattern[ TN_WEVENTGRP_WORDS_CNT(FLAGS_CNT) ] = {0};
+ *    TN_UWord flags[ TN_WEVENTGRP_WORDS_CNT(FLAGS_CNT) ];
+ *
+ *    //-- wait for flags 3 and 40
+ *    wait_pattern[ TN_WEVENTGRP_FLAG_WORD(3) ]  |= TN_WEVENTGRP_FLAG_MASK(3);
+ *    wait_pattern[ TN_WEVENTGRP_FLAG_WORD(40) ] |= TN_WEVENTGRP_FLAG_MASK(40);
+ *
+ *    for (;;){
+ *       enum TN_RCode rc = tn_weventgrp_wait(
+ *             &my_egrp, wait_pattern,
+ *             TN_EVENTGRP_WMODE_OR | TN_EVENTGRP_WMODE_AUTOCLR,
+ *             flags, TN_WAIT_INFINITE
+ *             );
+ *
+ *       if (rc == TN_RC_OK){
+ *          //-- check which flags are set in `flags`, and handle them
+ *       }
+ *    }
+ * }
+ * \endcode
+ *
+ */
+
+#ifndef _TN_WEVENTGRP_H
+#define _TN_WEVENTGRP_H
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "tn_list.h"
+#include "tn_common.h"
+#include "tn_eventgrp.h"
+
+
+
+#ifdef __cplusplus
+extern "C"  {     /*}*/
+#endif
+
+/*******************************************************************************
+ *    PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Wide event group
+ */
+struct TN_WEventGrp {
+   ///
+   /// id for object validity verification.
+   /// This field is in the beginning of the structure to make it easier
+   /// to detect memory corruption.
+   enum TN_ObjId        id_wevent;
+   ///
+   /// list of tasks waiting for events
+   struct TN_ListItem   wait_queue;
+   ///
+   /// current flags pattern: array of `words_cnt` words, provided by the
+   /// application
+   TN_UWord            *pattern;
+   ///
+   /// number of words in the pattern
+   int                  words_cnt;
+};
+
+/**
+ * WEventGrp-specific fields related to waiting task,
+ * to be included in struct TN_Task.
+ */
+struct TN_WEGrpTaskWait {
+   ///
+   /// event wait pattern: points to the array given to `tn_weventgrp_wait()`
+   const TN_UWord      *wait_pattern;
+   ///
+   /// where to store pattern that caused task to finish waiting: points to
+   /// the array given to `tn_weventgrp_wait()`, may be `TN_NULL`
+   TN_UWord            *p_flags_pattern;
+   ///
+   /// event wait mode: `AND` or `OR`
+   enum TN_EGrpWaitMode wait_mode;
+};
+
+
+/*******************************************************************************
+ *    PROTECTED GLOBAL DATA
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+/**
+ * Number of words needed for the pattern of `flags_cnt` flags.
+ */
+#define TN_WEVENTGRP_WORDS_CNT(flags_cnt)                         \
+   (((flags_cnt) + TN_INT_WIDTH - 1) / TN_INT_WIDTH)
+
+/**
+ * Index of the pattern word which contains the given flag.
+ */
+#define TN_WEVENTGRP_FLAG_WORD(flag)                              \
+   ((flag) / TN_INT_WIDTH)
+
+/**
+ * Mask of the given flag within its pattern word, see
+ * `TN_WEVENTGRP_FLAG_WORD()`.
+ */
+#define TN_WEVENTGRP_FLAG_MASK(flag)                              \
+   ((TN_UWord)1 << ((flag) % TN_INT_WIDTH))
+
+/**
+ * Convenience macro for the definition of pattern buffer for wide event
+ * group. See `tn_weventgrp_create()`.
+ *
+ * @param name
+ *    C variable name of the buffer array (this name should be given 
+ *    to the `tn_weventgrp_create()` function as the `pattern` argument)
+ * @param flags_cnt
+ *    Number of flags in the event group.
+ */
+#define TN_WEVENTGRP_BUF_DEF(name, flags_cnt)                     \
+   TN_UWord name[ TN_WEVENTGRP_WORDS_CNT(flags_cnt) ]
+
+
+
+/*******************************************************************************
+ *    PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/**
+ * Construct wide event group. `id_wevent` field should not contain
+ * `#TN_ID_WEVENTGRP`, otherwise, `#TN_RC_WPARAM` is returned.
+ *
+ * For the definition of pattern buffer, convenience macro
+ * `TN_WEVENTGRP_BUF_DEF()` was invented.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wegrp
+ *    Pointer to already allocated struct TN_WEventGrp
+ * @param pattern
+ *    Array of `words_cnt` words for the flags pattern; it is used by the
+ *    event group until it is deleted.
+ * @param words_cnt
+ *    Number of words in the pattern, at least 1.
+ * @param initial_pattern
+ *    Initial events pattern (array of `words_cnt` words), or `TN_NULL` if
+ *    all the flags should be cleared initially.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if event group was successfully created;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return code
+ *      is available: `#TN_RC_WPARAM`.
+ */
+enum TN_RCode tn_weventgrp_create(
+      struct TN_WEventGrp *wegrp,
+      TN_UWord            *pattern,
+      int                  words_cnt,
+      const TN_UWord      *initial_pattern
+      );
+
+/**
+ * Destruct wide event group.
+ * 
+ * All tasks that wait for the event(s) become runnable with `#TN_RC_DELETED`
+ * code returned.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wegrp   Pointer to event group to be deleted.
+ *
+ * @return 
+ *    * `#TN_RC_OK` if event group was successfully deleted;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_weventgrp_delete(struct TN_WEventGrp *wegrp);
+
+/**
+ * Wait for specified event(s) in the wide event group. If the specified
+ * event is already active, function returns `#TN_RC_OK` immediately.
+ * Otherwise, behavior depends on `timeout` value: refer to `#TN_TickCnt`.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_CAN_SLEEP)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wegrp
+ *    Pointer to event group to wait events from
+ * @param wait_pattern
+ *    Events bit pattern for which task should wait: array of `words_cnt`
+ *    words (see `tn_weventgrp_create()`), at least one flag should be set.
+ * @param wait_mode
+ *    Specifies whether task should wait for **all** the event bits from
+ *    `wait_pattern` to be set, or for just **any** of them 
+ *    (see enum `#TN_EGrpWaitMode`)
+ * @param p_flags_pattern
+ *    Pointer to the array of `words_cnt` words in which actual event pattern
+ *    that caused task to stop waiting will be stored.
+ *    May be `TN_NULL`.
+ * @param timeout
+ *    refer to `#TN_TickCnt`
+ *
+ * @return
+ *    * `#TN_RC_OK` if specified event is active (so the task can check 
+ *      array pointed to by `p_flags_pattern` if it wasn't `TN_NULL`).
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * Other possible return codes depend on `timeout` value,
+ *      refer to `#TN_TickCnt`
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_weventgrp_wait(
+      struct TN_WEventGrp *wegrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern,
+      TN_TickCnt           timeout
+      );
+
+/**
+ * The same as `tn_weventgrp_wait()` with zero timeout.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_weventgrp_wait_polling(
+      struct TN_WEventGrp *wegrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      );
+
+/**
+ * The same as `tn_weventgrp_wait()` with zero timeout, but for using in the
+ * ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_weventgrp_iwait_polling(
+      struct TN_WEventGrp *wegrp,
+      const TN_UWord      *wait_pattern,
+      enum TN_EGrpWaitMode wait_mode,
+      TN_UWord            *p_flags_pattern
+      );
+
+/**
+ * Modify current events bit pattern in the wide event group. Behavior
+ * depends on the given `operation`: refer to `enum #TN_EGrpOp`
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wegrp
+ *    Pointer to event group to modify events in
+ * @param operation
+ *    Actual operation to perform: set, clear or toggle.
+ *    Refer to `enum #TN_EGrpOp`
+ * @param pattern
+ *    Events pattern to be applied (depending on `operation` value): array of
+ *    `words_cnt` words (see `tn_weventgrp_create()`)
+ *
+ * @return
+ *    * `#TN_RC_OK` on success;
+ *    * `#TN_RC_WCONTEXT` if called from wrong context;
+ *    * If `#TN_CHECK_PARAM` is non-zero, additional return codes
+ *      are available: `#TN_RC_WPARAM` and `#TN_RC_INVALID_OBJ`.
+ */
+enum TN_RCode tn_weventgrp_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      );
+
+/**
+ * The same as `tn_weventgrp_modify()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_weventgrp_imodify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      const TN_UWord      *pattern
+      );
+
+/**
+ * Modify a single flag in the wide event group: convenience wrapper for
+ * `tn_weventgrp_modify()`, so that the caller doesn't have to build the
+ * whole wide pattern.
+ *
+ * $(TN_CALL_FROM_TASK)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ *
+ * @param wegrp
+ *    Pointer to event group to modify events in
+ * @param operation
+ *    Actual operation to perform: set, clear or toggle.
+ *    Refer to `enum #TN_EGrpOp`
+ * @param flag
+ *    Number of the flag, from 0 to `(words_cnt * #TN_INT_WIDTH - 1)`.
+ *
+ * @return
+ *    The same as for `tn_weventgrp_modify()`; if `#TN_CHECK_PARAM` is
+ *    non-zero, `#TN_RC_WPARAM` is also returned if `flag` is out of range.
+ */
+enum TN_RCode tn_weventgrp_flag_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      int                  flag
+      );
+
+/**
+ * The same as `tn_weventgrp_flag_modify()`, but for using in the ISR.
+ *
+ * $(TN_CALL_FROM_ISR)
+ * $(TN_CAN_SWITCH_CONTEXT)
+ * $(TN_LEGEND_LINK)
+ */
+enum TN_RCode tn_weventgrp_iflag_modify(
+      struct TN_WEventGrp *wegrp,
+      enum TN_EGrpOp       operation,
+      int                  flag
+      );
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // _TN_WEVENTGRP_H
+
+/*******************************************************************************
+ *    end of file
+ ******************************************************************************/
+
+
@@ -52,11 +52,24 @@
 #include "core/tn_common.h"
 #include "core/tn_dqueue.h"
 #include "core/tn_eventgrp.h"
+#include "core/tn_exch.h"
+#include "core/tn_exch_link_callback.h"
+#include "core/tn_exch_link_event.h"
+#include "core/tn_exch_link_queue.h"
 #include "core/tn_fmem.h"
+#include "core/tn_heap.h"
+#include "core/tn_msgq.h"
 #include "core/tn_mutex.h"
+#include "core/tn_ring.h"
+#include "core/tn_rwlock.h"
 #include "core/tn_sem.h"
+#include "core/tn_seqlock.h"
+#include "core/tn_stream.h"
 #include "core/tn_tasks.h"
 #include "core/tn_timer.h"
+#include "core/tn_tlsf.h"
+#include "core/tn_wait_any.h"
+#include "core/tn_weventgrp.h"
 
 
 //-- include old symbols for compatibility with old projects
@@ -112,8 +112,15 @@
  * Number of priorities that can be used by application, plus one for idle task
  * (which has the lowest priority). This value can't be higher than
  * architecture-dependent value `#TN_PRIORITIES_MAX_CNT`, which typically
- * equals to width of `int` type. So, for 32-bit systems, max number of
- * priorities is 32.
+ * equals to square of width of `int` type. So, for 32-bit systems, max number
+ * of priorities is 1024, and for 16-bit systems it is 256.
+ *
+ * If the value doesn't exceed `#TN_INT_WIDTH`, the bitmap of priorities with
+ * runnable tasks takes a single word. Otherwise, two-level bitmap is used:
+ * a summary word, each bit of which indicates that the appropriate group
+ * of `#TN_INT_WIDTH` priorities has runnable tasks, and a word per group.
+ * Either way, selecting the next task to run takes constant time, but
+ * two-level bitmap takes a bit more time to update.
  *
  * But usually, application needs much less: I can imagine **at most** 4-5
  * different priorities, plus one for the idle task.
@@ -124,10 +131,10 @@
  * 320 bytes. If you set it, say, to 5, you save `270` bytes, which might be
  * notable.
  *
- * Default: `#TN_PRIORITIES_MAX_CNT`.
+ * Default: `#TN_INT_WIDTH`.
  */
 #ifndef TN_PRIORITIES_CNT
-#  define TN_PRIORITIES_CNT      TN_PRIORITIES_MAX_CNT
+#  define TN_PRIORITIES_CNT      TN_INT_WIDTH
 #endif
 
 /**
@@ -192,17 +199,39 @@
 #  define TN_MUTEX_DEADLOCK_DETECT  1
 #endif
 
+/**
+ * Whether reader-writer locks should be available, see \ref tn_rwlock.h.
+ * Requires `#TN_USE_MUTEXES` to be non-zero, since priority inheritance
+ * machinery is shared with mutexes.
+ */
+#ifndef TN_USE_RWLOCKS
+#  define TN_USE_RWLOCKS         1
+#endif
+
+/**
+ * <i>Takes effect if only `#TN_USE_RWLOCKS` is set</i>.
+ *
+ * Max number of \ref tn_rwlock.h "reader-writer locks" that can be held by
+ * the same task at a time (either for reading or for writing). Each task
+ * contains this number of hold records, each of them takes four words of
+ * RAM.
+ */
+#ifndef TN_RWLOCK_HOLDS_MAX
+#  define TN_RWLOCK_HOLDS_MAX    2
+#endif
+
 /**
  *
  * <i>Takes effect if only `#TN_DYNAMIC_TICK` is <B>not set</B></i>.
  *
- * Number of "tick" lists of timers, must be a power or two; minimum value:
- * `2`; typical values: `4`, `8` or `16`.
+ * Number of "tick" lists of timers per each level (see
+ * `#TN_TICK_LISTS_LEVELS`), must be a power or two; minimum value: `2`;
+ * typical values: `4`, `8` or `16`.
  *
  * Refer to the \ref timers_static_implementation for details.
  *
- * Shortly: this value represents number of elements in the array of 
- * `struct TN_ListItem`, on 32-bit system each element takes 8 bytes.
+ * Shortly: timers take `(TN_TICK_LISTS_CNT * #TN_TICK_LISTS_LEVELS)` elements
+ * of `struct TN_ListItem`, on 32-bit system each element takes 8 bytes.
  *
  * The larger value, the more memory is needed, and the faster
  * $(TN_SYS_TIMER_LINK) ISR works. If your application has a lot of timers
@@ -213,6 +242,26 @@
 #  define TN_TICK_LISTS_CNT    8
 #endif
 
+/**
+ *
+ * <i>Takes effect if only `#TN_DYNAMIC_TICK` is <B>not set</B></i>.
+ *
+ * Number of levels of "tick" lists of timers, minimum value: `2`. Each level
+ * has `#TN_TICK_LISTS_CNT` lists, and level `N` covers timeouts up to
+ * `TN_TICK_LISTS_CNT ^ (N + 1)` ticks.
+ *
+ * Refer to the \ref timers_static_implementation for details.
+ *
+ * Timers with timeouts beyond the range of the whole wheel (i.e. larger than
+ * `TN_TICK_LISTS_CNT ^ TN_TICK_LISTS_LEVELS` ticks) work as well, they are
+ * just handled once more per each such period. So, if your application has
+ * a lot of timers with long timeouts, consider incrementing this value.
+ * `TN_TICK_LISTS_CNT ^ TN_TICK_LISTS_LEVELS` must not exceed `2 ^ 32`.
+ */
+#ifndef TN_TICK_LISTS_LEVELS
+#  define TN_TICK_LISTS_LEVELS 4
+#endif
+
 
 /**
  * API option for `MAKE_ALIG()` macro.
@@ -334,6 +383,128 @@
 #  define TN_DYNAMIC_TICK        0
 #endif
 
+/**
+ *
+ * <i>Takes effect if only `#TN_DYNAMIC_TICK` is <B>set</B></i>.
+ *
+ * Whether active timers should be kept in the pairing heap instead of the
+ * sorted list, see \ref time_ticks__dynamic_tick_heap.
+ *
+ * With the sorted list, starting a timer (which includes any waiting with
+ * timeout) takes O(n) time, where n is the number of active timers; with the
+ * heap, it takes O(log n) amortized time, at the cost of one more pointer in
+ * each `struct #TN_Timer` (and, therefore, in each `struct #TN_Task`). If
+ * your application has a lot of active timers and/or tasks waiting with
+ * timeout, consider setting this option to 1.
+ */
+#ifndef TN_DYNAMIC_TICK_HEAP
+#  define TN_DYNAMIC_TICK_HEAP   0
+#endif
+
+/**
+ * Whether callbacks of the timers created by `tn_timer_create()` should be
+ * called from the dedicated timer task instead of $(TN_SYS_TIMER_LINK) ISR,
+ * see \ref timers_task.
+ *
+ * If this option is set, the stack and the priority of the timer task should
+ * be provided to `tn_timer_task_set()` before calling `tn_sys_start()`.
+ */
+#ifndef TN_TIMER_TASK
+#  define TN_TIMER_TASK          0
+#endif
+
+/**
+ * Maximum size of the \ref tn_tlsf.h "TLSF heap" is
+ * `(2 ^ TN_TLSF_FL_INDEX_MAX)` bytes (minus a couple of words of overhead).
+ *
+ * Each TLSF heap has 8 free lists per each power of two of size, so, the
+ * larger value, the more memory `struct #TN_Tlsf` takes: on 32-bit system,
+ * it is about `(TN_TLSF_FL_INDEX_MAX - 4) * 36` bytes. Should be less than
+ * `#TN_INT_WIDTH`.
+ *
+ * Default: `16` (i.e. 64 KB), but not more than `(#TN_INT_WIDTH - 1)`: so, it
+ * is `15` on 16-bit architectures such as PIC24/dsPIC.
+ */
+#ifndef TN_TLSF_FL_INDEX_MAX
+#  define TN_TLSF_FL_INDEX_MAX                                         \
+      ((TN_INT_WIDTH < 17) ? (TN_INT_WIDTH - 1) : 16)
+#endif
+
+/**
+ * Number of wait queues in each \ref tn_eventgrp.h "event group", should be
+ * from `1` to `#TN_INT_WIDTH`. Refer to the section \ref eventgrp_wait_lists
+ * for details.
+ *
+ * Waiting tasks are distributed among the queues by the least significant
+ * bit of their wait pattern, and for each queue, the event group maintains
+ * the union of the wait patterns of its tasks; when flags are set, only the
+ * queues whose tasks wait for these flags are examined. So, if a lot of tasks
+ * wait for different flags of the same event group, consider setting this
+ * option to the number of these flags: then, setting a flag examines just the
+ * tasks that wait for it.
+ *
+ * Each queue takes three words of RAM in every event group.
+ */
+#ifndef TN_EVENTGRP_WAIT_LISTS_CNT
+#  define TN_EVENTGRP_WAIT_LISTS_CNT   1
+#endif
+
+/**
+ * Whether `tn_wait_any()` is available: a task may wait for any of several
+ * semaphores, queues and event groups, see \ref tn_wait_any.h.
+ *
+ * If enabled, each semaphore, data queue and event group takes two more
+ * words of RAM, and services which make these objects ready (say,
+ * `tn_sem_signal()`) check whether some task waits for them in
+ * `tn_wait_any()`; it takes O(1) time if nobody does.
+ */
+#ifndef TN_USE_WAIT_ANY
+#  define TN_USE_WAIT_ANY        1
+#endif
+
+/**
+ * Whether task notifications are available: each task has a notification
+ * value which other tasks and ISRs may update with `tn_task_notify()` /
+ * `tn_task_inotify()`, and the task may wait for it with
+ * `tn_task_notify_wait()`. See \ref tn_tasks__notify.
+ *
+ * If enabled, each task takes two more words of RAM.
+ */
+#ifndef TN_USE_TASK_NOTIFY
+#  define TN_USE_TASK_NOTIFY     1
+#endif
+
+/**
+ * Whether priority-ordered wait queues are available: semaphores, data
+ * queues, fixed memory pools and event groups created with the appropriate
+ * attribute (say, `#TN_SEM_ATTR_PRIO`) serve waiting tasks in the order of
+ * their priority instead of FIFO. Tasks of the same priority are still
+ * served in FIFO order.
+ *
+ * Wait queues of \ref tn_tlsf.h "TLSF heap" (one per first-level size
+ * range) always use priority order if this option is enabled.
+ *
+ * Mutexes and reader-writer locks aren't affected by this option: they
+ * always serve waiting tasks in FIFO order, and keep the bitmap of
+ * priorities of waiting tasks on their own (see \ref tn_mutex.h and
+ * \ref tn_rwlock.h).
+ *
+ * Each such queue has a priority index: a bitmap of priorities of waiting
+ * tasks (like the one of runnable tasks) plus the first waiting task of each
+ * priority. So, both putting a task into the queue and removing it take
+ * O(1) time, no matter how many tasks wait and what their priorities are.
+ *
+ * The index costs RAM, though: if enabled, each task takes one more word,
+ * and each of the objects mentioned above (regardless of its attributes)
+ * takes one more word plus an index per wait queue: `#TN_PRIORITIES_CNT`
+ * words and a bitmap (one word per `#TN_INT_WIDTH` priorities, plus a
+ * summary word if there's more than one). That's why the option is disabled
+ * by default.
+ */
+#ifndef TN_USE_PRIO_WAIT_QUEUES
+#  define TN_USE_PRIO_WAIT_QUEUES   0
+#endif
+
 
 /**
  * Whether the old TNKernel events API compatibility mode is active.